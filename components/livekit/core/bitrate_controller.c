@@ -0,0 +1,262 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+
+#include "bitrate_controller.h"
+
+/// Interval between target updates.
+#define UPDATE_INTERVAL_MS 200
+
+/// Standing send delay above which the link is considered congested.
+///
+/// Each stream's minimum delay over an update interval is used rather than the
+/// maximum, so a burst such as a keyframe that drains within the interval is not
+/// mistaken for congestion; only a send buffer that never empties is.
+///
+#define OVERUSE_DELAY_MS 30
+
+/// Standing send delay below which the target may grow.
+#define UNDERUSE_DELAY_MS 10
+
+/// Minimum time between two decreases, so one congestion event is not counted twice.
+#define DECREASE_HOLD_MS 500
+
+/// Time after a decrease before the target may grow again.
+#define INCREASE_HOLD_MS 1000
+
+/// Fraction of the achieved rate kept on congestion, in percent.
+#define DECREASE_PERCENT 85
+
+/// Multiplicative growth per update (about 8% per second), in 1/1000.
+#define INCREASE_PERMILLE 16
+
+/// Additive growth per update near the last congestion point.
+#define ADDITIVE_INCREASE_BPS 10000
+
+/// The target may not exceed the achieved rate by more than this, in percent.
+/// Keeps the target from growing unbounded while the encoder produces less.
+#define APP_LIMIT_PERCENT 150
+
+typedef struct {
+    bitrate_controller_config_t config;
+    uint32_t min_bps;
+    uint32_t max_bps;
+
+    uint32_t target_bps;
+    uint32_t achieved_bps;
+    /// Target after the last decrease; growth is additive close to it.
+    uint32_t last_decrease_bps;
+    uint32_t last_decrease_ms;
+    bool has_decreased;
+
+    bool started;
+    uint32_t window_start_ms;
+    uint64_t window_bytes;
+    /// Shortest send delay of each stream, or UINT32_MAX if it sent nothing.
+    uint32_t window_min_delay_ms[BITRATE_STREAM_COUNT];
+    uint32_t window_drops;
+
+    livekit_bitrate_stats_t stats;
+} bitrate_controller_t;
+
+static inline int32_t time_diff(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+static void reset_window(bitrate_controller_t *bc)
+{
+    bc->window_bytes = 0;
+    for (int i = 0; i < BITRATE_STREAM_COUNT; i++) {
+        bc->window_min_delay_ms[i] = UINT32_MAX;
+    }
+    bc->window_drops = 0;
+}
+
+/// Returns the standing send delay: the longest of each stream's shortest delay.
+static uint32_t window_delay(const bitrate_controller_t *bc)
+{
+    uint32_t delay_ms = 0;
+    for (int i = 0; i < BITRATE_STREAM_COUNT; i++) {
+        // A stream that sent nothing shows no evidence of a standing queue.
+        if (bc->window_min_delay_ms[i] != UINT32_MAX && bc->window_min_delay_ms[i] > delay_ms) {
+            delay_ms = bc->window_min_delay_ms[i];
+        }
+    }
+    return delay_ms;
+}
+
+static inline uint32_t clamp_u32(uint32_t value, uint32_t min, uint32_t max)
+{
+    if (value < min) return min;
+    if (value > max) return max;
+    return value;
+}
+
+/// Splits a total target between audio and video, serving audio first.
+static void split_target(const bitrate_controller_t *bc, uint32_t total, uint32_t *audio_bps, uint32_t *video_bps)
+{
+    const bitrate_controller_config_t *config = &bc->config;
+    uint32_t audio = total > config->video_min_bps ? total - config->video_min_bps : 0;
+    audio = clamp_u32(audio, config->audio_min_bps, config->audio_max_bps);
+    uint32_t video = total > audio ? total - audio : 0;
+    *audio_bps = audio;
+    *video_bps = clamp_u32(video, config->video_min_bps, config->video_max_bps);
+}
+
+bitrate_controller_handle_t bitrate_controller_create(const bitrate_controller_config_t *config)
+{
+    if (config == NULL ||
+        config->audio_min_bps > config->audio_max_bps ||
+        config->video_min_bps > config->video_max_bps ||
+        config->audio_max_bps + config->video_max_bps == 0) {
+        return NULL;
+    }
+    bitrate_controller_t *bc = calloc(1, sizeof(bitrate_controller_t));
+    if (bc == NULL) {
+        return NULL;
+    }
+    bc->config = *config;
+    bc->min_bps = config->audio_min_bps + config->video_min_bps;
+    bc->max_bps = config->audio_max_bps + config->video_max_bps;
+    bitrate_controller_reset(bc);
+    return bc;
+}
+
+void bitrate_controller_destroy(bitrate_controller_handle_t handle)
+{
+    free(handle);
+}
+
+void bitrate_controller_on_sent(
+    bitrate_controller_handle_t handle,
+    bitrate_stream_t stream,
+    size_t bytes,
+    uint32_t send_delay_ms,
+    bool dropped,
+    uint32_t now_ms)
+{
+    if (handle == NULL || stream >= BITRATE_STREAM_COUNT) {
+        return;
+    }
+    bitrate_controller_t *bc = (bitrate_controller_t *)handle;
+    if (!bc->started) {
+        bc->started = true;
+        bc->window_start_ms = now_ms;
+    }
+    if (dropped) {
+        bc->window_drops++;
+        bc->stats.send_failures++;
+        return;
+    }
+    bc->window_bytes += bytes;
+    if (send_delay_ms < bc->window_min_delay_ms[stream]) {
+        bc->window_min_delay_ms[stream] = send_delay_ms;
+    }
+}
+
+bool bitrate_controller_update(bitrate_controller_handle_t handle, uint32_t now_ms)
+{
+    if (handle == NULL) {
+        return false;
+    }
+    bitrate_controller_t *bc = (bitrate_controller_t *)handle;
+    int32_t elapsed_ms = time_diff(now_ms, bc->window_start_ms);
+    if (!bc->started || elapsed_ms < UPDATE_INTERVAL_MS) {
+        return false;
+    }
+    uint32_t window_bps = (uint32_t)(bc->window_bytes * 8 * 1000 / (uint32_t)elapsed_ms);
+    bc->achieved_bps = bc->achieved_bps == 0 ?
+        window_bps : (3 * bc->achieved_bps + window_bps) / 4;
+    uint32_t delay_ms = window_delay(bc);
+    bool is_congested = bc->window_drops > 0 || delay_ms > OVERUSE_DELAY_MS;
+
+    uint32_t previous_bps = bc->target_bps;
+    uint32_t target = bc->target_bps;
+    if (is_congested) {
+        if (!bc->has_decreased || time_diff(now_ms, bc->last_decrease_ms) >= DECREASE_HOLD_MS) {
+            // Cut relative to what actually got through, not to the old target.
+            uint32_t base = bc->achieved_bps < target ? bc->achieved_bps : target;
+            target = (uint32_t)((uint64_t)base * DECREASE_PERCENT / 100);
+            bc->last_decrease_bps = target;
+            bc->last_decrease_ms = now_ms;
+            bc->has_decreased = true;
+            bc->stats.decreases++;
+        }
+    } else if (delay_ms < UNDERUSE_DELAY_MS &&
+        (!bc->has_decreased || time_diff(now_ms, bc->last_decrease_ms) >= INCREASE_HOLD_MS)) {
+        bool is_near_limit = bc->has_decreased &&
+            (uint64_t)target * 10 < (uint64_t)bc->last_decrease_bps * 12 &&
+            (uint64_t)target * 10 > (uint64_t)bc->last_decrease_bps * 8;
+        uint32_t increase = is_near_limit ?
+            ADDITIVE_INCREASE_BPS : (uint32_t)((uint64_t)target * INCREASE_PERMILLE / 1000);
+        uint32_t app_limit = (uint32_t)((uint64_t)bc->achieved_bps * APP_LIMIT_PERCENT / 100);
+        if (target + increase <= app_limit) {
+            target += increase;
+        } else if (target < app_limit) {
+            target = app_limit;
+        }
+    }
+    bc->target_bps = clamp_u32(target, bc->min_bps, bc->max_bps);
+
+    bc->stats.queue_delay_ms = delay_ms;
+    bc->window_start_ms = now_ms;
+    reset_window(bc);
+
+    if (bc->target_bps == previous_bps) {
+        return false;
+    }
+    uint32_t old_audio, old_video, new_audio, new_video;
+    split_target(bc, previous_bps, &old_audio, &old_video);
+    split_target(bc, bc->target_bps, &new_audio, &new_video);
+    return old_audio != new_audio || old_video != new_video;
+}
+
+void bitrate_controller_get_targets(bitrate_controller_handle_t handle, uint32_t *audio_bps, uint32_t *video_bps)
+{
+    if (handle == NULL || audio_bps == NULL || video_bps == NULL) {
+        return;
+    }
+    bitrate_controller_t *bc = (bitrate_controller_t *)handle;
+    split_target(bc, bc->target_bps, audio_bps, video_bps);
+}
+
+void bitrate_controller_reset(bitrate_controller_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    bitrate_controller_t *bc = (bitrate_controller_t *)handle;
+    bc->target_bps = clamp_u32(bc->config.start_bps, bc->min_bps, bc->max_bps);
+    bc->achieved_bps = 0;
+    bc->has_decreased = false;
+    bc->last_decrease_bps = 0;
+    bc->started = false;
+    reset_window(bc);
+}
+
+void bitrate_controller_get_stats(bitrate_controller_handle_t handle, livekit_bitrate_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return;
+    }
+    bitrate_controller_t *bc = (bitrate_controller_t *)handle;
+    *stats = bc->stats;
+    stats->target_bps = bc->target_bps;
+    stats->achieved_bps = bc->achieved_bps;
+    split_target(bc, bc->target_bps, &stats->audio_target_bps, &stats->video_target_bps);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "livekit_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Send-side congestion controller for published media.
+///
+/// Each sent frame is reported with its stream, its size, how long the send call
+/// was blocked because the socket's send buffer was full (send delay), and whether
+/// it was dropped. Send delay is tracked per stream: small audio frames often fit
+/// into a buffer that a video frame has to wait for, so a shared minimum would hide
+/// a standing queue. Once per update interval the controller compares the longest
+/// per-stream send delay and drops against thresholds: on congestion the target is cut to a fraction of the rate
+/// actually achieved; otherwise it grows multiplicatively, switching to additive
+/// increase near the rate at which congestion was last seen.
+///
+/// The target is split between audio and video with audio served first, so audio
+/// quality is only reduced once video is at its minimum.
+///
+/// The controller is not thread-safe and takes the current time as a parameter so
+/// that it can be driven by a simulated link.
+///
+typedef void *bitrate_controller_handle_t;
+
+/// Published stream a sent frame belongs to.
+typedef enum {
+    BITRATE_STREAM_AUDIO,
+    BITRATE_STREAM_VIDEO,
+    BITRATE_STREAM_COUNT
+} bitrate_stream_t;
+
+typedef struct {
+    uint32_t audio_min_bps;
+    uint32_t audio_max_bps;
+    uint32_t video_min_bps;
+    uint32_t video_max_bps;
+    /// Initial total target; clamped to the sum of the minimums and maximums.
+    uint32_t start_bps;
+} bitrate_controller_config_t;
+
+/// Creates a controller.
+bitrate_controller_handle_t bitrate_controller_create(const bitrate_controller_config_t *config);
+
+/// Destroys a controller.
+void bitrate_controller_destroy(bitrate_controller_handle_t handle);
+
+/// Reports a frame handed to the network.
+///
+/// @param send_delay_ms Time the send call was blocked.
+/// @param dropped Whether the frame could not be sent.
+///
+void bitrate_controller_on_sent(
+    bitrate_controller_handle_t handle,
+    bitrate_stream_t stream,
+    size_t bytes,
+    uint32_t send_delay_ms,
+    bool dropped,
+    uint32_t now_ms
+);
+
+/// Recomputes the target once per update interval.
+///
+/// @returns True if the audio or video target changed and should be applied.
+///
+bool bitrate_controller_update(bitrate_controller_handle_t handle, uint32_t now_ms);
+
+/// Returns the current audio and video targets in bits per second.
+void bitrate_controller_get_targets(bitrate_controller_handle_t handle, uint32_t *audio_bps, uint32_t *video_bps);
+
+/// Restarts from the initial target, e.g. for a new connection; counters are kept.
+void bitrate_controller_reset(bitrate_controller_handle_t handle);
+
+/// Returns the controller's current targets and counters.
+void bitrate_controller_get_stats(bitrate_controller_handle_t handle, livekit_bitrate_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
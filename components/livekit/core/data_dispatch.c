@@ -0,0 +1,229 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "data_dispatch.h"
+
+static const char *TAG = "livekit_data_dispatch";
+
+/// Maximum time `data_dispatch_destroy` waits for the task to exit before
+/// forcibly deleting it.
+#define DISPATCH_TASK_JOIN_TIMEOUT_MS 2000
+
+/// Queue slot; the packet is moved in by value so its decoded fields are not copied.
+typedef struct {
+    livekit_pb_data_packet_t packet;
+    int64_t enqueued_us;
+    /// Wakes the task so it can observe shutdown.
+    bool stop;
+} dispatch_item_t;
+
+typedef struct {
+    data_dispatch_handler_t handler;
+    void *ctx;
+
+    QueueHandle_t queue;
+    TaskHandle_t task_handle;
+    SemaphoreHandle_t task_done_sem;
+    volatile bool is_running;
+
+    SemaphoreHandle_t stats_mutex;
+    livekit_data_dispatch_stats_t stats;
+    uint64_t total_latency_us;
+} dispatch_t;
+
+static void dispatch_task(void *arg)
+{
+    dispatch_t *dispatch = (dispatch_t *)arg;
+    dispatch_item_t item;
+
+    while (dispatch->is_running) {
+        if (xQueueReceive(dispatch->queue, &item, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (item.stop) {
+            break;
+        }
+        int64_t start_us = esp_timer_get_time();
+        dispatch->handler(&item.packet, dispatch->ctx);
+        int64_t end_us = esp_timer_get_time();
+        protocol_data_packet_free(&item.packet);
+
+        uint32_t latency_us = (uint32_t)(start_us - item.enqueued_us);
+        uint32_t handler_us = (uint32_t)(end_us - start_us);
+
+        xSemaphoreTake(dispatch->stats_mutex, portMAX_DELAY);
+        livekit_data_dispatch_stats_t *stats = &dispatch->stats;
+        stats->dispatched++;
+        dispatch->total_latency_us += latency_us;
+        if (latency_us > stats->max_latency_us) {
+            stats->max_latency_us = latency_us;
+        }
+        if (handler_us > stats->max_handler_us) {
+            stats->max_handler_us = handler_us;
+        }
+        xSemaphoreGive(dispatch->stats_mutex);
+    }
+
+    xSemaphoreGive(dispatch->task_done_sem);
+    vTaskDelete(NULL);
+}
+
+/// Frees packets left in the queue after the task has exited.
+static void flush_queue(dispatch_t *dispatch)
+{
+    dispatch_item_t item;
+    while (xQueueReceive(dispatch->queue, &item, 0) == pdTRUE) {
+        if (!item.stop) {
+            protocol_data_packet_free(&item.packet);
+        }
+    }
+}
+
+data_dispatch_handle_t data_dispatch_create(data_dispatch_handler_t handler, void *ctx)
+{
+    if (handler == NULL) {
+        return NULL;
+    }
+    dispatch_t *dispatch = calloc(1, sizeof(dispatch_t));
+    if (dispatch == NULL) {
+        return NULL;
+    }
+    dispatch->handler = handler;
+    dispatch->ctx = ctx;
+    dispatch->is_running = true;
+
+    dispatch->queue = xQueueCreate(CONFIG_LK_DATA_DISPATCH_QUEUE_SIZE, sizeof(dispatch_item_t));
+    dispatch->task_done_sem = xSemaphoreCreateBinary();
+    dispatch->stats_mutex = xSemaphoreCreateMutex();
+    if (dispatch->queue == NULL ||
+        dispatch->task_done_sem == NULL ||
+        dispatch->stats_mutex == NULL) {
+        goto _create_failed;
+    }
+    if (xTaskCreate(
+        dispatch_task,
+        "lk_eng_data",
+        CONFIG_LK_DATA_DISPATCH_TASK_STACK_SIZE,
+        (void *)dispatch,
+        CONFIG_LK_DATA_DISPATCH_TASK_PRIORITY,
+        &dispatch->task_handle
+    ) != pdPASS) {
+        goto _create_failed;
+    }
+    return dispatch;
+
+_create_failed:
+    data_dispatch_destroy(dispatch);
+    return NULL;
+}
+
+void data_dispatch_destroy(data_dispatch_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    dispatch_t *dispatch = (dispatch_t *)handle;
+    dispatch->is_running = false;
+
+    if (dispatch->task_handle != NULL) {
+        // If the queue stays full the stop item cannot be sent, but the task
+        // still observes `is_running == false` after handling the next packet.
+        dispatch_item_t stop = { .stop = true };
+        xQueueSendToFront(dispatch->queue, &stop, pdMS_TO_TICKS(DISPATCH_TASK_JOIN_TIMEOUT_MS));
+        if (xSemaphoreTake(dispatch->task_done_sem, pdMS_TO_TICKS(DISPATCH_TASK_JOIN_TIMEOUT_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "Dispatch task did not exit in time; forcing deletion");
+            vTaskDelete(dispatch->task_handle);
+        }
+        dispatch->task_handle = NULL;
+#if CONFIG_LK_BENCHMARK
+        livekit_data_dispatch_stats_t stats;
+        data_dispatch_get_stats(dispatch, &stats);
+        if (stats.dispatched > 0 || stats.dropped > 0) {
+            ESP_LOGI(TAG, "[BENCH] Dispatched %" PRIu32 " packets: dropped=%" PRIu32 ", queue_high_water=%" PRIu32 ", avg_latency=%" PRIu32 "us, max_latency=%" PRIu32 "us, max_handler=%" PRIu32 "us",
+                stats.dispatched,
+                stats.dropped,
+                stats.queue_high_water,
+                stats.avg_latency_us,
+                stats.max_latency_us,
+                stats.max_handler_us);
+        }
+#endif
+    }
+    if (dispatch->queue != NULL) {
+        flush_queue(dispatch);
+        vQueueDelete(dispatch->queue);
+    }
+    if (dispatch->task_done_sem != NULL) {
+        vSemaphoreDelete(dispatch->task_done_sem);
+    }
+    if (dispatch->stats_mutex != NULL) {
+        vSemaphoreDelete(dispatch->stats_mutex);
+    }
+    free(dispatch);
+}
+
+bool data_dispatch_enqueue(data_dispatch_handle_t handle, livekit_pb_data_packet_t *packet)
+{
+    if (handle == NULL || packet == NULL) {
+        return false;
+    }
+    dispatch_t *dispatch = (dispatch_t *)handle;
+    if (!dispatch->is_running) {
+        return false;
+    }
+    dispatch_item_t item = {
+        .packet = *packet,
+        .enqueued_us = esp_timer_get_time(),
+    };
+    bool queued = xQueueSend(dispatch->queue, &item, 0) == pdPASS;
+    uint32_t depth = (uint32_t)uxQueueMessagesWaiting(dispatch->queue);
+
+    xSemaphoreTake(dispatch->stats_mutex, portMAX_DELAY);
+    if (!queued) {
+        dispatch->stats.dropped++;
+    }
+    if (depth > dispatch->stats.queue_high_water) {
+        dispatch->stats.queue_high_water = depth;
+    }
+    xSemaphoreGive(dispatch->stats_mutex);
+
+    if (!queued) {
+        ESP_LOGW(TAG, "Dispatch queue full, dropping packet");
+    }
+    return queued;
+}
+
+void data_dispatch_get_stats(data_dispatch_handle_t handle, livekit_data_dispatch_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return;
+    }
+    dispatch_t *dispatch = (dispatch_t *)handle;
+    xSemaphoreTake(dispatch->stats_mutex, portMAX_DELAY);
+    *stats = dispatch->stats;
+    stats->avg_latency_us = stats->dispatched > 0 ?
+        (uint32_t)(dispatch->total_latency_us / stats->dispatched) : 0;
+    xSemaphoreGive(dispatch->stats_mutex);
+}
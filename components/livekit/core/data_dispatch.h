@@ -0,0 +1,59 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "protocol.h"
+#include "livekit_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Hands incoming data packets off from the peer receive thread to a dedicated task.
+///
+/// Packets are moved into a bounded queue (`CONFIG_LK_DATA_DISPATCH_QUEUE_SIZE`) without
+/// copying their decoded fields, and the handler is invoked from the dispatch task so
+/// that a slow consumer never stalls SCTP receive. When the queue is full, new packets
+/// are dropped and counted.
+///
+typedef void *data_dispatch_handle_t;
+
+/// Handles a single packet on the dispatch task.
+///
+/// The packet is freed after the handler returns.
+///
+typedef void (*data_dispatch_handler_t)(livekit_pb_data_packet_t *packet, void *ctx);
+
+/// Creates a dispatcher and starts its task.
+data_dispatch_handle_t data_dispatch_create(data_dispatch_handler_t handler, void *ctx);
+
+/// Stops the dispatch task and frees any packets still queued.
+void data_dispatch_destroy(data_dispatch_handle_t handle);
+
+/// Queues a decoded packet for dispatch without blocking.
+///
+/// @returns True if ownership of the packet's decoded fields was taken; otherwise,
+///     the caller remains responsible for freeing the packet.
+///
+bool data_dispatch_enqueue(data_dispatch_handle_t handle, livekit_pb_data_packet_t *packet);
+
+/// Returns the dispatcher's counters.
+void data_dispatch_get_stats(data_dispatch_handle_t handle, livekit_data_dispatch_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
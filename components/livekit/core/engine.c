@@ -20,12 +20,22 @@
 #include "freertos/event_groups.h"
 #include "media_lib_os.h"
 #include "esp_capture_sink.h"
+#include "esp_timer.h"
 #include <inttypes.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include "esp_log.h"
 #include "url.h"
 #include "signaling.h"
 #include "peer.h"
+#include "protocol_encoder.h"
+#include "reliable_buffer.h"
+#include "data_dispatch.h"
+#include "jitter_buffer.h"
+#include "video_renderer.h"
+#include "bitrate_controller.h"
+#include "voice_activity.h"
+#include "sub_policy.h"
 #include "utils.h"
 
 #include "engine.h"
@@ -33,10 +43,29 @@
 // MARK: - Constants
 static const char* TAG = "livekit_engine";
 
+/// Delay before retrying to send buffered reliable packets the publisher could not take.
+#define RELIABLE_FLUSH_RETRY_MS 200
+
+/// Number of signal responses preallocated for events; more are heap-allocated.
+#define SIGNAL_RES_POOL_SIZE 4
+
 /// Maximum time `engine_destroy` waits for the engine task to exit before
 /// forcibly deleting it.
 #define ENGINE_TASK_JOIN_TIMEOUT_MS 5000
 
+/// Longest the playout task sleeps between checks for due audio frames.
+#define PLAYOUT_MAX_WAIT_MS 20
+
+/// Shortest time between keyframe requests for subscribed video, each of which
+/// briefly pauses forwarding (see `request_video_keyframe`).
+#define KEYFRAME_REQUEST_MIN_INTERVAL_MS 3000
+
+#if CONFIG_LK_PUB_MODE_EVENT
+#define PUB_MODE_NAME "event"
+#else
+#define PUB_MODE_NAME "poll"
+#endif
+
 // MARK: - Type definitions
 
 /// Engine state machine state.
@@ -44,6 +73,7 @@ typedef enum {
     ENGINE_STATE_DISCONNECTED,
     ENGINE_STATE_CONNECTING,
     ENGINE_STATE_CONNECTED,
+    ENGINE_STATE_RESUMING,
     ENGINE_STATE_BACKOFF
 } engine_state_t;
 
@@ -51,12 +81,18 @@ typedef enum {
 typedef enum {
     EV_CMD_CONNECT,         /// User-initiated connect.
     EV_CMD_CLOSE,           /// User-initiated disconnect.
+    EV_CMD_UPDATE_SUBS,     /// Subscription policy changed.
+    EV_CMD_SET_STANDBY,     /// User-initiated switch between standby and publishing.
     EV_SIG_STATE,           /// Signal state changed.
     EV_SIG_RES,             /// Signal response received.
     EV_PEER_STATE,          /// Peer state changed.
     EV_PEER_SDP,            /// Peer provided SDP.
     EV_TIMER_EXP,           /// Timer expired.
     EV_MAX_RETRIES_REACHED, /// Maximum number of retry attempts reached.
+    EV_STANDBY_IDLE,        /// Standby idle timeout expired.
+    EV_FLUSH_RETRY,         /// Retry sending buffered reliable packets.
+    EV_REQUEST_KEYFRAME,    /// Subscribed video needs a keyframe to resume decoding.
+    EV_VIDEO_LAYER_CHANGED, /// Published video switched to a layer of another resolution.
     _EV_STATE_ENTER,        /// State enter hook (internal).
     _EV_STATE_EXIT,         /// State exit hook (internal).
     _EV_STOP,               /// Wakes the engine task so it can observe shutdown (internal).
@@ -71,10 +107,18 @@ typedef struct {
         struct {
             char *server_url;
             char *token;
+            bool standby;
         } cmd_connect;
 
+        /// Detail for `EV_CMD_SET_STANDBY`.
+        bool standby;
+
         /// Detail for `EV_SIG_RES`.
-        livekit_pb_signal_response_t res;
+        ///
+        /// Heap-allocated rather than embedded so the queue slot size does not
+        /// scale with the size of the largest signal response.
+        ///
+        livekit_pb_signal_response_t *res;
 
         /// Detail for `EV_SIG_STATE`.
         signal_state_t sig_state;
@@ -93,12 +137,45 @@ typedef struct {
     } detail;
 } engine_event_t;
 
+/// A track published by a remote participant.
+typedef struct {
+    livekit_pb_sid_t sid;
+    livekit_pb_sid_t participant_sid;
+    /// Owned copy of the publishing participant's identity.
+    char *participant_identity;
+    livekit_pb_participant_info_kind_t participant_kind;
+    livekit_pb_track_type_t type;
+    bool is_subscribed;
+} remote_track_t;
+
 typedef struct {
     bool is_subscriber_primary;
     livekit_pb_sid_t local_participant_sid;
-    livekit_pb_sid_t sub_audio_track_sid;
+    /// SID of the published video track, once the server reports it.
+    livekit_pb_sid_t local_video_sid;
+    /// Tracks published by remote participants; unused entries have an empty `sid`.
+    remote_track_t remote_tracks[CONFIG_LK_MAX_REMOTE_TRACKS];
 } session_state_t;
 
+/// Remote ICE candidates for a peer that cannot apply them yet.
+typedef struct {
+    /// Owned copies, in the order received.
+    char *candidates[CONFIG_LK_MAX_PENDING_ICE_CANDIDATES];
+    uint8_t count;
+    /// Whether the peer has applied a remote description, after which
+    /// candidates are delivered as they arrive.
+    bool has_remote_sdp;
+} pending_candidates_t;
+
+#if CONFIG_LK_BENCHMARK
+/// Capture-to-send latency counters for a published stream.
+typedef struct {
+    uint32_t frames;
+    uint64_t total_ms;
+    uint32_t max_ms;
+} pub_latency_stats_t;
+#endif
+
 typedef struct {
     engine_state_t state;
     engine_options_t options;
@@ -106,22 +183,135 @@ typedef struct {
     signal_handle_t signal_handle;
     peer_handle_t pub_peer_handle;
     peer_handle_t sub_peer_handle;
+    /// Remote candidates received before the publisher and subscriber can use them.
+    pending_candidates_t pub_candidates;
+    pending_candidates_t sub_candidates;
 
     av_render_handle_t renderer_handle;
+    /// Capture sink path carrying audio, and video when publishing a single layer.
     esp_capture_sink_handle_t capturer_path;
+    /// Capture sink path for each published video layer, highest resolution first.
+    esp_capture_sink_handle_t video_paths[CONFIG_LK_PUB_VIDEO_LAYERS];
+    uint8_t video_layer_count;
+    /// Whether the single video layer shares path 0 with audio and cannot be disabled.
+    bool is_video_path_shared;
+    /// Index into `video_paths` of the layer currently sent, or -1 if paused. Only
+    /// changed by the publish task.
+    volatile int8_t active_video_layer;
+    /// Highest resolution layer the server reports subscribers for, or -1 if
+    /// published video has no subscriber and is paused. Only changed by the
+    /// engine task.
+    volatile int8_t requested_video_layer;
+    /// Highest resolution layer the congestion controller's video target affords.
+    /// Only changed by the publish task.
+    uint8_t affordable_video_layer;
+    /// Layer whose resolution the server was last told about. Only changed by the
+    /// engine task.
+    int8_t advertised_video_layer;
     bool is_media_streaming;
+    /// Whether to stay connected without publishing until activated.
+    bool is_standby;
+    /// Closes the connection after staying in standby for too long.
+    TimerHandle_t idle_timer;
+    uint8_t stream_task_count;
+    SemaphoreHandle_t stream_done_sem;
+#if CONFIG_LK_BENCHMARK
+    /// When the join response was received, for reporting the connection critical path.
+    int64_t join_ms;
+    uint32_t peer_setup_ms;
+    /// When publishing was activated from standby, or 0.
+    int64_t activate_ms;
+    int64_t stream_start_ms;
+    pub_latency_stats_t audio_latency;
+    pub_latency_stats_t video_latency;
+#endif
+#if CONFIG_LK_BITRATE_CONTROL
+    /// Adapts encoder bitrates to congestion; shared by both publish tasks.
+    bitrate_controller_handle_t bitrate_controller;
+    SemaphoreHandle_t bitrate_mutex;
+    /// Set when a new target should be applied to the encoder by its publish task.
+    volatile bool is_audio_bitrate_stale;
+    volatile bool is_video_bitrate_stale;
+#endif
+#if CONFIG_LK_AUDIO_DTX
+    /// Decides which published audio frames carry speech; only used by the audio publish task.
+    voice_activity_handle_t voice_activity;
+#endif
 
     char* server_url;
     char* token;
     session_state_t session;
 
+    /// Reliable packets sent while not connected, flushed on (re)connect.
+    reliable_buffer_handle_t reliable_buffer;
+    protocol_encoder_handle_t reliable_encoder;
+    /// Guards `data_state` and `is_data_ready`, which the send path reads from
+    /// application tasks.
+    SemaphoreHandle_t data_mutex;
+    /// Engine state as seen by the send path; updated on every transition.
+    engine_state_t data_state;
+    /// Whether reliable packets can be sent directly: connected with nothing
+    /// left buffered.
+    bool is_data_ready;
+    /// Retries sending buffered packets after a flush stopped early.
+    TimerHandle_t flush_timer;
+
+    /// Delivers incoming data packets off the peer receive thread.
+    data_dispatch_handle_t data_dispatch;
+
+    /// Decodes subscribed video; only created if the room subscribes to video.
+    video_renderer_handle_t video_renderer;
+    /// Time the last keyframe was requested, or 0 if none was. Only used by the
+    /// engine task.
+    int64_t keyframe_request_us;
+
+#if CONFIG_LK_JITTER_BUFFER
+    /// Reorders and paces subscribed audio frames before rendering.
+    jitter_buffer_handle_t jitter_buffer;
+    SemaphoreHandle_t jitter_mutex;
+    /// Given when a frame is received to wake the playout task.
+    SemaphoreHandle_t playout_wake_sem;
+    SemaphoreHandle_t playout_done_sem;
+    bool is_playout_running;
+#endif
+
     TaskHandle_t task_handle;
     SemaphoreHandle_t task_done_sem;
     QueueHandle_t event_queue;
+    /// Updated by every task that enqueues events.
+    atomic_uint event_queue_high_water;
+    /// Preallocated signal responses for `EV_SIG_RES`.
+    livekit_pb_signal_response_t *sig_res_pool;
+    /// Pointers to the unused entries of `sig_res_pool`.
+    QueueHandle_t sig_res_free;
     TimerHandle_t timer;
     bool is_running;
     uint16_t retry_count;
     livekit_failure_reason_t failure_reason;
+
+    /// Whether the publisher is being recovered with an ICE restart.
+    bool is_ice_restarting;
+    int64_t ice_restart_start_ms;
+    /// When the connection was lost and a full reconnect began, or 0.
+    int64_t full_reconnect_start_ms;
+    uint64_t ice_restart_total_ms;
+    uint64_t full_reconnect_total_ms;
+    livekit_reconnect_stats_t reconnect_stats;
+
+    /// Why the session is being resumed.
+    livekit_pb_reconnect_reason_t resume_reason;
+    /// When the connection was lost and a resume began.
+    int64_t resume_start_ms;
+    /// When the last resume completed, or 0.
+    int64_t resume_end_ms;
+    uint64_t resume_total_ms;
+    /// Whether the resumed signaling connection has been established.
+    bool is_resume_signal_connected;
+    /// Whether the server accepted the resume with `ReconnectResponse`.
+    bool is_signal_resumed;
+    /// Last offer received and answer sent by the subscriber, reported in `SyncState`.
+    char *sub_offer_sdp;
+    char *sub_answer_sdp;
 } engine_t;
 
 static bool event_enqueue(engine_t *eng, engine_event_t *ev, bool send_to_front);
@@ -153,26 +343,171 @@ static inline void convert_dec_aud_info(esp_peer_audio_stream_info_t *info, av_r
     dec_info->bits_per_sample = 16;
 }
 
-static engine_err_t subscribe_tracks(engine_t *eng, livekit_pb_track_info_t *tracks, int count)
+#if CONFIG_LK_JITTER_BUFFER
+/// Returns the RTP clock rate, and so the pts time base, of a received audio stream.
+static inline uint32_t get_audio_clock_rate(esp_peer_audio_stream_info_t *info)
 {
-    if (tracks == NULL || count <= 0) {
-        return ENGINE_ERR_INVALID_ARG;
+    switch (info->codec) {
+        case ESP_PEER_AUDIO_CODEC_G711A:
+        case ESP_PEER_AUDIO_CODEC_G711U: return 8000;
+        // Opus always uses a 48 kHz RTP clock regardless of the coded rate (RFC 7587).
+        case ESP_PEER_AUDIO_CODEC_OPUS:  return 48000;
+        default:                         return info->sample_rate;
+    }
+}
+#endif
+
+/// Returns the entry for the given track, or NULL if the track is unknown.
+///
+/// Passing an empty SID returns the first unused entry.
+///
+static remote_track_t *find_remote_track(engine_t *eng, const char *sid)
+{
+    for (int i = 0; i < CONFIG_LK_MAX_REMOTE_TRACKS; i++) {
+        remote_track_t *track = &eng->session.remote_tracks[i];
+        if (strncmp(track->sid, sid, sizeof(track->sid)) == 0) {
+            return track;
+        }
+    }
+    return NULL;
+}
+
+static void remote_track_clear(remote_track_t *track)
+{
+    SAFE_FREE(track->participant_identity);
+    memset(track, 0, sizeof(*track));
+}
+
+static void clear_remote_tracks(engine_t *eng)
+{
+    for (int i = 0; i < CONFIG_LK_MAX_REMOTE_TRACKS; i++) {
+        remote_track_clear(&eng->session.remote_tracks[i]);
+    }
+}
+
+/// Returns whether the participant still publishes the given track.
+static bool has_track(const livekit_pb_participant_info_t *participant, const char *track_sid)
+{
+    for (pb_size_t i = 0; i < participant->tracks_count; i++) {
+        const char *sid = participant->tracks[i].sid;
+        if (sid != NULL && strcmp(sid, track_sid) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Records the tracks a remote participant publishes, forgetting any it no longer does.
+///
+/// The server ends subscriptions to unpublished tracks itself, so no unsubscribe is sent.
+///
+static void update_remote_tracks(engine_t *eng, const livekit_pb_participant_info_t *participant)
+{
+    bool disconnected = participant->state == LIVEKIT_PB_PARTICIPANT_INFO_STATE_DISCONNECTED;
+    for (int i = 0; i < CONFIG_LK_MAX_REMOTE_TRACKS; i++) {
+        remote_track_t *track = &eng->session.remote_tracks[i];
+        if (track->sid[0] == '\0' ||
+            strncmp(track->participant_sid, participant->sid, sizeof(track->participant_sid)) != 0) {
+            continue;
+        }
+        if (disconnected || !has_track(participant, track->sid)) {
+            ESP_LOGD(TAG, "Remote track ended: sid=%s", track->sid);
+            remote_track_clear(track);
+        }
     }
-    if (eng->session.sub_audio_track_sid[0] != '\0') {
-        return ENGINE_ERR_MAX_SUB;
+    if (disconnected) {
+        return;
     }
-    for (int i = 0; i < count; i++) {
-        livekit_pb_track_info_t *track = &tracks[i];
-        if (track->type != LIVEKIT_PB_TRACK_TYPE_AUDIO) {
+    for (pb_size_t i = 0; i < participant->tracks_count; i++) {
+        const livekit_pb_track_info_t *info = &participant->tracks[i];
+        if (info->sid == NULL) {
             continue;
         }
-        // For now, subscribe to the first audio track.
-        ESP_LOGI(TAG, "Subscribing to audio track: sid=%s", track->sid);
+        remote_track_t *track = find_remote_track(eng, info->sid);
+        if (track == NULL) {
+            track = find_remote_track(eng, "");
+            if (track == NULL) {
+                ESP_LOGW(TAG, "Too many remote tracks, ignoring: sid=%s", info->sid);
+                continue;
+            }
+            strlcpy(track->sid, info->sid, sizeof(track->sid));
+            strlcpy(track->participant_sid, participant->sid, sizeof(track->participant_sid));
+            track->type = info->type;
+        }
+        const char *identity = participant->identity != NULL ? participant->identity : "";
+        if (track->participant_identity == NULL || strcmp(track->participant_identity, identity) != 0) {
+            SAFE_FREE(track->participant_identity);
+            track->participant_identity = strdup(identity);
+        }
+        track->participant_kind = participant->kind;
+    }
+}
+
+/// Returns whether the engine should be subscribed to the given track.
+static bool should_subscribe(engine_t *eng, const remote_track_t *track)
+{
+    switch (track->type) {
+        case LIVEKIT_PB_TRACK_TYPE_AUDIO:
+            if (!(eng->options.media.audio_dir & ESP_PEER_MEDIA_DIR_RECV_ONLY)) return false;
+            break;
+        case LIVEKIT_PB_TRACK_TYPE_VIDEO:
+            if (!(eng->options.media.video_dir & ESP_PEER_MEDIA_DIR_RECV_ONLY)) return false;
+            break;
+        default:
+            return false;
+    }
+    if (eng->options.should_subscribe == NULL) {
+        return true;
+    }
+    livekit_pb_participant_info_t participant = {
+        .identity = track->participant_identity,
+        .state = LIVEKIT_PB_PARTICIPANT_INFO_STATE_ACTIVE,
+        .kind = track->participant_kind,
+    };
+    strlcpy(participant.sid, track->participant_sid, sizeof(participant.sid));
+    livekit_pb_track_info_t info = {
+        .sid = (char *)track->sid,
+        .type = track->type,
+    };
+    return eng->options.should_subscribe(&participant, &info, eng->options.ctx);
+}
+
+/// Subscribes to or unsubscribes from remote tracks so subscriptions match the policy.
+///
+/// At most `SUB_POLICY_MAX_AUDIO_TRACKS` audio and `SUB_POLICY_MAX_VIDEO_TRACKS`
+/// video tracks are subscribed at once; unsubscribes are sent first so freed slots
+/// can be reused by newly wanted tracks.
+///
+static void update_subscriptions(engine_t *eng)
+{
+    bool wanted[CONFIG_LK_MAX_REMOTE_TRACKS];
+    sub_policy_counts_t counts = {};
+
+    for (int i = 0; i < CONFIG_LK_MAX_REMOTE_TRACKS; i++) {
+        remote_track_t *track = &eng->session.remote_tracks[i];
+        wanted[i] = track->sid[0] != '\0' && should_subscribe(eng, track);
+        if (track->is_subscribed && !wanted[i]) {
+            ESP_LOGI(TAG, "Unsubscribing from track: sid=%s", track->sid);
+            signal_send_update_subscription(eng->signal_handle, track->sid, false);
+            track->is_subscribed = false;
+        }
+        if (track->is_subscribed) {
+            sub_policy_reserve(&counts, track->type);
+        }
+    }
+    for (int i = 0; i < CONFIG_LK_MAX_REMOTE_TRACKS; i++) {
+        remote_track_t *track = &eng->session.remote_tracks[i];
+        if (!wanted[i] || track->is_subscribed) {
+            continue;
+        }
+        if (!sub_policy_reserve(&counts, track->type)) {
+            ESP_LOGW(TAG, "Not subscribing to track, limit reached: sid=%s", track->sid);
+            continue;
+        }
+        ESP_LOGI(TAG, "Subscribing to track: sid=%s", track->sid);
         signal_send_update_subscription(eng->signal_handle, track->sid, true);
-        strlcpy(eng->session.sub_audio_track_sid, track->sid, sizeof(eng->session.sub_audio_track_sid));
-        break;
+        track->is_subscribed = true;
     }
-    return ENGINE_ERR_NONE;
 }
 
 static void on_peer_sub_audio_info(esp_peer_audio_stream_info_t* info, void *ctx)
@@ -188,19 +523,182 @@ static void on_peer_sub_audio_info(esp_peer_audio_stream_info_t* info, void *ctx
         ESP_LOGE(TAG, "Failed to add audio stream to renderer");
         return;
     }
+#if CONFIG_LK_JITTER_BUFFER
+    xSemaphoreTake(eng->jitter_mutex, portMAX_DELAY);
+    jitter_buffer_set_clock_rate(eng->jitter_buffer, get_audio_clock_rate(info));
+    xSemaphoreGive(eng->jitter_mutex);
+#endif
 }
 
 static void on_peer_sub_audio_frame(esp_peer_audio_frame_t* frame, void *ctx)
 {
     engine_t *eng = (engine_t *)ctx;
+#if CONFIG_LK_JITTER_BUFFER
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    xSemaphoreTake(eng->jitter_mutex, portMAX_DELAY);
+    jitter_buffer_push(eng->jitter_buffer, frame->pts, frame->data, (size_t)frame->size, now_ms);
+    xSemaphoreGive(eng->jitter_mutex);
+    xSemaphoreGive(eng->playout_wake_sem);
+#else
     av_render_audio_data_t audio_data = {
         .pts = frame->pts,
         .data = frame->data,
         .size = (uint32_t)frame->size,
     };
     av_render_add_audio_data(eng->renderer_handle, &audio_data);
+#endif
+}
+
+static void on_peer_sub_video_info(esp_peer_video_stream_info_t* info, void *ctx)
+{
+    engine_t *eng = (engine_t *)ctx;
+    video_renderer_set_stream_info(eng->video_renderer, info);
+}
+
+static void on_peer_sub_video_frame(esp_peer_video_frame_t* frame, void *ctx)
+{
+    engine_t *eng = (engine_t *)ctx;
+    video_renderer_push(eng->video_renderer, frame);
+}
+
+static void on_video_keyframe_needed(void *ctx)
+{
+    engine_t *eng = (engine_t *)ctx;
+    engine_event_t ev = { .type = EV_REQUEST_KEYFRAME };
+    event_enqueue(eng, &ev, false);
+}
+
+/// Asks the publishers of subscribed video tracks for a keyframe.
+///
+/// This is a workaround: esp_peer does not expose RTCP, so the picture loss
+/// indication a subscriber would normally send cannot be. Instead the track
+/// settings are updated to disabled and back, which in current SFU versions
+/// pauses forwarding and, on resuming, has the SFU ask the publisher for a
+/// keyframe. That behavior is not part of the protocol, so a keyframe is not
+/// guaranteed; frames are already being dropped until one arrives, so nothing
+/// decodable is lost. Requests are limited to one per
+/// `KEYFRAME_REQUEST_MIN_INTERVAL_MS` to keep the pauses rare.
+///
+static void request_video_keyframe(engine_t *eng)
+{
+    int64_t now_us = esp_timer_get_time();
+    if (eng->keyframe_request_us != 0 &&
+        now_us - eng->keyframe_request_us < KEYFRAME_REQUEST_MIN_INTERVAL_MS * 1000) {
+        ESP_LOGD(TAG, "Keyframe requested too recently, skipping");
+        return;
+    }
+    eng->keyframe_request_us = now_us;
+    for (int i = 0; i < CONFIG_LK_MAX_REMOTE_TRACKS; i++) {
+        remote_track_t *track = &eng->session.remote_tracks[i];
+        if (!track->is_subscribed || track->type != LIVEKIT_PB_TRACK_TYPE_VIDEO) {
+            continue;
+        }
+        ESP_LOGD(TAG, "Requesting keyframe: sid=%s", track->sid);
+        signal_send_update_track_settings(eng->signal_handle, track->sid, true);
+        signal_send_update_track_settings(eng->signal_handle, track->sid, false);
+    }
 }
 
+#if CONFIG_LK_JITTER_BUFFER
+/// Releases audio frames from the jitter buffer to the renderer as they become due.
+static void audio_playout_task(void *arg)
+{
+    engine_t *eng = (engine_t *)arg;
+    while (eng->is_playout_running) {
+        jitter_buffer_frame_t frame;
+        uint32_t wait_ms;
+        while (true) {
+            uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+            xSemaphoreTake(eng->jitter_mutex, portMAX_DELAY);
+            bool is_due = jitter_buffer_pop(eng->jitter_buffer, now_ms, &frame);
+            wait_ms = jitter_buffer_time_to_next(eng->jitter_buffer, now_ms);
+            xSemaphoreGive(eng->jitter_mutex);
+            if (!is_due) {
+                break;
+            }
+            // Render outside the lock; the renderer may block when its FIFO is full.
+            // The jitter buffer has already converted pts to milliseconds.
+            av_render_audio_data_t audio_data = {
+                .pts = frame.pts,
+                .data = frame.data,
+                .size = (uint32_t)frame.size,
+            };
+            av_render_add_audio_data(eng->renderer_handle, &audio_data);
+            free(frame.data);
+        }
+        if (wait_ms > PLAYOUT_MAX_WAIT_MS) wait_ms = PLAYOUT_MAX_WAIT_MS;
+        TickType_t ticks = pdMS_TO_TICKS(wait_ms);
+        xSemaphoreTake(eng->playout_wake_sem, ticks > 0 ? ticks : 1);
+    }
+    xSemaphoreGive(eng->playout_done_sem);
+    media_lib_thread_destroy(NULL);
+}
+
+static engine_err_t audio_playout_begin(engine_t *eng)
+{
+    jitter_buffer_config_t config = {
+        .min_delay_ms = CONFIG_LK_JITTER_BUFFER_MIN_DELAY_MS,
+        .max_delay_ms = CONFIG_LK_JITTER_BUFFER_MAX_DELAY_MS,
+        .max_frames = CONFIG_LK_JITTER_BUFFER_MAX_FRAMES,
+    };
+    eng->jitter_buffer = jitter_buffer_create(&config);
+    eng->jitter_mutex = xSemaphoreCreateMutex();
+    eng->playout_wake_sem = xSemaphoreCreateBinary();
+    eng->playout_done_sem = xSemaphoreCreateBinary();
+    if (eng->jitter_buffer == NULL ||
+        eng->jitter_mutex == NULL ||
+        eng->playout_wake_sem == NULL ||
+        eng->playout_done_sem == NULL) {
+        return ENGINE_ERR_NO_MEM;
+    }
+    eng->is_playout_running = true;
+    media_lib_thread_handle_t handle = NULL;
+    if (media_lib_thread_create_from_scheduler(&handle, "lk_sub_audio", audio_playout_task, eng) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create audio playout thread");
+        eng->is_playout_running = false;
+        return ENGINE_ERR_MEDIA;
+    }
+    return ENGINE_ERR_NONE;
+}
+
+static void audio_playout_end(engine_t *eng)
+{
+    if (eng->is_playout_running) {
+        eng->is_playout_running = false;
+        xSemaphoreGive(eng->playout_wake_sem);
+        // The task uses the buffer and semaphores freed below, so never give up waiting.
+        while (xSemaphoreTake(eng->playout_done_sem, pdMS_TO_TICKS(ENGINE_TASK_JOIN_TIMEOUT_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "Still waiting for audio playout task to exit");
+        }
+    }
+    if (eng->playout_wake_sem != NULL) {
+        vSemaphoreDelete(eng->playout_wake_sem);
+        eng->playout_wake_sem = NULL;
+    }
+    if (eng->playout_done_sem != NULL) {
+        vSemaphoreDelete(eng->playout_done_sem);
+        eng->playout_done_sem = NULL;
+    }
+    if (eng->jitter_mutex != NULL) {
+        vSemaphoreDelete(eng->jitter_mutex);
+        eng->jitter_mutex = NULL;
+    }
+    jitter_buffer_destroy(eng->jitter_buffer);
+    eng->jitter_buffer = NULL;
+}
+
+/// Discards buffered audio so a new connection's stream starts from a clean state.
+static void audio_playout_reset(engine_t *eng)
+{
+    if (eng->jitter_mutex == NULL) {
+        return;
+    }
+    xSemaphoreTake(eng->jitter_mutex, portMAX_DELAY);
+    jitter_buffer_reset(eng->jitter_buffer);
+    xSemaphoreGive(eng->jitter_mutex);
+}
+#endif
+
 // MARK: - Published media
 
 /// Converts `esp_peer_audio_codec_t` to equivalent `esp_capture_format_id_t` value.
@@ -224,71 +722,454 @@ static inline esp_capture_format_id_t capture_video_codec_type(esp_peer_video_co
     }
 }
 
-/// Captures and sends a single audio frame over the peer connection.
-__attribute__((always_inline))
-static inline void _media_stream_send_audio(engine_t *eng)
+/// Returns the resolution of a published video layer; each layer halves the one above it.
+static inline void video_layer_size(engine_t *eng, uint8_t layer, uint16_t *width, uint16_t *height)
 {
-    esp_capture_stream_frame_t audio_frame = {
-        .stream_type = ESP_CAPTURE_STREAM_TYPE_AUDIO,
-    };
-    while (esp_capture_sink_acquire_frame(eng->capturer_path, &audio_frame, true) == ESP_CAPTURE_ERR_OK) {
-        esp_peer_audio_frame_t audio_send_frame = {
-            .pts = audio_frame.pts,
-            .data = audio_frame.data,
-            .size = audio_frame.size,
-        };
-        peer_send_audio(eng->pub_peer_handle, &audio_send_frame);
-        esp_capture_sink_release_frame(eng->capturer_path, &audio_frame);
+    // Hardware encoders require dimensions aligned to the 16-pixel macroblock.
+    *width = (uint16_t)((eng->options.media.video_info.width >> layer) & ~0xF);
+    *height = (uint16_t)((eng->options.media.video_info.height >> layer) & ~0xF);
+}
+
+#if CONFIG_LK_BENCHMARK
+/// Records the capture-to-send latency of a frame with the given capture timestamp.
+static inline void pub_latency_record(engine_t *eng, pub_latency_stats_t *stats, const char *kind, uint32_t pts)
+{
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    if (stats->frames == 0 && eng->activate_ms != 0) {
+        ESP_LOGI(TAG, "[BENCH] Standby to streaming (%s): %" PRId64 "ms", kind, now_ms - eng->activate_ms);
+    }
+    int64_t latency_ms = now_ms - (eng->stream_start_ms + (int64_t)pts);
+    if (latency_ms < 0) latency_ms = 0;
+    stats->frames++;
+    stats->total_ms += (uint64_t)latency_ms;
+    if ((uint32_t)latency_ms > stats->max_ms) {
+        stats->max_ms = (uint32_t)latency_ms;
     }
 }
 
-/// Captures and sends a single video frame over the peer connection.
+static void pub_latency_report(const char *kind, const pub_latency_stats_t *stats)
+{
+    if (stats->frames == 0) return;
+    ESP_LOGI(TAG, "[BENCH] %s capture-to-send (%s): frames=%" PRIu32 ", avg=%" PRIu64 "ms, max=%" PRIu32 "ms",
+        kind,
+        PUB_MODE_NAME,
+        stats->frames,
+        stats->total_ms / stats->frames,
+        stats->max_ms);
+}
+#endif
+
+#if CONFIG_LK_BITRATE_CONTROL
+/// Whether the published audio encoder's bitrate can be changed at runtime.
+static inline bool is_audio_bitrate_controlled(engine_t *eng)
+{
+    return eng->options.media.audio_info.codec == ESP_PEER_AUDIO_CODEC_OPUS;
+}
+
+/// Whether the published video encoder's bitrate can be changed at runtime.
+static inline bool is_video_bitrate_controlled(engine_t *eng)
+{
+    return eng->options.media.video_info.codec == ESP_PEER_VIDEO_CODEC_H264;
+}
+
+static engine_err_t bitrate_control_begin(engine_t *eng)
+{
+    bitrate_controller_config_t config = {};
+    if (is_audio_bitrate_controlled(eng)) {
+        config.audio_min_bps = CONFIG_LK_PUB_AUDIO_MIN_KBPS * 1000;
+        config.audio_max_bps = CONFIG_LK_PUB_AUDIO_MAX_KBPS * 1000;
+    }
+    if (is_video_bitrate_controlled(eng)) {
+        config.video_min_bps = CONFIG_LK_PUB_VIDEO_MIN_KBPS * 1000;
+        config.video_max_bps = CONFIG_LK_PUB_VIDEO_MAX_KBPS * 1000;
+    }
+    if (config.audio_max_bps + config.video_max_bps == 0) {
+        // Nothing published has an adjustable bitrate.
+        return ENGINE_ERR_NONE;
+    }
+    config.start_bps = config.audio_max_bps + CONFIG_LK_PUB_VIDEO_START_KBPS * 1000;
+
+    eng->bitrate_controller = bitrate_controller_create(&config);
+    eng->bitrate_mutex = xSemaphoreCreateMutex();
+    if (eng->bitrate_controller == NULL || eng->bitrate_mutex == NULL) {
+        ESP_LOGE(TAG, "Failed to create bitrate controller");
+        return ENGINE_ERR_NO_MEM;
+    }
+    return ENGINE_ERR_NONE;
+}
+
+static void bitrate_control_end(engine_t *eng)
+{
+    bitrate_controller_destroy(eng->bitrate_controller);
+    eng->bitrate_controller = NULL;
+    if (eng->bitrate_mutex != NULL) {
+        vSemaphoreDelete(eng->bitrate_mutex);
+        eng->bitrate_mutex = NULL;
+    }
+}
+
+/// Restarts from the initial bitrate, applied by each publish task on its next frame.
+static void bitrate_control_reset(engine_t *eng)
+{
+    if (eng->bitrate_controller == NULL) {
+        return;
+    }
+    xSemaphoreTake(eng->bitrate_mutex, portMAX_DELAY);
+    bitrate_controller_reset(eng->bitrate_controller);
+    xSemaphoreGive(eng->bitrate_mutex);
+    eng->is_audio_bitrate_stale = true;
+    eng->is_video_bitrate_stale = true;
+}
+
+/// Reports a frame handed to the publisher peer connection.
+///
+/// esp_peer does not expose RTCP receiver reports or transport-wide feedback, so
+/// the time spent in the send call stands in for queueing delay: it grows when the
+/// socket's send buffer is full, and sends fail outright when it overflows. The
+/// controller tracks it per stream, as audio frames often fit where video waits.
+///
+static inline void bitrate_control_on_sent(
+    engine_t *eng,
+    bitrate_stream_t stream,
+    size_t bytes,
+    int64_t send_start_us,
+    bool failed
+) {
+    if (eng->bitrate_controller == NULL) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    uint32_t now_ms = (uint32_t)(now_us / 1000);
+    uint32_t send_ms = (uint32_t)((now_us - send_start_us) / 1000);
+
+    xSemaphoreTake(eng->bitrate_mutex, portMAX_DELAY);
+    bitrate_controller_on_sent(eng->bitrate_controller, stream, bytes, send_ms, failed, now_ms);
+    bool is_changed = bitrate_controller_update(eng->bitrate_controller, now_ms);
+    xSemaphoreGive(eng->bitrate_mutex);
+    if (is_changed) {
+        eng->is_audio_bitrate_stale = true;
+        eng->is_video_bitrate_stale = true;
+    }
+}
+
+/// Returns the highest bitrate worth spending on a published video layer.
+static inline uint32_t video_layer_max_bps(int8_t layer)
+{
+    // Each lower layer has a quarter of the pixels of the one above it, so
+    // it needs no more than a quarter of the bitrate for the same quality.
+    return (uint32_t)(CONFIG_LK_PUB_VIDEO_MAX_KBPS * 1000) >> (2 * (layer > 0 ? layer : 0));
+}
+
+/// Returns the video layer to send for a congestion controller target.
+///
+/// Steps down once the target no longer covers the next layer's maximum, and back
+/// up only once it covers twice that, so a fluctuating target does not switch
+/// layers (and force a keyframe) on every update.
+///
+static uint8_t video_layer_for_bitrate(engine_t *eng, uint8_t layer, uint32_t video_bps)
+{
+    while (layer + 1 < eng->video_layer_count && video_bps < video_layer_max_bps((int8_t)(layer + 1))) {
+        layer++;
+    }
+    while (layer > 0 && video_bps >= 2 * video_layer_max_bps((int8_t)layer)) {
+        layer--;
+    }
+    return layer;
+}
+
+/// Applies the current target to an encoder if it changed since last applied.
+///
+/// Called by the publish task of the given stream type so each capture sink path
+/// is only reconfigured by the task that acquires frames from it.
+///
+static void bitrate_control_apply(engine_t *eng, esp_capture_stream_type_t stream_type, esp_capture_sink_handle_t path)
+{
+    bool is_audio = stream_type == ESP_CAPTURE_STREAM_TYPE_AUDIO;
+    volatile bool *is_stale = is_audio ? &eng->is_audio_bitrate_stale : &eng->is_video_bitrate_stale;
+    if (!*is_stale || eng->bitrate_controller == NULL) {
+        return;
+    }
+    *is_stale = false;
+    if (!(is_audio ? is_audio_bitrate_controlled(eng) : is_video_bitrate_controlled(eng))) {
+        return;
+    }
+    uint32_t audio_bps, video_bps;
+    xSemaphoreTake(eng->bitrate_mutex, portMAX_DELAY);
+    bitrate_controller_get_targets(eng->bitrate_controller, &audio_bps, &video_bps);
+    xSemaphoreGive(eng->bitrate_mutex);
+
+    uint32_t bps = audio_bps;
+    if (!is_audio) {
+        eng->affordable_video_layer = video_layer_for_bitrate(eng, eng->affordable_video_layer, video_bps);
+        uint32_t layer_max_bps = video_layer_max_bps(eng->active_video_layer);
+        bps = video_bps < layer_max_bps ? video_bps : layer_max_bps;
+    }
+    if (esp_capture_sink_set_bitrate(path, stream_type, bps) != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGW(TAG, "Failed to set %s bitrate: %" PRIu32 "bps", is_audio ? "audio" : "video", bps);
+        return;
+    }
+    ESP_LOGD(TAG, "%s bitrate: %" PRIu32 "bps", is_audio ? "Audio" : "Video", bps);
+}
+#endif
+
+/// Switches to the wanted video layer, enabling and disabling capture sink paths.
+///
+/// Video is paused while nothing is subscribed, and otherwise sent from the highest
+/// resolution layer that subscribers request and the congestion controller's target
+/// affords.
+///
+/// Runs on the publish task, between frames, so a path is never disabled while the
+/// task is waiting for a frame from it. The new layer is enabled before the old one
+/// is disabled; a newly enabled encoder starts with a keyframe. A path shared with
+/// audio stays enabled while paused, and its video frames are dropped instead.
+///
+static void media_stream_apply_video_layer(engine_t *eng)
+{
+    int8_t requested = eng->requested_video_layer;
+    int8_t affordable = (int8_t)eng->affordable_video_layer;
+    int8_t wanted = requested < 0 ? -1 : (requested > affordable ? requested : affordable);
+    int8_t active = eng->active_video_layer;
+    if (wanted == active) {
+        return;
+    }
+    if (wanted >= 0 && !eng->is_video_path_shared &&
+        esp_capture_sink_enable(eng->video_paths[wanted], ESP_CAPTURE_RUN_MODE_ALWAYS) != ESP_CAPTURE_ERR_OK) {
+        // Keep sending the active layer; the switch is retried before the next frame.
+        ESP_LOGE(TAG, "Failed to enable video layer %d", wanted);
+        return;
+    }
+    if (active >= 0 && !eng->is_video_path_shared &&
+        esp_capture_sink_enable(eng->video_paths[active], ESP_CAPTURE_RUN_MODE_DISABLE) != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGW(TAG, "Failed to disable video layer %d", active);
+    }
+    eng->active_video_layer = wanted;
+#if CONFIG_LK_BITRATE_CONTROL
+    // The newly enabled encoder starts at its configured bitrate.
+    eng->is_video_bitrate_stale = true;
+#endif
+    if (wanted >= 0 && eng->video_layer_count > 1) {
+        engine_event_t ev = { .type = EV_VIDEO_LAYER_CHANGED };
+        event_enqueue(eng, &ev, false);
+    }
+    if (wanted < 0) {
+        ESP_LOGI(TAG, "Video paused: no subscribers");
+    } else {
+        ESP_LOGI(TAG, "Video layer %d active", wanted);
+    }
+}
+
+/// Returns the capture sink path frames of the given type are acquired from, or
+/// NULL if nothing is being encoded.
+static inline esp_capture_sink_handle_t media_stream_path(engine_t *eng, esp_capture_stream_type_t stream_type)
+{
+    if (stream_type == ESP_CAPTURE_STREAM_TYPE_AUDIO) {
+        return eng->capturer_path;
+    }
+    media_stream_apply_video_layer(eng);
+    if (eng->active_video_layer >= 0) {
+        return eng->video_paths[eng->active_video_layer];
+    }
+    // A path shared with audio keeps encoding while paused; frames are drained but not sent.
+    return eng->is_video_path_shared ? eng->video_paths[0] : NULL;
+}
+
+#if CONFIG_LK_AUDIO_DTX
+/// Returns whether a published audio frame should be sent rather than suppressed as silence.
+static inline bool is_audio_frame_voiced(engine_t *eng, const esp_capture_stream_frame_t *frame)
+{
+    switch (eng->options.media.audio_info.codec) {
+        case ESP_PEER_AUDIO_CODEC_OPUS:
+            return voice_activity_process_opus(eng->voice_activity,
+                frame->data, (size_t)frame->size, frame->pts);
+        case ESP_PEER_AUDIO_CODEC_G711A:
+            return voice_activity_process_g711(eng->voice_activity,
+                frame->data, (size_t)frame->size, true, frame->pts);
+        case ESP_PEER_AUDIO_CODEC_G711U:
+            return voice_activity_process_g711(eng->voice_activity,
+                frame->data, (size_t)frame->size, false, frame->pts);
+        default:
+            return true;
+    }
+}
+#endif
+
+/// Sends an audio frame acquired from the capture sink over the peer connection.
 __attribute__((always_inline))
-static inline void _media_stream_send_video(engine_t *eng)
+static inline void _media_stream_send_audio_frame(engine_t *eng, esp_capture_sink_handle_t path, esp_capture_stream_frame_t *audio_frame)
 {
-    esp_capture_stream_frame_t video_frame = {
-        .stream_type = ESP_CAPTURE_STREAM_TYPE_VIDEO,
+#if CONFIG_LK_AUDIO_DTX
+    if (!is_audio_frame_voiced(eng, audio_frame)) {
+        esp_capture_sink_release_frame(path, audio_frame);
+        return;
+    }
+#endif
+    esp_peer_audio_frame_t audio_send_frame = {
+        .pts = audio_frame->pts,
+        .data = audio_frame->data,
+        .size = audio_frame->size,
     };
-    if (esp_capture_sink_acquire_frame(eng->capturer_path, &video_frame, true) == ESP_CAPTURE_ERR_OK) {
-        esp_peer_video_frame_t video_send_frame = {
-            .pts = video_frame.pts,
-            .data = video_frame.data,
-            .size = video_frame.size,
-        };
-        peer_send_video(eng->pub_peer_handle, &video_send_frame);
-        esp_capture_sink_release_frame(eng->capturer_path, &video_frame);
+#if CONFIG_LK_BITRATE_CONTROL
+    bitrate_control_apply(eng, ESP_CAPTURE_STREAM_TYPE_AUDIO, path);
+    int64_t send_start_us = esp_timer_get_time();
+    peer_err_t send_err = peer_send_audio(eng->pub_peer_handle, &audio_send_frame);
+    bitrate_control_on_sent(eng, BITRATE_STREAM_AUDIO, (size_t)audio_frame->size, send_start_us, send_err != PEER_ERR_NONE);
+#else
+    peer_send_audio(eng->pub_peer_handle, &audio_send_frame);
+#endif
+#if CONFIG_LK_BENCHMARK
+    pub_latency_record(eng, &eng->audio_latency, "Audio", audio_frame->pts);
+#endif
+    esp_capture_sink_release_frame(path, audio_frame);
+}
+
+/// Sends a video frame acquired from the capture sink over the peer connection.
+__attribute__((always_inline))
+static inline void _media_stream_send_video_frame(engine_t *eng, esp_capture_sink_handle_t path, esp_capture_stream_frame_t *video_frame)
+{
+    if (eng->active_video_layer < 0) {
+        esp_capture_sink_release_frame(path, video_frame);
+        return;
     }
+    esp_peer_video_frame_t video_send_frame = {
+        .pts = video_frame->pts,
+        .data = video_frame->data,
+        .size = video_frame->size,
+    };
+#if CONFIG_LK_BITRATE_CONTROL
+    bitrate_control_apply(eng, ESP_CAPTURE_STREAM_TYPE_VIDEO, path);
+    int64_t send_start_us = esp_timer_get_time();
+    peer_err_t send_err = peer_send_video(eng->pub_peer_handle, &video_send_frame);
+    if (is_video_bitrate_controlled(eng)) {
+        bitrate_control_on_sent(eng, BITRATE_STREAM_VIDEO, (size_t)video_frame->size, send_start_us, send_err != PEER_ERR_NONE);
+    }
+#else
+    peer_send_video(eng->pub_peer_handle, &video_send_frame);
+#endif
+#if CONFIG_LK_BENCHMARK
+    pub_latency_record(eng, &eng->video_latency, "Video", video_frame->pts);
+#endif
+    esp_capture_sink_release_frame(path, video_frame);
 }
 
-static void media_stream_task(void *arg)
+/// Publish loop for a single capture stream.
+///
+/// Audio and video each run this loop on their own task so that sending a large
+/// video frame never delays the next audio frame. In event mode the loop blocks on
+/// the capture sink until a frame is encoded; in polling mode it drains available
+/// frames every `CONFIG_LK_PUB_INTERVAL_MS`.
+///
+static void media_stream_loop(engine_t *eng, esp_capture_stream_type_t stream_type)
 {
-    engine_t *eng = (engine_t *)arg;
+    esp_capture_stream_frame_t frame = {
+        .stream_type = stream_type,
+    };
     while (eng->is_media_streaming) {
-        if (eng->options.media.audio_info.codec != ESP_PEER_AUDIO_CODEC_NONE) {
-            _media_stream_send_audio(eng);
+        esp_capture_sink_handle_t path = media_stream_path(eng, stream_type);
+        if (path == NULL) {
+            // Video is paused and its encoder is stopped.
+            media_lib_thread_sleep(CONFIG_LK_PUB_INTERVAL_MS);
+            continue;
         }
-        if (eng->options.media.video_info.codec != ESP_PEER_VIDEO_CODEC_NONE) {
-            _media_stream_send_video(eng);
+#if CONFIG_LK_PUB_MODE_EVENT
+        if (esp_capture_sink_acquire_frame(path, &frame, false) != ESP_CAPTURE_ERR_OK) {
+            // Capture stopped or not producing frames; avoid spinning.
+            media_lib_thread_sleep(CONFIG_LK_PUB_INTERVAL_MS);
+            continue;
+        }
+        if (stream_type == ESP_CAPTURE_STREAM_TYPE_AUDIO) {
+            _media_stream_send_audio_frame(eng, path, &frame);
+        } else {
+            _media_stream_send_video_frame(eng, path, &frame);
+        }
+        frame.stream_type = stream_type;
+#else
+        while (esp_capture_sink_acquire_frame(path, &frame, true) == ESP_CAPTURE_ERR_OK) {
+            if (stream_type == ESP_CAPTURE_STREAM_TYPE_AUDIO) {
+                _media_stream_send_audio_frame(eng, path, &frame);
+            } else {
+                _media_stream_send_video_frame(eng, path, &frame);
+            }
+            frame.stream_type = stream_type;
         }
         media_lib_thread_sleep(CONFIG_LK_PUB_INTERVAL_MS);
+#endif
     }
+    xSemaphoreGive(eng->stream_done_sem);
+}
+
+static void media_stream_audio_task(void *arg)
+{
+    media_stream_loop((engine_t *)arg, ESP_CAPTURE_STREAM_TYPE_AUDIO);
     media_lib_thread_destroy(NULL);
 }
 
+static void media_stream_video_task(void *arg)
+{
+    media_stream_loop((engine_t *)arg, ESP_CAPTURE_STREAM_TYPE_VIDEO);
+    media_lib_thread_destroy(NULL);
+}
+
+/// Waits for all running publish tasks to exit.
+///
+/// Capture must be stopped first so a task blocked acquiring a frame returns. The
+/// tasks use engine state until they exit, so this keeps waiting rather than
+/// giving up and letting the caller free that state under them.
+///
+static void media_stream_join(engine_t *eng)
+{
+    while (eng->stream_task_count > 0) {
+        if (xSemaphoreTake(eng->stream_done_sem, pdMS_TO_TICKS(ENGINE_TASK_JOIN_TIMEOUT_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "Still waiting for media stream tasks to exit: count=%d", eng->stream_task_count);
+            continue;
+        }
+        eng->stream_task_count--;
+    }
+}
+
 static engine_err_t media_stream_begin(engine_t *eng)
 {
     if (esp_capture_start(eng->options.media.capturer) != ESP_CAPTURE_ERR_OK) {
         ESP_LOGE(TAG, "Failed to start capture");
         return ENGINE_ERR_MEDIA;
     }
+#if CONFIG_LK_BENCHMARK
+    eng->stream_start_ms = esp_timer_get_time() / 1000;
+    memset(&eng->audio_latency, 0, sizeof(eng->audio_latency));
+    memset(&eng->video_latency, 0, sizeof(eng->video_latency));
+#endif
     media_lib_thread_handle_t handle = NULL;
     eng->is_media_streaming = true;
-    if (media_lib_thread_create_from_scheduler(&handle, "lk_eng_stream", media_stream_task, eng) != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create media stream thread");
-        eng->is_media_streaming = false;
-        return ENGINE_ERR_MEDIA;
+    // Send the top layer until the server reports whether video is subscribed.
+    eng->requested_video_layer = 0;
+    eng->affordable_video_layer = 0;
+#if CONFIG_LK_BITRATE_CONTROL
+    bitrate_control_reset(eng);
+#endif
+#if CONFIG_LK_AUDIO_DTX
+    voice_activity_reset(eng->voice_activity);
+#endif
+
+    if (eng->options.media.audio_info.codec != ESP_PEER_AUDIO_CODEC_NONE) {
+        if (media_lib_thread_create_from_scheduler(&handle, "lk_pub_audio", media_stream_audio_task, eng) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create audio publish thread");
+            goto _begin_failed;
+        }
+        eng->stream_task_count++;
+    }
+    if (eng->options.media.video_info.codec != ESP_PEER_VIDEO_CODEC_NONE) {
+        if (media_lib_thread_create_from_scheduler(&handle, "lk_pub_video", media_stream_video_task, eng) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create video publish thread");
+            goto _begin_failed;
+        }
+        eng->stream_task_count++;
     }
     return ENGINE_ERR_NONE;
+
+_begin_failed:
+    eng->is_media_streaming = false;
+    esp_capture_stop(eng->options.media.capturer);
+    media_stream_join(eng);
+    return ENGINE_ERR_MEDIA;
 }
 
 static engine_err_t media_stream_end(engine_t *eng)
@@ -298,22 +1179,137 @@ static engine_err_t media_stream_end(engine_t *eng)
     }
     eng->is_media_streaming = false;
     esp_capture_stop(eng->options.media.capturer);
+    media_stream_join(eng);
+#if CONFIG_LK_BENCHMARK
+    pub_latency_report("Audio", &eng->audio_latency);
+    pub_latency_report("Video", &eng->video_latency);
+    eng->activate_ms = 0;
+#endif
     return ENGINE_ERR_NONE;
 }
 
+/// Starts or stops publishing to match the standby setting while connected.
+///
+/// In standby the peers stay connected but capture is stopped; the idle timer
+/// closes the connection if the room is not activated in time.
+///
+static void media_stream_update(engine_t *eng)
+{
+    if (eng->is_standby) {
+        media_stream_end(eng);
+#if CONFIG_LK_STANDBY_IDLE_TIMEOUT_S > 0
+        xTimerReset(eng->idle_timer, 0);
+#endif
+        return;
+    }
+    xTimerStop(eng->idle_timer, 0);
+    if (!eng->is_media_streaming) {
+        media_stream_begin(eng);
+    }
+}
+
+// MARK: - Reliable data buffering
+
+static bool send_buffered_packet(const uint8_t *data, size_t size, void *ctx)
+{
+    engine_t *eng = (engine_t *)ctx;
+    return eng->pub_peer_handle != NULL &&
+        peer_send_data(eng->pub_peer_handle, data, size, true) == PEER_ERR_NONE;
+}
+
+/// Sends buffered packets. Must be called with `data_mutex` held.
+///
+/// Packets are sent directly again once the buffer is drained; otherwise the
+/// flush is retried after a delay.
+///
+static void flush_reliable_locked(engine_t *eng)
+{
+    eng->is_data_ready = reliable_buffer_flush(eng->reliable_buffer, send_buffered_packet, eng);
+    if (!eng->is_data_ready) {
+        xTimerReset(eng->flush_timer, 0);
+    }
+}
+
+/// Sends buffered packets once data can flow; called on the engine task.
+static void flush_reliable_buffer(engine_t *eng)
+{
+    xSemaphoreTake(eng->data_mutex, portMAX_DELAY);
+    flush_reliable_locked(eng);
+    xSemaphoreGive(eng->data_mutex);
+}
+
+#if CONFIG_LK_ICE_RESTART
+/// Buffers reliable packets until the next flush, e.g. while the publisher's data
+/// channel is torn down by an ICE restart without leaving the connected state.
+static void hold_reliable_data(engine_t *eng)
+{
+    xSemaphoreTake(eng->data_mutex, portMAX_DELAY);
+    eng->is_data_ready = false;
+    xTimerStop(eng->flush_timer, 0);
+    xSemaphoreGive(eng->data_mutex);
+}
+#endif
+
+/// Publishes a state transition to the send path.
+///
+/// Outside of `ENGINE_STATE_CONNECTED`, reliable packets are buffered until the
+/// next flush.
+///
+static void update_data_state(engine_t *eng)
+{
+    xSemaphoreTake(eng->data_mutex, portMAX_DELAY);
+    eng->data_state = eng->state;
+    if (eng->state != ENGINE_STATE_CONNECTED) {
+        eng->is_data_ready = false;
+        xTimerStop(eng->flush_timer, 0);
+    }
+    xSemaphoreGive(eng->data_mutex);
+}
+
+/// Encodes a reliable packet and appends it to the buffer to be sent once connected.
+static engine_err_t buffer_reliable_packet(engine_t *eng, const livekit_pb_data_packet_t *packet)
+{
+    const uint8_t *encoded = NULL;
+    size_t encoded_size = 0;
+    if (!protocol_encoder_encode_data_packet(eng->reliable_encoder, packet, &encoded, &encoded_size)) {
+        return ENGINE_ERR_OTHER;
+    }
+    reliable_buffer_err_t ret = reliable_buffer_push(eng->reliable_buffer, encoded, encoded_size);
+    protocol_encoder_release(eng->reliable_encoder);
+
+    switch (ret) {
+        case RELIABLE_BUFFER_ERR_NONE:   return ENGINE_ERR_NONE;
+        case RELIABLE_BUFFER_ERR_NO_MEM: return ENGINE_ERR_NO_MEM;
+        default:
+            ESP_LOGW(TAG, "Reliable buffer full, packet not sent");
+            return ENGINE_ERR_OTHER;
+    }
+}
+
 static engine_err_t send_add_audio_track(engine_t *eng)
 {
     bool is_stereo = eng->options.media.audio_info.channel == 2;
+    // DTX is negotiated for Opus only; the SFU assumes it is used unless told otherwise.
+#if CONFIG_LK_AUDIO_DTX
+    bool is_dtx = eng->options.media.audio_info.codec == ESP_PEER_AUDIO_CODEC_OPUS;
+#else
+    bool is_dtx = false;
+#endif
     livekit_pb_add_track_request_t req = {
         .cid = "a0",
         .name = CONFIG_LK_PUB_AUDIO_TRACK_NAME,
         .type = LIVEKIT_PB_TRACK_TYPE_AUDIO,
         .source = LIVEKIT_PB_TRACK_SOURCE_MICROPHONE,
         .muted = false,
-        .audio_features_count = is_stereo ? 1 : 0,
-        .audio_features = { LIVEKIT_PB_AUDIO_TRACK_FEATURE_TF_STEREO },
+        .audio_features_count = 0,
         .layers_count = 0
     };
+    if (is_stereo) {
+        req.audio_features[req.audio_features_count++] = LIVEKIT_PB_AUDIO_TRACK_FEATURE_TF_STEREO;
+    }
+    if (!is_dtx) {
+        req.audio_features[req.audio_features_count++] = LIVEKIT_PB_AUDIO_TRACK_FEATURE_TF_NO_DTX;
+    }
 
     if (signal_send_add_track(eng->signal_handle, &req) != SIGNAL_ERR_NONE) {
         ESP_LOGE(TAG, "Failed to publish audio track");
@@ -322,25 +1318,91 @@ static engine_err_t send_add_audio_track(engine_t *eng)
     return ENGINE_ERR_NONE;
 }
 
+/// Returns the published video layer serving a subscribed quality.
+///
+/// Layers are ordered highest resolution first, so HIGH maps to the top layer and
+/// each lower quality to the next layer down, clamped to the lowest layer.
+///
+static int8_t video_layer_for_quality(engine_t *eng, livekit_pb_video_quality_t quality)
+{
+    int layer = LIVEKIT_PB_VIDEO_QUALITY_HIGH - (int)quality;
+    if (layer < 0) {
+        layer = 0;
+    }
+    if (layer >= eng->video_layer_count) {
+        layer = eng->video_layer_count - 1;
+    }
+    return (int8_t)layer;
+}
+
+/// Selects the published video layer from the highest quality the server reports
+/// subscribers for, pausing video when none is enabled so neither encoder time
+/// nor uplink bandwidth is spent on video nobody receives.
+///
+static void handle_subscribed_quality_update(engine_t *eng, const livekit_pb_subscribed_quality_update_t *update)
+{
+    if (eng->options.media.video_info.codec == ESP_PEER_VIDEO_CODEC_NONE) {
+        return;
+    }
+    int8_t requested = -1;
+    for (pb_size_t i = 0; i < update->subscribed_codecs_count; i++) {
+        const livekit_pb_subscribed_codec_t *codec = &update->subscribed_codecs[i];
+        for (pb_size_t j = 0; j < codec->qualities_count; j++) {
+            if (!codec->qualities[j].enabled ||
+                codec->qualities[j].quality == LIVEKIT_PB_VIDEO_QUALITY_OFF) {
+                continue;
+            }
+            int8_t layer = video_layer_for_quality(eng, codec->qualities[j].quality);
+            if (requested < 0 || layer < requested) {
+                requested = layer;
+            }
+        }
+    }
+    ESP_LOGD(TAG, "Subscribed quality update: requested_layer=%d", requested);
+    eng->requested_video_layer = requested;
+}
+
+/// Tells the server the resolution of the video layer being sent, if it changed
+/// since it was last advertised.
+static void advertise_video_layer(engine_t *eng)
+{
+    int8_t layer = eng->active_video_layer;
+    if (layer < 0 || layer == eng->advertised_video_layer ||
+        eng->session.local_video_sid[0] == '\0') {
+        return;
+    }
+    uint16_t width, height;
+    video_layer_size(eng, (uint8_t)layer, &width, &height);
+    if (signal_send_update_video_track(eng->signal_handle, eng->session.local_video_sid,
+        width, height) != SIGNAL_ERR_NONE) {
+        return;
+    }
+    ESP_LOGD(TAG, "Advertised video layer %d: %dx%d", layer, width, height);
+    eng->advertised_video_layer = layer;
+}
+
 static engine_err_t send_add_video_track(engine_t *eng)
 {
-    livekit_pb_video_layer_t video_layer = {
-        .quality = LIVEKIT_PB_VIDEO_QUALITY_HIGH,
-        .width = (uint32_t)eng->options.media.video_info.width,
-        .height = (uint32_t)eng->options.media.video_info.height
-    };
     livekit_pb_add_track_request_t req = {
         .cid = "v0",
         .name = CONFIG_LK_PUB_VIDEO_TRACK_NAME,
         .type = LIVEKIT_PB_TRACK_TYPE_VIDEO,
         .source = LIVEKIT_PB_TRACK_SOURCE_CAMERA,
         .muted = false,
-        .width = video_layer.width,
-        .height = video_layer.height,
+        .width = (uint32_t)eng->options.media.video_info.width,
+        .height = (uint32_t)eng->options.media.video_info.height,
         .layers_count = 1,
-        .layers = { video_layer },
         .backup_codec_policy = LIVEKIT_PB_BACKUP_CODEC_POLICY_REGRESSION
     };
+    // esp_peer sends a single video stream without simulcast, so that is the only
+    // layer advertised. Lower resolution layers replace it under congestion, and
+    // the advertised resolution is updated to match (see `advertise_video_layer`).
+    req.layers[0] = (livekit_pb_video_layer_t){
+        .quality = LIVEKIT_PB_VIDEO_QUALITY_HIGH,
+        .width = req.width,
+        .height = req.height
+    };
+    eng->advertised_video_layer = 0;
 
     if (signal_send_add_track(eng->signal_handle, &req) != SIGNAL_ERR_NONE) {
         ESP_LOGE(TAG, "Failed to publish video track");
@@ -378,12 +1440,43 @@ static void on_signal_state_changed(signal_state_t state, void *ctx)
     event_enqueue(eng, &ev, true);
 }
 
+/// Takes a signal response from the pool, or allocates one if the pool is empty.
+static livekit_pb_signal_response_t *signal_res_alloc(engine_t *eng)
+{
+    livekit_pb_signal_response_t *res;
+    if (xQueueReceive(eng->sig_res_free, &res, 0) == pdPASS) {
+        return res;
+    }
+    return malloc(sizeof(livekit_pb_signal_response_t));
+}
+
+/// Returns a signal response to the pool, or frees it if it was allocated.
+static void signal_res_free(engine_t *eng, livekit_pb_signal_response_t *res)
+{
+    bool is_pooled = res >= eng->sig_res_pool && res < eng->sig_res_pool + SIGNAL_RES_POOL_SIZE;
+    if (!is_pooled) {
+        free(res);
+        return;
+    }
+    xQueueSend(eng->sig_res_free, &res, 0);
+}
+
+static livekit_pb_signal_response_t *on_signal_res_alloc(void *ctx)
+{
+    return signal_res_alloc((engine_t *)ctx);
+}
+
+static void on_signal_res_free(livekit_pb_signal_response_t *res, void *ctx)
+{
+    signal_res_free((engine_t *)ctx, res);
+}
+
 static bool on_signal_res(livekit_pb_signal_response_t *res, void *ctx)
 {
     engine_t *eng = (engine_t *)ctx;
     engine_event_t ev = {
         .type = EV_SIG_RES,
-        .detail.res = *res
+        .detail.res = res
     };
     // Returning true takes ownership of the response; it will be freed later when the
     // queue is processed or flushed.
@@ -417,11 +1510,18 @@ static void on_peer_sdp(const char *sdp, peer_role_t role, void *ctx)
 static bool on_peer_data_packet(livekit_pb_data_packet_t* packet, void *ctx)
 {
     engine_t *eng = (engine_t *)ctx;
-    // TODO: Implement buffering for incoming data packets
-    if (eng->options.on_data_packet) {
-        eng->options.on_data_packet(packet, eng->options.ctx);
+    if (eng->options.on_data_packet == NULL) {
+        return false;
     }
-    return false;
+    // Ownership is taken only if the packet was queued.
+    return data_dispatch_enqueue(eng->data_dispatch, packet);
+}
+
+/// Invoked on the data dispatch task for each incoming packet.
+static void on_dispatch_data_packet(livekit_pb_data_packet_t* packet, void *ctx)
+{
+    engine_t *eng = (engine_t *)ctx;
+    eng->options.on_data_packet(packet, eng->options.ctx);
 }
 
 // MARK: - Timer expired handler
@@ -433,6 +1533,20 @@ static void on_timer_expired(TimerHandle_t timer)
     event_enqueue(eng, &ev, true);
 }
 
+static void on_idle_timer_expired(TimerHandle_t timer)
+{
+    engine_t *eng = (engine_t *)pvTimerGetTimerID(timer);
+    engine_event_t ev = { .type = EV_STANDBY_IDLE };
+    event_enqueue(eng, &ev, false);
+}
+
+static void on_flush_timer_expired(TimerHandle_t timer)
+{
+    engine_t *eng = (engine_t *)pvTimerGetTimerID(timer);
+    engine_event_t ev = { .type = EV_FLUSH_RETRY };
+    event_enqueue(eng, &ev, false);
+}
+
 // MARK: - Peer lifecycle
 
 static inline void _create_and_connect_peer(peer_options_t *options, peer_handle_t *peer)
@@ -445,6 +1559,27 @@ static inline void _create_and_connect_peer(peer_options_t *options, peer_handle
     }
 }
 
+#if CONFIG_LK_PARALLEL_PEER_SETUP
+/// A peer created and connected on a helper thread.
+typedef struct {
+    peer_options_t *options;
+    peer_handle_t *peer;
+    SemaphoreHandle_t done_sem;
+    /// Time taken to create and connect the peer.
+    int64_t elapsed_ms;
+} peer_setup_t;
+
+static void peer_setup_task(void *arg)
+{
+    peer_setup_t *setup = (peer_setup_t *)arg;
+    int64_t start_ms = esp_timer_get_time() / 1000;
+    _create_and_connect_peer(setup->options, setup->peer);
+    setup->elapsed_ms = esp_timer_get_time() / 1000 - start_ms;
+    xSemaphoreGive(setup->done_sem);
+    media_lib_thread_destroy(NULL);
+}
+#endif
+
 static inline void _disconnect_and_destroy_peer(peer_handle_t *peer)
 {
     if (!peer || !*peer) return;
@@ -453,10 +1588,34 @@ static inline void _disconnect_and_destroy_peer(peer_handle_t *peer)
     *peer = NULL;
 }
 
+/// Drops queued candidates and waits for a new remote description.
+static void pending_candidates_clear(pending_candidates_t *pending)
+{
+    for (uint8_t i = 0; i < pending->count; i++) {
+        SAFE_FREE(pending->candidates[i]);
+    }
+    pending->count = 0;
+    pending->has_remote_sdp = false;
+}
+
 static void destroy_peer_connections(engine_t *eng)
 {
     _disconnect_and_destroy_peer(&eng->pub_peer_handle);
     _disconnect_and_destroy_peer(&eng->sub_peer_handle);
+    pending_candidates_clear(&eng->pub_candidates);
+    pending_candidates_clear(&eng->sub_candidates);
+}
+
+/// Restarts ICE on a peer; see `peer_restart_ice`.
+static peer_err_t restart_peer_ice(engine_t *eng, peer_role_t role)
+{
+    bool is_publisher = role == PEER_ROLE_PUBLISHER;
+    peer_err_t err = peer_restart_ice(is_publisher ? eng->pub_peer_handle : eng->sub_peer_handle);
+    if (err == PEER_ERR_NONE) {
+        // Candidates for the new transport wait for the new remote description.
+        pending_candidates_clear(is_publisher ? &eng->pub_candidates : &eng->sub_candidates);
+    }
+    return err;
 }
 
 /// Maps list of `livekit_pb_ice_server_t` to list of `esp_peer_ice_server_cfg_t`.
@@ -508,7 +1667,8 @@ static bool establish_peer_connections(engine_t *eng, const livekit_pb_join_resp
         return false;
     }
 
-    peer_options_t options = {
+    peer_options_t pub_options = {
+        .role             = PEER_ROLE_PUBLISHER,
         .force_relay      = join->client_configuration.force_relay
             == LIVEKIT_PB_CLIENT_CONFIG_SETTING_ENABLED,
         .media            = &eng->options.media,
@@ -519,21 +1679,75 @@ static bool establish_peer_connections(engine_t *eng, const livekit_pb_join_resp
         .on_data_packet   = on_peer_data_packet,
         .ctx              = eng
     };
+    peer_options_t sub_options = pub_options;
+    sub_options.role           = PEER_ROLE_SUBSCRIBER;
+    sub_options.on_audio_info  = on_peer_sub_audio_info;
+    sub_options.on_audio_frame = on_peer_sub_audio_frame;
+    if (eng->video_renderer != NULL) {
+        sub_options.on_video_info  = on_peer_sub_video_info;
+        sub_options.on_video_frame = on_peer_sub_video_frame;
+    }
+
+    bool is_parallel = false;
+#if CONFIG_LK_BENCHMARK
+    int64_t start_ms = esp_timer_get_time() / 1000;
+    int64_t sub_elapsed_ms = 0;
+#endif
+
+#if CONFIG_LK_PARALLEL_PEER_SETUP
+    // Opening a peer and starting its task dominates setup time, so the
+    // subscriber is set up on a helper thread (on the other core, see
+    // `system.c`) while this task sets up the publisher.
+    peer_setup_t sub_setup = {
+        .options = &sub_options,
+        .peer = &eng->sub_peer_handle,
+        .done_sem = xSemaphoreCreateBinary()
+    };
+    media_lib_thread_handle_t setup_thread = NULL;
+    is_parallel = sub_setup.done_sem != NULL &&
+        media_lib_thread_create_from_scheduler(&setup_thread, "lk_peer_setup", peer_setup_task, &sub_setup) == ESP_OK;
+    if (!is_parallel) {
+        ESP_LOGW(TAG, "Failed to create peer setup thread, setting up peers sequentially");
+    }
+#endif
 
     // 1. Publisher
-    options.role          = PEER_ROLE_PUBLISHER;
-    _create_and_connect_peer(&options, &eng->pub_peer_handle);
-    if (eng->pub_peer_handle == NULL)
-        return false;
+    _create_and_connect_peer(&pub_options, &eng->pub_peer_handle);
+#if CONFIG_LK_BENCHMARK
+    int64_t pub_elapsed_ms = esp_timer_get_time() / 1000 - start_ms;
+#endif
 
     // 2. Subscriber
-    options.role           = PEER_ROLE_SUBSCRIBER;
-    options.on_audio_info  = on_peer_sub_audio_info;
-    options.on_audio_frame = on_peer_sub_audio_frame;
-
-    _create_and_connect_peer(&options, &eng->sub_peer_handle);
-    if (eng->sub_peer_handle == NULL) {
-        _disconnect_and_destroy_peer(&eng->pub_peer_handle);
+#if CONFIG_LK_PARALLEL_PEER_SETUP
+    if (is_parallel) {
+        // Must not time out: the helper thread uses state on this stack.
+        xSemaphoreTake(sub_setup.done_sem, portMAX_DELAY);
+#if CONFIG_LK_BENCHMARK
+        sub_elapsed_ms = sub_setup.elapsed_ms;
+#endif
+    }
+    if (sub_setup.done_sem != NULL) {
+        vSemaphoreDelete(sub_setup.done_sem);
+    }
+#endif
+    if (!is_parallel) {
+#if CONFIG_LK_BENCHMARK
+        int64_t sub_start_ms = esp_timer_get_time() / 1000;
+#endif
+        _create_and_connect_peer(&sub_options, &eng->sub_peer_handle);
+#if CONFIG_LK_BENCHMARK
+        sub_elapsed_ms = esp_timer_get_time() / 1000 - sub_start_ms;
+#endif
+    }
+#if CONFIG_LK_BENCHMARK
+    eng->peer_setup_ms = (uint32_t)(esp_timer_get_time() / 1000 - start_ms);
+    ESP_LOGI(TAG, "[BENCH] Peer setup (%s): publisher=%" PRId64 "ms, subscriber=%" PRId64 "ms, total=%" PRIu32 "ms",
+        is_parallel ? "parallel" : "sequential",
+        pub_elapsed_ms, sub_elapsed_ms, eng->peer_setup_ms);
+#endif
+
+    if (eng->pub_peer_handle == NULL || eng->sub_peer_handle == NULL) {
+        destroy_peer_connections(eng);
         return false;
     }
     return true;
@@ -562,6 +1776,7 @@ static inline bool map_engine_state(engine_t *eng, livekit_connection_state_t *o
             }
             *out_state = LIVEKIT_CONNECTION_STATE_CONNECTING;
             break;
+        case ENGINE_STATE_RESUMING:
         case ENGINE_STATE_BACKOFF:
             *out_state = LIVEKIT_CONNECTION_STATE_RECONNECTING;
             break;
@@ -610,7 +1825,7 @@ static livekit_failure_reason_t map_disconnect_reason(livekit_pb_disconnect_reas
 }
 
 /// Frees an event's dynamically allocated fields (if any).
-static void event_free(engine_event_t *ev)
+static void event_free(engine_t *eng, engine_event_t *ev)
 {
     if (ev == NULL) return;
     switch (ev->type) {
@@ -619,7 +1834,11 @@ static void event_free(engine_event_t *ev)
             SAFE_FREE(ev->detail.cmd_connect.token);
             break;
         case EV_SIG_RES:
-            protocol_signal_response_free(&ev->detail.res);
+            if (ev->detail.res != NULL) {
+                protocol_signal_response_free(ev->detail.res);
+                signal_res_free(eng, ev->detail.res);
+                ev->detail.res = NULL;
+            }
             break;
         case EV_PEER_SDP:
             SAFE_FREE(ev->detail.peer_sdp.sdp);
@@ -636,8 +1855,23 @@ static bool event_enqueue(engine_t *eng, engine_event_t *ev, bool send_to_front)
         xQueueSend(eng->event_queue, ev, 0)) == pdPASS;
     if (!enqueued) {
         ESP_LOGE(TAG, "Failed to enqueue event: type=%d", ev->type);
+        return false;
     }
-    return enqueued;
+    unsigned depth = (unsigned)uxQueueMessagesWaiting(eng->event_queue);
+    unsigned high_water = atomic_load(&eng->event_queue_high_water);
+    while (depth > high_water &&
+           !atomic_compare_exchange_weak(&eng->event_queue_high_water, &high_water, depth)) {}
+    return true;
+}
+
+/// Logs event queue memory usage and the maximum number of events queued at once.
+static void event_queue_report(engine_t *eng)
+{
+    ESP_LOGD(TAG, "Event queue: slot=%u bytes, capacity=%d, total=%u bytes, high-water=%u",
+        (unsigned)sizeof(engine_event_t),
+        CONFIG_LK_ENGINE_QUEUE_SIZE,
+        (unsigned)(sizeof(engine_event_t) * CONFIG_LK_ENGINE_QUEUE_SIZE),
+        atomic_load(&eng->event_queue_high_water));
 }
 
 /// Dequeues all events from the queue and frees them.
@@ -645,7 +1879,7 @@ static void flush_event_queue(engine_t *eng)
 {
     engine_event_t ev;
     while (xQueueReceive(eng->event_queue, &ev, 0) == pdPASS) {
-        event_free(&ev);
+        event_free(eng, &ev);
     }
 }
 
@@ -665,8 +1899,222 @@ static inline void timer_stop(engine_t *eng)
     xTimerStop(eng->timer, 0);
 }
 
+// MARK: - Connection recovery
+
+/// Starts recovering a failed peer with an ICE restart, keeping the signaling
+/// session and the other peer.
+///
+/// @returns False if the peer cannot be restarted and a full reconnect is needed.
+///
+static bool ice_restart_begin(engine_t *eng, peer_role_t role)
+{
+#if CONFIG_LK_ICE_RESTART
+    if (eng->is_ice_restarting || role != PEER_ROLE_PUBLISHER) {
+        // The subscriber can only be restarted by the server.
+        return false;
+    }
+    if (restart_peer_ice(eng, PEER_ROLE_PUBLISHER) != PEER_ERR_NONE) {
+        return false;
+    }
+    eng->is_ice_restarting = true;
+    hold_reliable_data(eng);
+    eng->ice_restart_start_ms = esp_timer_get_time() / 1000;
+    timer_start(eng, CONFIG_LK_ICE_RESTART_TIMEOUT_MS);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Records a completed ICE restart.
+static void ice_restart_end(engine_t *eng)
+{
+    timer_stop(eng);
+    eng->is_ice_restarting = false;
+    uint32_t elapsed_ms = (uint32_t)(esp_timer_get_time() / 1000 - eng->ice_restart_start_ms);
+    livekit_reconnect_stats_t *stats = &eng->reconnect_stats;
+    stats->ice_restarts++;
+    stats->last_ice_restart_ms = elapsed_ms;
+    eng->ice_restart_total_ms += elapsed_ms;
+    stats->avg_ice_restart_ms = (uint32_t)(eng->ice_restart_total_ms / stats->ice_restarts);
+    ESP_LOGI(TAG, "ICE restart completed in %" PRIu32 "ms", elapsed_ms);
+#if CONFIG_LK_BENCHMARK
+    ESP_LOGI(TAG, "[BENCH] Recovery (ICE restart): last=%" PRIu32 "ms, avg=%" PRIu32 "ms, count=%" PRIu32,
+        elapsed_ms, stats->avg_ice_restart_ms, stats->ice_restarts);
+#endif
+    // Send what was held back while the data channel was down.
+    flush_reliable_buffer(eng);
+}
+
+/// Abandons an ICE restart that failed or timed out.
+static void ice_restart_abort(engine_t *eng)
+{
+    timer_stop(eng);
+    eng->is_ice_restarting = false;
+    eng->reconnect_stats.ice_restart_failures++;
+}
+
+/// Records a completed full reconnect, if one was in progress.
+static void full_reconnect_end(engine_t *eng)
+{
+    if (eng->full_reconnect_start_ms == 0) {
+        return;
+    }
+    uint32_t elapsed_ms = (uint32_t)(esp_timer_get_time() / 1000 - eng->full_reconnect_start_ms);
+    eng->full_reconnect_start_ms = 0;
+    livekit_reconnect_stats_t *stats = &eng->reconnect_stats;
+    stats->full_reconnects++;
+    stats->last_full_reconnect_ms = elapsed_ms;
+    eng->full_reconnect_total_ms += elapsed_ms;
+    stats->avg_full_reconnect_ms = (uint32_t)(eng->full_reconnect_total_ms / stats->full_reconnects);
+#if CONFIG_LK_BENCHMARK
+    ESP_LOGI(TAG, "[BENCH] Recovery (full reconnect): last=%" PRIu32 "ms, avg=%" PRIu32 "ms, count=%" PRIu32,
+        elapsed_ms, stats->avg_full_reconnect_ms, stats->full_reconnects);
+#endif
+}
+
+/// Keeps a copy of an SDP negotiated by the subscriber for `SyncState`.
+static inline void store_sub_sdp(char **slot, const char *sdp)
+{
+#if CONFIG_LK_SIGNAL_RESUME
+    SAFE_FREE(*slot);
+    *slot = strdup(sdp);
+#endif
+}
+
+/// Whether a lost connection can be recovered by resuming the signaling session.
+static bool can_resume(engine_t *eng)
+{
+#if CONFIG_LK_SIGNAL_RESUME
+    if (eng->session.local_participant_sid[0] == '\0' ||
+        eng->pub_peer_handle == NULL ||
+        eng->sub_peer_handle == NULL) {
+        return false;
+    }
+    // Losing the connection again right after a resume suggests resuming cannot
+    // fix it; rejoin instead of resuming in a loop.
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    return eng->resume_end_ms == 0 ||
+        now_ms - eng->resume_end_ms > CONFIG_LK_SIGNAL_RESUME_TIMEOUT_MS;
+#else
+    return false;
+#endif
+}
+
+/// Reconnects the signaling connection as the same participant, keeping the peers.
+static void resume_begin(engine_t *eng)
+{
+#if CONFIG_LK_SIGNAL_RESUME
+    eng->is_resume_signal_connected = false;
+    eng->is_signal_resumed = false;
+    ESP_LOGI(TAG, "Resuming session: reason=%d", eng->resume_reason);
+
+    // The server restarts ICE on the subscriber once resumed; a failed transport
+    // must be reset to answer its offer.
+    connection_state_t sub_state = peer_get_state(eng->sub_peer_handle);
+    if (sub_state == CONNECTION_STATE_FAILED ||
+        sub_state == CONNECTION_STATE_DISCONNECTED) {
+        restart_peer_ice(eng, PEER_ROLE_SUBSCRIBER);
+    }
+    signal_close(eng->signal_handle);
+    signal_resume(
+        eng->signal_handle,
+        eng->server_url,
+        eng->token,
+        eng->session.local_participant_sid,
+        eng->resume_reason
+    );
+    timer_start(eng, CONFIG_LK_SIGNAL_RESUME_TIMEOUT_MS);
+#endif
+}
+
+/// Sends the subscriber's negotiated state and subscriptions to the server.
+static void send_sync_state(engine_t *eng)
+{
+    livekit_pb_sync_state_t sync_state = LIVEKIT_PB_SYNC_STATE_INIT_ZERO;
+    if (eng->sub_answer_sdp != NULL) {
+        sync_state.has_answer = true;
+        strlcpy(sync_state.answer.type, "answer", sizeof(sync_state.answer.type));
+        sync_state.answer.sdp = eng->sub_answer_sdp;
+    }
+    if (eng->sub_offer_sdp != NULL) {
+        sync_state.has_offer = true;
+        strlcpy(sync_state.offer.type, "offer", sizeof(sync_state.offer.type));
+        sync_state.offer.sdp = eng->sub_offer_sdp;
+    }
+    char *track_sids[CONFIG_LK_MAX_REMOTE_TRACKS];
+    pb_size_t track_count = 0;
+    for (size_t i = 0; i < CONFIG_LK_MAX_REMOTE_TRACKS; i++) {
+        remote_track_t *track = &eng->session.remote_tracks[i];
+        if (track->sid[0] != '\0' && track->is_subscribed) {
+            track_sids[track_count++] = track->sid;
+        }
+    }
+    sync_state.has_subscription = true;
+    sync_state.subscription.track_sids = track_sids;
+    sync_state.subscription.track_sids_count = track_count;
+    sync_state.subscription.subscribe = true;
+
+    if (signal_send_sync_state(eng->signal_handle, &sync_state) != SIGNAL_ERR_NONE) {
+        ESP_LOGW(TAG, "Failed to send sync state");
+    }
+}
+
+/// Handles the server accepting the resume.
+static void handle_reconnect(engine_t *eng, const livekit_pb_reconnect_response_t *reconnect)
+{
+    ESP_LOGI(TAG, "Session resumed: last_message_seq=%" PRIu32, reconnect->last_message_seq);
+    eng->is_signal_resumed = true;
+    send_sync_state(eng);
+
+    // Unlike the subscriber, the publisher must be restarted by the client.
+    if (peer_get_state(eng->pub_peer_handle) != CONNECTION_STATE_CONNECTED) {
+        restart_peer_ice(eng, PEER_ROLE_PUBLISHER);
+    }
+    // Apply subscription changes made while the signaling connection was down.
+    update_subscriptions(eng);
+}
+
+/// Whether the signaling session is resumed and both peers are connected.
+static bool is_resume_complete(engine_t *eng)
+{
+    return eng->is_signal_resumed &&
+        peer_get_state(eng->pub_peer_handle) == CONNECTION_STATE_CONNECTED &&
+        peer_get_state(eng->sub_peer_handle) == CONNECTION_STATE_CONNECTED;
+}
+
+/// Records a completed resume.
+static void resume_end(engine_t *eng)
+{
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    uint32_t elapsed_ms = (uint32_t)(now_ms - eng->resume_start_ms);
+    eng->resume_end_ms = now_ms;
+    livekit_reconnect_stats_t *stats = &eng->reconnect_stats;
+    stats->resumes++;
+    stats->last_resume_ms = elapsed_ms;
+    eng->resume_total_ms += elapsed_ms;
+    stats->avg_resume_ms = (uint32_t)(eng->resume_total_ms / stats->resumes);
+    ESP_LOGI(TAG, "Resume completed in %" PRIu32 "ms", elapsed_ms);
+#if CONFIG_LK_BENCHMARK
+    ESP_LOGI(TAG, "[BENCH] Recovery (resume): last=%" PRIu32 "ms, avg=%" PRIu32 "ms, count=%" PRIu32,
+        elapsed_ms, stats->avg_resume_ms, stats->resumes);
+#endif
+}
+
+static void handle_joined_participant(const livekit_pb_participant_info_t *participant, void *ctx)
+{
+    engine_t *eng = (engine_t *)ctx;
+    update_remote_tracks(eng, participant);
+    if (eng->options.on_participant_info) {
+        eng->options.on_participant_info(participant, false, eng->options.ctx);
+    }
+}
+
 static bool handle_join(engine_t *eng, const livekit_pb_join_response_t *join)
 {
+#if CONFIG_LK_BENCHMARK
+    eng->join_ms = esp_timer_get_time() / 1000;
+#endif
     // 1. Store connection settings
     eng->session.is_subscriber_primary = join->subscriber_primary;
 
@@ -682,13 +2130,12 @@ static bool handle_join(engine_t *eng, const livekit_pb_join_response_t *join)
         eng->options.on_room_info(&join->room, eng->options.ctx);
     }
 
-    // 4. Dispatch initial participant info
+    // 4. Dispatch initial participant info and record tracks that have already
+    //    been published, decoding one remote participant at a time.
     if (eng->options.on_participant_info) {
         eng->options.on_participant_info(&join->participant, true, eng->options.ctx);
-        for (pb_size_t i = 0; i < join->other_participants_count; i++) {
-            eng->options.on_participant_info(&join->other_participants[i], false, eng->options.ctx);
-        }
     }
+    protocol_participants_visit(&join->other_participants, handle_joined_participant, eng);
 
     // 5. Establish peer connections
     if (!establish_peer_connections(eng, join)) {
@@ -697,27 +2144,65 @@ static bool handle_join(engine_t *eng, const livekit_pb_join_response_t *join)
     }
 
     // 6. Subscribe to remote tracks that have already been published.
-    for (pb_size_t i = 0; i < join->other_participants_count; i++) {
-        engine_err_t ret = subscribe_tracks(
-            eng,
-            join->other_participants[i].tracks,
-            join->other_participants[i].tracks_count
-        );
-        if (ret == ENGINE_ERR_MAX_SUB) break;
-    }
+    update_subscriptions(eng);
     return true;
 }
 
-static void handle_trickle(engine_t *eng, const livekit_pb_trickle_request_t *trickle)
+static void handle_trickle(engine_t *eng, livekit_pb_trickle_request_t *trickle)
 {
-    char* candidate = NULL;
+    const char *candidate = NULL;
     if (!protocol_signal_trickle_get_candidate(trickle, &candidate)) {
         return;
     }
-    peer_handle_t target_peer = trickle->target == LIVEKIT_PB_SIGNAL_TARGET_PUBLISHER ?
-        eng->pub_peer_handle : eng->sub_peer_handle;
-    peer_handle_ice_candidate(target_peer, candidate);
-    free(candidate);
+    bool is_publisher = trickle->target == LIVEKIT_PB_SIGNAL_TARGET_PUBLISHER;
+    peer_handle_t target_peer = is_publisher ? eng->pub_peer_handle : eng->sub_peer_handle;
+    pending_candidates_t *pending = is_publisher ? &eng->pub_candidates : &eng->sub_candidates;
+
+    if (target_peer != NULL && pending->has_remote_sdp) {
+        peer_handle_ice_candidate(target_peer, candidate);
+        return;
+    }
+    // Trickle can race the join response and the remote description; keep the
+    // candidate until the peer can apply it instead of dropping it.
+    if (pending->count >= CONFIG_LK_MAX_PENDING_ICE_CANDIDATES) {
+        ESP_LOGW(TAG, "Pending candidate queue full, dropping candidate: target=%d", trickle->target);
+        return;
+    }
+    char *copy = strdup(candidate);
+    if (copy == NULL) {
+        return;
+    }
+    pending->candidates[pending->count++] = copy;
+    ESP_LOGD(TAG, "Queued candidate: target=%d, count=%d", trickle->target, pending->count);
+}
+
+/// Applies a remote description, then delivers the candidates queued for it as one batch.
+static void handle_remote_sdp(peer_handle_t peer, pending_candidates_t *pending, const char *sdp)
+{
+    if (peer == NULL || peer_handle_sdp(peer, sdp) != PEER_ERR_NONE) {
+        return;
+    }
+    pending->has_remote_sdp = true;
+    if (pending->count == 0) {
+        return;
+    }
+    ESP_LOGI(TAG, "Delivering %d queued candidates", pending->count);
+    peer_handle_ice_candidates(peer, (const char *const *)pending->candidates, pending->count);
+    for (uint8_t i = 0; i < pending->count; i++) {
+        SAFE_FREE(pending->candidates[i]);
+    }
+    pending->count = 0;
+}
+
+static void handle_answer(engine_t *eng, const livekit_pb_session_description_t *answer)
+{
+    handle_remote_sdp(eng->pub_peer_handle, &eng->pub_candidates, answer->sdp);
+}
+
+static void handle_offer(engine_t *eng, const livekit_pb_session_description_t *offer)
+{
+    store_sub_sdp(&eng->sub_offer_sdp, offer->sdp);
+    handle_remote_sdp(eng->sub_peer_handle, &eng->sub_candidates, offer->sdp);
 }
 
 static void handle_room_update(engine_t *eng, const livekit_pb_room_update_t *room_update)
@@ -727,25 +2212,45 @@ static void handle_room_update(engine_t *eng, const livekit_pb_room_update_t *ro
     }
 }
 
-static void handle_participant_update(engine_t *eng, const livekit_pb_participant_update_t *update)
+typedef struct {
+    engine_t *eng;
+    bool found_local;
+} participant_update_ctx_t;
+
+static void handle_updated_participant(const livekit_pb_participant_info_t *participant, void *ctx)
 {
-    bool found_local = false;
-    for (pb_size_t i = 0; i < update->participants_count; i++) {
-        const livekit_pb_participant_info_t *participant = &update->participants[i];
-        bool is_local = !found_local && strncmp(
-            participant->sid,
-            eng->session.local_participant_sid,
-            sizeof(eng->session.local_participant_sid)
-        ) == 0;
-        if (is_local) {
-            found_local = true;
-        } else {
-            subscribe_tracks(eng, participant->tracks, participant->tracks_count);
-        }
-        if (eng->options.on_participant_info) {
-            eng->options.on_participant_info(participant, is_local, eng->options.ctx);
+    participant_update_ctx_t *update_ctx = (participant_update_ctx_t *)ctx;
+    engine_t *eng = update_ctx->eng;
+    bool is_local = !update_ctx->found_local && strncmp(
+        participant->sid,
+        eng->session.local_participant_sid,
+        sizeof(eng->session.local_participant_sid)
+    ) == 0;
+    if (is_local) {
+        update_ctx->found_local = true;
+        for (pb_size_t i = 0; i < participant->tracks_count; i++) {
+            const livekit_pb_track_info_t *track = &participant->tracks[i];
+            if (track->type == LIVEKIT_PB_TRACK_TYPE_VIDEO && track->sid != NULL) {
+                strlcpy(eng->session.local_video_sid, track->sid, sizeof(eng->session.local_video_sid));
+                advertise_video_layer(eng);
+                break;
+            }
         }
+    } else {
+        update_remote_tracks(eng, participant);
+    }
+    if (eng->options.on_participant_info) {
+        eng->options.on_participant_info(participant, is_local, eng->options.ctx);
+    }
+}
+
+static void handle_participant_update(engine_t *eng, const livekit_pb_participant_update_t *update)
+{
+    participant_update_ctx_t update_ctx = { .eng = eng };
+    if (!protocol_participants_visit(&update->participants, handle_updated_participant, &update_ctx)) {
+        ESP_LOGW(TAG, "Participant update partially applied");
     }
+    update_subscriptions(eng);
 }
 
 /// Cleans up resources and state from the previous connection.
@@ -754,7 +2259,14 @@ static void cleanup_previous_connection(engine_t *eng)
     media_stream_end(eng);
     signal_close(eng->signal_handle);
     destroy_peer_connections(eng);
+#if CONFIG_LK_JITTER_BUFFER
+    audio_playout_reset(eng);
+#endif
+    video_renderer_reset(eng->video_renderer);
+    clear_remote_tracks(eng);
     memset(&eng->session, 0, sizeof(eng->session));
+    SAFE_FREE(eng->sub_offer_sdp);
+    SAFE_FREE(eng->sub_answer_sdp);
 }
 
 // MARK: - State: Disconnected
@@ -765,13 +2277,18 @@ static bool handle_state_disconnected(engine_t *eng, const engine_event_t *ev)
     switch (ev->type) {
         case _EV_STATE_ENTER:
             cleanup_previous_connection(eng);
+            xTimerStop(eng->idle_timer, 0);
             eng->retry_count = 0;
+            eng->full_reconnect_start_ms = 0;
+            // Buffered packets are only kept across reconnects.
+            reliable_buffer_clear(eng->reliable_buffer);
             break;
         case EV_CMD_CONNECT:
             SAFE_FREE(eng->server_url);
             SAFE_FREE(eng->token);
             eng->server_url = ev->detail.cmd_connect.server_url;
             eng->token = ev->detail.cmd_connect.token;
+            eng->is_standby = ev->detail.cmd_connect.standby;
             eng->failure_reason = LIVEKIT_FAILURE_REASON_NONE;
             eng->state = ENGINE_STATE_CONNECTING;
             return true;
@@ -790,15 +2307,171 @@ static bool handle_state_connecting(engine_t *eng, const engine_event_t *ev)
         case _EV_STATE_ENTER:
             signal_connect(eng->signal_handle, eng->server_url, eng->token);
             break;
-        case EV_CMD_CLOSE:
+        case EV_CMD_CLOSE:
+            signal_send_leave(eng->signal_handle);
+            eng->state = ENGINE_STATE_DISCONNECTED;
+            break;
+        case EV_CMD_CONNECT:
+            ESP_LOGW(TAG, "Engine already connecting, ignoring connect command");
+            break;
+        case EV_CMD_SET_STANDBY:
+            // Applied once connected.
+            eng->is_standby = ev->detail.standby;
+            break;
+        case EV_SIG_RES:
+            livekit_pb_signal_response_t *res = ev->detail.res;
+            switch (res->which_message) {
+                case LIVEKIT_PB_SIGNAL_RESPONSE_LEAVE_TAG:
+                    const livekit_pb_leave_request_t *leave = &res->message.leave;
+                    eng->failure_reason = map_disconnect_reason(leave->reason);
+                    eng->state = ENGINE_STATE_DISCONNECTED;
+                    break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_ROOM_UPDATE_TAG:
+                    const livekit_pb_room_update_t *room_update = &res->message.room_update;
+                    handle_room_update(eng, room_update);
+                    break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_UPDATE_TAG:
+                    const livekit_pb_participant_update_t *update = &res->message.update;
+                    handle_participant_update(eng, update);
+                    break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG:
+                    const livekit_pb_join_response_t *join = &res->message.join;
+                    if (!handle_join(eng, join)) {
+                        eng->state = ENGINE_STATE_BACKOFF;
+                    }
+                    break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_ANSWER_TAG:
+                    handle_answer(eng, &res->message.answer);
+                    break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_OFFER_TAG:
+                    handle_offer(eng, &res->message.offer);
+                    break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_TRICKLE_TAG:
+                    livekit_pb_trickle_request_t *trickle = &res->message.trickle;
+                    handle_trickle(eng, trickle);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case EV_SIG_STATE:
+            signal_state_t sig_state = ev->detail.sig_state;
+            if (sig_state == SIGNAL_STATE_CONNECTED) {
+                send_add_track_requests(eng);
+            } else if(sig_state == SIGNAL_STATE_DISCONNECTED) {
+                eng->failure_reason = LIVEKIT_FAILURE_REASON_OTHER;
+                eng->state = ENGINE_STATE_BACKOFF;
+            } else if (sig_state & SIGNAL_STATE_FAILED_ANY) {
+                eng->failure_reason = map_signal_fail_state(sig_state);
+                eng->state = (sig_state & SIGNAL_STATE_FAILED_CLIENT_ANY) ?
+                    ENGINE_STATE_DISCONNECTED :
+                    ENGINE_STATE_BACKOFF;
+            }
+            break;
+        case EV_PEER_STATE:
+            connection_state_t peer_state = ev->detail.peer_state.state;
+            peer_role_t role = ev->detail.peer_state.role;
+
+            // If either peer fails or disconnects, transition to backoff
+            if (peer_state == CONNECTION_STATE_DISCONNECTED ||
+                peer_state == CONNECTION_STATE_FAILED) {
+                eng->failure_reason = LIVEKIT_FAILURE_REASON_RTC;
+                eng->state = ENGINE_STATE_BACKOFF;
+                break;
+            }
+            // Once the primary peer is connected, transition to connected
+            if (peer_state == CONNECTION_STATE_CONNECTED) {
+                bool is_primary =
+                    (role == PEER_ROLE_PUBLISHER && !eng->session.is_subscriber_primary) ||
+                    (role == PEER_ROLE_SUBSCRIBER && eng->session.is_subscriber_primary);
+#if CONFIG_LK_BENCHMARK
+                // The primary peer closes the critical path from join to connected.
+                ESP_LOGI(TAG, "[BENCH] Join to %s connected in %" PRId64 "ms (peer setup=%" PRIu32 "ms)%s",
+                    role == PEER_ROLE_PUBLISHER ? "publisher" : "subscriber",
+                    esp_timer_get_time() / 1000 - eng->join_ms, eng->peer_setup_ms,
+                    is_primary ? ", critical path" : "");
+#endif
+                if (is_primary) {
+                    eng->state = ENGINE_STATE_CONNECTED;
+                }
+            }
+            break;
+        case EV_PEER_SDP:
+            const char *sdp = ev->detail.peer_sdp.sdp;
+            peer_role_t sdp_role = ev->detail.peer_sdp.role;
+            if (sdp_role == PEER_ROLE_PUBLISHER) {
+                signal_send_offer(eng->signal_handle, sdp);
+            } else {
+                store_sub_sdp(&eng->sub_answer_sdp, sdp);
+                signal_send_answer(eng->signal_handle, sdp);
+            }
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
+// MARK: - State: Connected
+
+/// Handler for `ENGINE_STATE_CONNECTED`.
+static bool handle_state_connected(engine_t *eng, const engine_event_t *ev)
+{
+    switch (ev->type) {
+        case _EV_STATE_ENTER:
+            eng->retry_count = 0;
+            eng->failure_reason = LIVEKIT_FAILURE_REASON_NONE;
+            eng->is_ice_restarting = false;
+            full_reconnect_end(eng);
+            // Already streaming when resumed.
+            media_stream_update(eng);
+            // Layer changes while resuming were not advertised.
+            advertise_video_layer(eng);
+            flush_reliable_buffer(eng);
+            break;
+        case EV_FLUSH_RETRY:
+            // Held until the ICE restart completes.
+            if (!eng->is_ice_restarting) {
+                flush_reliable_buffer(eng);
+            }
+            break;
+        case EV_REQUEST_KEYFRAME:
+            request_video_keyframe(eng);
+            break;
+        case EV_VIDEO_LAYER_CHANGED:
+            advertise_video_layer(eng);
+            break;
+        case EV_CMD_CLOSE:
+            signal_send_leave(eng->signal_handle);
+            eng->state = ENGINE_STATE_DISCONNECTED;
+            break;
+        case EV_CMD_CONNECT:
+            ESP_LOGW(TAG, "Engine already connected, ignoring connect command");
+            break;
+        case EV_CMD_SET_STANDBY:
+            if (eng->is_standby == ev->detail.standby) {
+                break;
+            }
+            eng->is_standby = ev->detail.standby;
+#if CONFIG_LK_BENCHMARK
+            eng->activate_ms = eng->is_standby ? 0 : esp_timer_get_time() / 1000;
+#endif
+            media_stream_update(eng);
+            break;
+        case EV_STANDBY_IDLE:
+            // Ignore a timeout that raced with activation or a restart of the timer.
+            if (!eng->is_standby || xTimerIsTimerActive(eng->idle_timer) != pdFALSE) {
+                break;
+            }
+            ESP_LOGI(TAG, "Standby idle timeout, disconnecting");
             signal_send_leave(eng->signal_handle);
             eng->state = ENGINE_STATE_DISCONNECTED;
             break;
-        case EV_CMD_CONNECT:
-            ESP_LOGW(TAG, "Engine already connecting, ignoring connect command");
+        case EV_CMD_UPDATE_SUBS:
+            update_subscriptions(eng);
             break;
         case EV_SIG_RES:
-            const livekit_pb_signal_response_t *res = &ev->detail.res;
+            livekit_pb_signal_response_t *res = ev->detail.res;
             switch (res->which_message) {
                 case LIVEKIT_PB_SIGNAL_RESPONSE_LEAVE_TAG:
                     const livekit_pb_leave_request_t *leave = &res->message.leave;
@@ -813,33 +2486,27 @@ static bool handle_state_connecting(engine_t *eng, const engine_event_t *ev)
                     const livekit_pb_participant_update_t *update = &res->message.update;
                     handle_participant_update(eng, update);
                     break;
-                case LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG:
-                    const livekit_pb_join_response_t *join = &res->message.join;
-                    if (!handle_join(eng, join)) {
-                        eng->state = ENGINE_STATE_BACKOFF;
-                    }
-                    break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_ANSWER_TAG:
-                    const livekit_pb_session_description_t *answer = &res->message.answer;
-                    peer_handle_sdp(eng->pub_peer_handle, answer->sdp);
+                    handle_answer(eng, &res->message.answer);
                     break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_OFFER_TAG:
-                    const livekit_pb_session_description_t *offer = &res->message.offer;
-                    peer_handle_sdp(eng->sub_peer_handle, offer->sdp);
+                    handle_offer(eng, &res->message.offer);
                     break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_TRICKLE_TAG:
-                    const livekit_pb_trickle_request_t *trickle = &res->message.trickle;
+                    livekit_pb_trickle_request_t *trickle = &res->message.trickle;
                     handle_trickle(eng, trickle);
                     break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_SUBSCRIBED_QUALITY_UPDATE_TAG:
+                    const livekit_pb_subscribed_quality_update_t *quality_update = &res->message.subscribed_quality_update;
+                    handle_subscribed_quality_update(eng, quality_update);
+                    break;
                 default:
                     break;
             }
             break;
         case EV_SIG_STATE:
             signal_state_t sig_state = ev->detail.sig_state;
-            if (sig_state == SIGNAL_STATE_CONNECTED) {
-                send_add_track_requests(eng);
-            } else if(sig_state == SIGNAL_STATE_DISCONNECTED) {
+            if (sig_state == SIGNAL_STATE_DISCONNECTED) {
                 eng->failure_reason = LIVEKIT_FAILURE_REASON_OTHER;
                 eng->state = ENGINE_STATE_BACKOFF;
             } else if (sig_state & SIGNAL_STATE_FAILED_ANY) {
@@ -848,51 +2515,100 @@ static bool handle_state_connecting(engine_t *eng, const engine_event_t *ev)
                     ENGINE_STATE_DISCONNECTED :
                     ENGINE_STATE_BACKOFF;
             }
+            if (eng->state == ENGINE_STATE_BACKOFF && can_resume(eng)) {
+                // The peers do not depend on the signaling connection.
+                eng->resume_reason = LIVEKIT_PB_RECONNECT_REASON_RR_SIGNAL_DISCONNECTED;
+                eng->state = ENGINE_STATE_RESUMING;
+            }
             break;
         case EV_PEER_STATE:
             connection_state_t peer_state = ev->detail.peer_state.state;
             peer_role_t role = ev->detail.peer_state.role;
 
-            // If either peer fails or disconnects, transition to backoff
+            bool is_restarting_peer = eng->is_ice_restarting && role == PEER_ROLE_PUBLISHER;
+            if (is_restarting_peer) {
+                if (peer_state == CONNECTION_STATE_CONNECTED) {
+                    ice_restart_end(eng);
+                } else if (peer_state == CONNECTION_STATE_FAILED) {
+                    ESP_LOGE(TAG, "ICE restart failed, reconnecting");
+                    ice_restart_abort(eng);
+                    eng->failure_reason = LIVEKIT_FAILURE_REASON_RTC;
+                    eng->state = ENGINE_STATE_BACKOFF;
+                }
+                // Disconnects while the old transport is torn down are expected.
+                break;
+            }
+            // If either peer fails or disconnects, try an ICE restart on it first
+            // and fall back to a full reconnect.
             if (peer_state == CONNECTION_STATE_DISCONNECTED ||
                 peer_state == CONNECTION_STATE_FAILED) {
+                ESP_LOGE(TAG, "%s peer connection failed",
+                    role == PEER_ROLE_PUBLISHER ? "Publisher" : "Subscriber");
+                if (ice_restart_begin(eng, role)) {
+                    break;
+                }
                 eng->failure_reason = LIVEKIT_FAILURE_REASON_RTC;
-                eng->state = ENGINE_STATE_BACKOFF;
-                break;
-            }
-            // Once the primary peer is connected, transition to connected
-            if (peer_state == CONNECTION_STATE_CONNECTED) {
-                if ((role == PEER_ROLE_PUBLISHER && !eng->session.is_subscriber_primary) ||
-                    (role == PEER_ROLE_SUBSCRIBER && eng->session.is_subscriber_primary)) {
-                    eng->state = ENGINE_STATE_CONNECTED;
+                if (can_resume(eng)) {
+                    eng->resume_reason = role == PEER_ROLE_PUBLISHER ?
+                        LIVEKIT_PB_RECONNECT_REASON_RR_PUBLISHER_FAILED :
+                        LIVEKIT_PB_RECONNECT_REASON_RR_SUBSCRIBER_FAILED;
+                    eng->state = ENGINE_STATE_RESUMING;
+                    break;
                 }
+                eng->state = ENGINE_STATE_BACKOFF;
             }
             break;
         case EV_PEER_SDP:
             const char *sdp = ev->detail.peer_sdp.sdp;
             peer_role_t sdp_role = ev->detail.peer_sdp.role;
             if (sdp_role == PEER_ROLE_PUBLISHER) {
+                if (!eng->is_ice_restarting) {
+                    ESP_LOGW(TAG, "Unexpected SDP from publisher");
+                    break;
+                }
                 signal_send_offer(eng->signal_handle, sdp);
-            } else {
-                signal_send_answer(eng->signal_handle, sdp);
+                break;
             }
+            store_sub_sdp(&eng->sub_answer_sdp, sdp);
+            signal_send_answer(eng->signal_handle, sdp);
+            break;
+        case EV_TIMER_EXP:
+            if (!eng->is_ice_restarting) {
+                break;
+            }
+            ESP_LOGE(TAG, "ICE restart timed out, reconnecting");
+            ice_restart_abort(eng);
+            eng->failure_reason = LIVEKIT_FAILURE_REASON_RTC;
+            eng->state = ENGINE_STATE_BACKOFF;
             break;
         default:
             break;
     }
+    if (eng->state == ENGINE_STATE_BACKOFF ||
+        eng->state == ENGINE_STATE_RESUMING) {
+        if (eng->is_ice_restarting) {
+            // Lost for another reason, e.g. signaling, during the restart.
+            ice_restart_abort(eng);
+        }
+        // Timed until connected again.
+        int64_t now_ms = esp_timer_get_time() / 1000;
+        if (eng->state == ENGINE_STATE_BACKOFF) {
+            eng->full_reconnect_start_ms = now_ms;
+        } else {
+            eng->resume_start_ms = now_ms;
+        }
+    }
     return false;
 }
 
-// MARK: - State: Connected
+// MARK: - State: Resuming
 
-/// Handler for `ENGINE_STATE_CONNECTED`.
-static bool handle_state_connected(engine_t *eng, const engine_event_t *ev)
+/// Handler for `ENGINE_STATE_RESUMING`.
+static bool handle_state_resuming(engine_t *eng, const engine_event_t *ev)
 {
     switch (ev->type) {
         case _EV_STATE_ENTER:
-            eng->retry_count = 0;
-            eng->failure_reason = LIVEKIT_FAILURE_REASON_NONE;
-            media_stream_begin(eng);
+            resume_begin(eng);
             break;
         case EV_CMD_CLOSE:
             signal_send_leave(eng->signal_handle);
@@ -901,13 +2617,29 @@ static bool handle_state_connected(engine_t *eng, const engine_event_t *ev)
         case EV_CMD_CONNECT:
             ESP_LOGW(TAG, "Engine already connected, ignoring connect command");
             break;
+        case EV_CMD_SET_STANDBY:
+            // Applied once resumed.
+            eng->is_standby = ev->detail.standby;
+            break;
+        case EV_CMD_UPDATE_SUBS:
+            // Otherwise applied once resumed.
+            if (eng->is_signal_resumed) {
+                update_subscriptions(eng);
+            }
+            break;
         case EV_SIG_RES:
-            const livekit_pb_signal_response_t *res = &ev->detail.res;
+            livekit_pb_signal_response_t *res = ev->detail.res;
             switch (res->which_message) {
+                case LIVEKIT_PB_SIGNAL_RESPONSE_RECONNECT_TAG:
+                    handle_reconnect(eng, &res->message.reconnect);
+                    break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_LEAVE_TAG:
+                    // Sent instead of `ReconnectResponse` if the session cannot be resumed.
                     const livekit_pb_leave_request_t *leave = &res->message.leave;
                     eng->failure_reason = map_disconnect_reason(leave->reason);
-                    eng->state = ENGINE_STATE_DISCONNECTED;
+                    eng->state = leave->action == LIVEKIT_PB_LEAVE_REQUEST_ACTION_DISCONNECT ?
+                        ENGINE_STATE_DISCONNECTED :
+                        ENGINE_STATE_BACKOFF;
                     break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_ROOM_UPDATE_TAG:
                     const livekit_pb_room_update_t *room_update = &res->message.room_update;
@@ -918,58 +2650,79 @@ static bool handle_state_connected(engine_t *eng, const engine_event_t *ev)
                     handle_participant_update(eng, update);
                     break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_ANSWER_TAG:
-                    const livekit_pb_session_description_t *answer = &res->message.answer;
-                    peer_handle_sdp(eng->pub_peer_handle, answer->sdp);
+                    handle_answer(eng, &res->message.answer);
                     break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_OFFER_TAG:
-                    const livekit_pb_session_description_t *offer = &res->message.offer;
-                    peer_handle_sdp(eng->sub_peer_handle, offer->sdp);
+                    handle_offer(eng, &res->message.offer);
                     break;
                 case LIVEKIT_PB_SIGNAL_RESPONSE_TRICKLE_TAG:
-                    const livekit_pb_trickle_request_t *trickle = &res->message.trickle;
+                    livekit_pb_trickle_request_t *trickle = &res->message.trickle;
                     handle_trickle(eng, trickle);
                     break;
+                case LIVEKIT_PB_SIGNAL_RESPONSE_SUBSCRIBED_QUALITY_UPDATE_TAG:
+                    const livekit_pb_subscribed_quality_update_t *quality_update = &res->message.subscribed_quality_update;
+                    handle_subscribed_quality_update(eng, quality_update);
+                    break;
                 default:
                     break;
             }
+            if (eng->state == ENGINE_STATE_RESUMING && is_resume_complete(eng)) {
+                eng->state = ENGINE_STATE_CONNECTED;
+            }
             break;
         case EV_SIG_STATE:
             signal_state_t sig_state = ev->detail.sig_state;
-            if (sig_state == SIGNAL_STATE_DISCONNECTED) {
-                eng->failure_reason = LIVEKIT_FAILURE_REASON_OTHER;
-                eng->state = ENGINE_STATE_BACKOFF;
+            if (sig_state == SIGNAL_STATE_CONNECTED) {
+                eng->is_resume_signal_connected = true;
+            } else if (sig_state == SIGNAL_STATE_DISCONNECTED) {
+                // Closing the previous connection may report a disconnect after the
+                // resume has started; only a disconnect of the new connection counts.
+                if (eng->is_resume_signal_connected) {
+                    eng->failure_reason = LIVEKIT_FAILURE_REASON_OTHER;
+                    eng->state = ENGINE_STATE_BACKOFF;
+                }
             } else if (sig_state & SIGNAL_STATE_FAILED_ANY) {
+                // Retry as a new participant, which also covers rejected resumes.
                 eng->failure_reason = map_signal_fail_state(sig_state);
-                eng->state = (sig_state & SIGNAL_STATE_FAILED_CLIENT_ANY) ?
-                    ENGINE_STATE_DISCONNECTED :
-                    ENGINE_STATE_BACKOFF;
+                eng->state = ENGINE_STATE_BACKOFF;
             }
             break;
         case EV_PEER_STATE:
-            connection_state_t peer_state = ev->detail.peer_state.state;
-            peer_role_t role = ev->detail.peer_state.role;
-
-            // If either peer fail or disconnects, transition to backoff
-            if (peer_state == CONNECTION_STATE_DISCONNECTED ||
-                peer_state == CONNECTION_STATE_FAILED) {
-                ESP_LOGE(TAG, "%s peer connection failed",
-                    role == PEER_ROLE_PUBLISHER ? "Publisher" : "Subscriber");
-                eng->failure_reason = LIVEKIT_FAILURE_REASON_RTC;
-                eng->state = ENGINE_STATE_BACKOFF;
+            if (ev->detail.peer_state.state == CONNECTION_STATE_CONNECTED &&
+                is_resume_complete(eng)) {
+                eng->state = ENGINE_STATE_CONNECTED;
             }
+            // Failures are left to the timeout; the restarted transports may
+            // briefly report them while being torn down.
             break;
         case EV_PEER_SDP:
             const char *sdp = ev->detail.peer_sdp.sdp;
             peer_role_t sdp_role = ev->detail.peer_sdp.role;
-            if (sdp_role != PEER_ROLE_SUBSCRIBER) {
-                ESP_LOGW(TAG, "Unexpected SDP from publisher");
-                break;
+            if (sdp_role == PEER_ROLE_PUBLISHER) {
+                signal_send_offer(eng->signal_handle, sdp);
+            } else {
+                store_sub_sdp(&eng->sub_answer_sdp, sdp);
+                signal_send_answer(eng->signal_handle, sdp);
             }
-            signal_send_answer(eng->signal_handle, sdp);
+            break;
+        case EV_TIMER_EXP:
+            ESP_LOGE(TAG, "Resume timed out, reconnecting");
+            eng->failure_reason = LIVEKIT_FAILURE_REASON_RTC;
+            eng->state = ENGINE_STATE_BACKOFF;
             break;
         default:
             break;
     }
+    if (eng->state != ENGINE_STATE_RESUMING) {
+        timer_stop(eng);
+        if (eng->state == ENGINE_STATE_CONNECTED) {
+            resume_end(eng);
+        } else if (eng->state == ENGINE_STATE_BACKOFF) {
+            eng->reconnect_stats.resume_failures++;
+            // Keep timing from when the connection was lost.
+            eng->full_reconnect_start_ms = eng->resume_start_ms;
+        }
+    }
     return false;
 }
 
@@ -994,6 +2747,10 @@ static bool handle_state_backoff(engine_t *eng, const engine_event_t *ev)
 
             timer_start(eng, backoff_ms);
             break;
+        case EV_CMD_SET_STANDBY:
+            // Applied once reconnected.
+            eng->is_standby = ev->detail.standby;
+            break;
         case EV_MAX_RETRIES_REACHED:
             eng->failure_reason = LIVEKIT_FAILURE_REASON_MAX_RETRIES;
             eng->state = ENGINE_STATE_DISCONNECTED;
@@ -1017,6 +2774,7 @@ static inline bool handle_state(engine_t *eng, engine_event_t *ev, engine_state_
         case ENGINE_STATE_DISCONNECTED: return handle_state_disconnected(eng, ev);
         case ENGINE_STATE_CONNECTING:   return handle_state_connecting(eng, ev);
         case ENGINE_STATE_CONNECTED:    return handle_state_connected(eng, ev);
+        case ENGINE_STATE_RESUMING:     return handle_state_resuming(eng, ev);
         case ENGINE_STATE_BACKOFF:      return handle_state_backoff(eng, ev);
         default:                        esp_system_abort("Unknown engine state");
     }
@@ -1044,7 +2802,7 @@ static void engine_task(void *arg)
         // and is responsible for freeing it, otherwise, it will be freed after the handler
         // returns.
         if (!handle_state(eng, &ev, state)) {
-            event_free(&ev);
+            event_free(eng, &ev);
         }
 
         // If the state changed, invoke the exit handler for the old state,
@@ -1052,6 +2810,7 @@ static void engine_task(void *arg)
         if (eng->state != state) {
             ESP_LOGD(TAG, "State changed: %d -> %d", state, eng->state);
 
+            update_data_state(eng);
             state = eng->state;
             handle_state(eng, &(engine_event_t){ .type = _EV_STATE_EXIT }, state);
             assert(eng->state == state);
@@ -1077,8 +2836,77 @@ static void engine_task(void *arg)
     vTaskDelete(NULL);
 }
 
+static engine_err_t setup_capture_path(
+    engine_t *eng,
+    uint8_t index,
+    esp_capture_sink_cfg_t *sink_cfg,
+    esp_capture_run_mode_t run_mode,
+    esp_capture_sink_handle_t *path)
+{
+    if (esp_capture_sink_setup(
+        eng->options.media.capturer,
+        index,
+        sink_cfg,
+        path
+    ) != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGE(TAG, "Capture sink setup failed: path=%d", index);
+        return ENGINE_ERR_MEDIA;
+    }
+
+    // TODO: Add muxer
+
+    if (esp_capture_sink_enable(*path, run_mode) != ESP_CAPTURE_ERR_OK) {
+        ESP_LOGE(TAG, "Capture sink enable failed: path=%d", index);
+        return ENGINE_ERR_MEDIA;
+    }
+    return ENGINE_ERR_NONE;
+}
+
+/// Sets up a capture sink path for each published video layer, starting at `first_index`.
+///
+/// Layers are encoded on separate paths from audio so each can be paused, stopping
+/// its encoder, without stopping audio or the other layers. Only the top layer is
+/// encoded until another one is selected.
+///
+static engine_err_t enable_video_layer_paths(engine_t *eng, uint8_t first_index)
+{
+    esp_capture_sink_cfg_t layer_cfg = {
+        .video_info = {
+            .format_id = capture_video_codec_type(eng->options.media.video_info.codec),
+            .fps = (uint8_t)eng->options.media.video_info.fps,
+        },
+    };
+    for (uint8_t i = 0; i < eng->video_layer_count; i++) {
+        video_layer_size(eng, i, &layer_cfg.video_info.width, &layer_cfg.video_info.height);
+        if (setup_capture_path(
+            eng,
+            (uint8_t)(first_index + i),
+            &layer_cfg,
+            i == 0 ? ESP_CAPTURE_RUN_MODE_ALWAYS : ESP_CAPTURE_RUN_MODE_DISABLE,
+            &eng->video_paths[i]
+        ) != ENGINE_ERR_NONE) {
+            return ENGINE_ERR_MEDIA;
+        }
+        ESP_LOGI(TAG, "Video layer %d: %dx%d", i, layer_cfg.video_info.width, layer_cfg.video_info.height);
+    }
+    return ENGINE_ERR_NONE;
+}
+
+/// Sets up capture sink paths for published media.
+///
+/// A single video layer shares path 0 with audio. With more layers, path 0 carries
+/// audio only and each layer gets its own path after it.
+///
 static engine_err_t enable_capture_sink(engine_t *eng)
 {
+    bool has_audio = eng->options.media.audio_info.codec != ESP_PEER_AUDIO_CODEC_NONE;
+    bool is_layered = CONFIG_LK_PUB_VIDEO_LAYERS > 1 &&
+        eng->options.media.video_info.codec != ESP_PEER_VIDEO_CODEC_NONE;
+    eng->video_layer_count = is_layered ? CONFIG_LK_PUB_VIDEO_LAYERS : 1;
+    eng->is_video_path_shared = !is_layered && has_audio;
+    eng->active_video_layer = 0;
+    eng->requested_video_layer = 0;
+
     esp_capture_sink_cfg_t sink_cfg = {
         .audio_info = {
             .format_id = capture_audio_codec_type(eng->options.media.audio_info.codec),
@@ -1087,33 +2915,28 @@ static engine_err_t enable_capture_sink(engine_t *eng)
             .bits_per_sample = 16,
         },
         .video_info = {
-            .format_id = ESP_CAPTURE_FMT_ID_H264,
+            .format_id = capture_video_codec_type(eng->options.media.video_info.codec),
             .width = (uint16_t)eng->options.media.video_info.width,
             .height = (uint16_t)eng->options.media.video_info.height,
             .fps = (uint8_t)eng->options.media.video_info.fps,
         },
     };
-
-    if (esp_capture_sink_setup(
-        eng->options.media.capturer,
-        0, // Path index
-        &sink_cfg,
-        &eng->capturer_path
-    ) != ESP_CAPTURE_ERR_OK) {
-        ESP_LOGE(TAG, "Capture sink setup failed");
-        return ENGINE_ERR_MEDIA;
+    if (!is_layered) {
+        if (setup_capture_path(eng, 0, &sink_cfg, ESP_CAPTURE_RUN_MODE_ALWAYS, &eng->capturer_path) != ENGINE_ERR_NONE) {
+            return ENGINE_ERR_MEDIA;
+        }
+        eng->video_paths[0] = eng->capturer_path;
+        return ENGINE_ERR_NONE;
     }
-
-    // TODO: Add muxer
-
-    if (esp_capture_sink_enable(
-        eng->capturer_path,
-        ESP_CAPTURE_RUN_MODE_ALWAYS
-    ) != ESP_CAPTURE_ERR_OK) {
-        ESP_LOGE(TAG, "Capture sink enable failed");
+    if (!has_audio) {
+        return enable_video_layer_paths(eng, 0);
+    }
+    // Path 0 carries audio only when video is layered.
+    sink_cfg.video_info.format_id = ESP_CAPTURE_FMT_ID_NONE;
+    if (setup_capture_path(eng, 0, &sink_cfg, ESP_CAPTURE_RUN_MODE_ALWAYS, &eng->capturer_path) != ENGINE_ERR_NONE) {
         return ENGINE_ERR_MEDIA;
     }
-    return ENGINE_ERR_NONE;
+    return enable_video_layer_paths(eng, 1);
 }
 
 // MARK: - Public API
@@ -1135,6 +2958,15 @@ engine_handle_t engine_init(const engine_options_t *options)
     if (eng->event_queue == NULL) {
         goto _init_failed;
     }
+    eng->sig_res_pool = calloc(SIGNAL_RES_POOL_SIZE, sizeof(livekit_pb_signal_response_t));
+    eng->sig_res_free = xQueueCreate(SIGNAL_RES_POOL_SIZE, sizeof(livekit_pb_signal_response_t *));
+    if (eng->sig_res_pool == NULL || eng->sig_res_free == NULL) {
+        goto _init_failed;
+    }
+    for (size_t i = 0; i < SIGNAL_RES_POOL_SIZE; i++) {
+        livekit_pb_signal_response_t *res = &eng->sig_res_pool[i];
+        xQueueSend(eng->sig_res_free, &res, 0);
+    }
 
     // Created before the task so the task can always signal completion on exit.
     eng->task_done_sem = xSemaphoreCreateBinary();
@@ -1142,6 +2974,54 @@ engine_handle_t engine_init(const engine_options_t *options)
         goto _init_failed;
     }
 
+    eng->reliable_buffer = reliable_buffer_create(options->data_buffer_policy);
+    eng->reliable_encoder = protocol_encoder_create();
+    eng->data_mutex = xSemaphoreCreateMutex();
+    if (eng->reliable_buffer == NULL || eng->reliable_encoder == NULL || eng->data_mutex == NULL) {
+        goto _init_failed;
+    }
+
+    eng->data_dispatch = data_dispatch_create(on_dispatch_data_packet, eng);
+    if (eng->data_dispatch == NULL) {
+        goto _init_failed;
+    }
+
+#if CONFIG_LK_JITTER_BUFFER
+    if ((options->media.audio_dir & ESP_PEER_MEDIA_DIR_RECV_ONLY) &&
+        audio_playout_begin(eng) != ENGINE_ERR_NONE) {
+        goto _init_failed;
+    }
+#endif
+    if (options->media.video_dir & ESP_PEER_MEDIA_DIR_RECV_ONLY) {
+        eng->video_renderer = video_renderer_create(options->media.renderer, on_video_keyframe_needed, eng);
+        if (eng->video_renderer == NULL) {
+            goto _init_failed;
+        }
+    }
+#if CONFIG_LK_BITRATE_CONTROL
+    if (bitrate_control_begin(eng) != ENGINE_ERR_NONE) {
+        goto _init_failed;
+    }
+#endif
+#if CONFIG_LK_AUDIO_DTX
+    if (options->media.audio_info.codec != ESP_PEER_AUDIO_CODEC_NONE) {
+        voice_activity_config_t vad_config = {
+            .threshold_db = CONFIG_LK_AUDIO_DTX_THRESHOLD_DB,
+            .hangover_ms = CONFIG_LK_AUDIO_DTX_HANGOVER_MS,
+        };
+        eng->voice_activity = voice_activity_create(&vad_config);
+        if (eng->voice_activity == NULL) {
+            goto _init_failed;
+        }
+    }
+#endif
+
+    // Signaled by each media publish task (audio, video) on exit.
+    eng->stream_done_sem = xSemaphoreCreateCounting(2, 0);
+    if (eng->stream_done_sem == NULL) {
+        goto _init_failed;
+    }
+
     if (xTaskCreate(
         engine_task,
         "engine_task",
@@ -1163,10 +3043,32 @@ engine_handle_t engine_init(const engine_options_t *options)
     if (eng->timer == NULL) {
         goto _init_failed;
     }
+    eng->idle_timer = xTimerCreate(
+        "lk_idle_timer",
+        pdMS_TO_TICKS(CONFIG_LK_STANDBY_IDLE_TIMEOUT_S > 0 ? CONFIG_LK_STANDBY_IDLE_TIMEOUT_S * 1000 : 1000),
+        pdFALSE,
+        (void *)eng,
+        on_idle_timer_expired
+    );
+    if (eng->idle_timer == NULL) {
+        goto _init_failed;
+    }
+    eng->flush_timer = xTimerCreate(
+        "lk_flush_timer",
+        pdMS_TO_TICKS(RELIABLE_FLUSH_RETRY_MS),
+        pdFALSE,
+        (void *)eng,
+        on_flush_timer_expired
+    );
+    if (eng->flush_timer == NULL) {
+        goto _init_failed;
+    }
 
     signal_options_t signal_options = {
         .ctx = eng,
         .on_state_changed = on_signal_state_changed,
+        .alloc_res = on_signal_res_alloc,
+        .free_res = on_signal_res_free,
         .on_res = on_signal_res,
     };
     eng->signal_handle = signal_init(&signal_options);
@@ -1214,8 +3116,20 @@ engine_err_t engine_destroy(engine_handle_t handle)
         xTimerDelete(eng->timer, portMAX_DELAY);
         eng->timer = NULL;
     }
+    if (eng->idle_timer != NULL) {
+        xTimerDelete(eng->idle_timer, portMAX_DELAY);
+        eng->idle_timer = NULL;
+    }
+    if (eng->flush_timer != NULL) {
+        xTimerDelete(eng->flush_timer, portMAX_DELAY);
+        eng->flush_timer = NULL;
+    }
 
     media_stream_end(eng);
+    if (eng->stream_done_sem != NULL) {
+        vSemaphoreDelete(eng->stream_done_sem);
+        eng->stream_done_sem = NULL;
+    }
 
     if (eng->signal_handle != NULL) {
         signal_destroy(eng->signal_handle);
@@ -1229,19 +3143,50 @@ engine_err_t engine_destroy(engine_handle_t handle)
         peer_destroy(eng->sub_peer_handle);
         eng->sub_peer_handle = NULL;
     }
+    // Destroyed after the peers so no packets are enqueued during shutdown.
+    data_dispatch_destroy(eng->data_dispatch);
+    eng->data_dispatch = NULL;
+#if CONFIG_LK_JITTER_BUFFER
+    audio_playout_end(eng);
+#endif
+    video_renderer_destroy(eng->video_renderer);
+    eng->video_renderer = NULL;
+#if CONFIG_LK_BITRATE_CONTROL
+    bitrate_control_end(eng);
+#endif
+#if CONFIG_LK_AUDIO_DTX
+    voice_activity_destroy(eng->voice_activity);
+    eng->voice_activity = NULL;
+#endif
 
     if (eng->event_queue != NULL) {
+        event_queue_report(eng);
         flush_event_queue(eng);
         vQueueDelete(eng->event_queue);
         eng->event_queue = NULL;
     }
+    if (eng->sig_res_free != NULL) {
+        vQueueDelete(eng->sig_res_free);
+        eng->sig_res_free = NULL;
+    }
+    SAFE_FREE(eng->sig_res_pool);
+    clear_remote_tracks(eng);
+    pending_candidates_clear(&eng->pub_candidates);
+    pending_candidates_clear(&eng->sub_candidates);
+    SAFE_FREE(eng->sub_offer_sdp);
+    SAFE_FREE(eng->sub_answer_sdp);
+    reliable_buffer_destroy(eng->reliable_buffer);
+    protocol_encoder_destroy(eng->reliable_encoder);
+    if (eng->data_mutex != NULL) {
+        vSemaphoreDelete(eng->data_mutex);
+    }
     SAFE_FREE(eng->server_url);
     SAFE_FREE(eng->token);
     free(eng);
     return ENGINE_ERR_NONE;
 }
 
-engine_err_t engine_connect(engine_handle_t handle, const char* server_url, const char* token)
+engine_err_t engine_connect(engine_handle_t handle, const char* server_url, const char* token, bool standby)
 {
     if (handle == NULL || server_url == NULL || token == NULL) {
         return ENGINE_ERR_INVALID_ARG;
@@ -1250,10 +3195,14 @@ engine_err_t engine_connect(engine_handle_t handle, const char* server_url, cons
 
     engine_event_t ev = {
         .type = EV_CMD_CONNECT,
-        .detail.cmd_connect = { .server_url = strdup(server_url), .token = strdup(token) }
+        .detail.cmd_connect = {
+            .server_url = strdup(server_url),
+            .token = strdup(token),
+            .standby = standby
+        }
     };
     if (!event_enqueue(eng, &ev, true)) {
-        event_free(&ev);
+        event_free(eng, &ev);
         return ENGINE_ERR_OTHER;
     }
     return ENGINE_ERR_NONE;
@@ -1273,6 +3222,37 @@ engine_err_t engine_close(engine_handle_t handle)
     return ENGINE_ERR_NONE;
 }
 
+engine_err_t engine_set_standby(engine_handle_t handle, bool standby)
+{
+    if (handle == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+    engine_t *eng = (engine_t *)handle;
+
+    engine_event_t ev = {
+        .type = EV_CMD_SET_STANDBY,
+        .detail.standby = standby
+    };
+    if (!event_enqueue(eng, &ev, false)) {
+        return ENGINE_ERR_OTHER;
+    }
+    return ENGINE_ERR_NONE;
+}
+
+engine_err_t engine_update_subscriptions(engine_handle_t handle)
+{
+    if (handle == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+    engine_t *eng = (engine_t *)handle;
+
+    engine_event_t ev = { .type = EV_CMD_UPDATE_SUBS };
+    if (!event_enqueue(eng, &ev, false)) {
+        return ENGINE_ERR_OTHER;
+    }
+    return ENGINE_ERR_NONE;
+}
+
 livekit_failure_reason_t engine_get_failure_reason(engine_handle_t handle)
 {
     if (handle == NULL) {
@@ -1288,13 +3268,134 @@ engine_err_t engine_send_data_packet(engine_handle_t handle, const livekit_pb_da
         return ENGINE_ERR_INVALID_ARG;
     }
     engine_t *eng = (engine_t *)handle;
-    // TODO: Implement buffering for reliable packets
-    if (eng->state != ENGINE_STATE_CONNECTED) {
+    xSemaphoreTake(eng->data_mutex, portMAX_DELAY);
+    engine_state_t state = eng->data_state;
+    if (state == ENGINE_STATE_DISCONNECTED) {
+        xSemaphoreGive(eng->data_mutex);
         return ENGINE_ERR_OTHER;
     }
-    if (eng->pub_peer_handle == NULL ||
-        peer_send_data_packet(eng->pub_peer_handle, packet, reliable) != PEER_ERR_NONE) {
-        return ENGINE_ERR_RTC;
+    if (!reliable || eng->is_data_ready) {
+        engine_err_t ret = ENGINE_ERR_NONE;
+        if (state != ENGINE_STATE_CONNECTED) {
+            ret = ENGINE_ERR_OTHER;
+        } else if (eng->pub_peer_handle == NULL ||
+            peer_send_data_packet(eng->pub_peer_handle, packet, reliable) != PEER_ERR_NONE) {
+            ret = ENGINE_ERR_RTC;
+        }
+        xSemaphoreGive(eng->data_mutex);
+        return ret;
+    }
+    xSemaphoreGive(eng->data_mutex);
+
+    // Queue behind any packets still waiting so ordering is preserved. Buffering
+    // may block under the block policy, so it is done without holding the lock.
+    engine_err_t ret = buffer_reliable_packet(eng, packet);
+    if (ret != ENGINE_ERR_NONE) {
+        return ret;
+    }
+    // Data may have started flowing while the packet was buffered.
+    xSemaphoreTake(eng->data_mutex, portMAX_DELAY);
+    if (eng->is_data_ready) {
+        flush_reliable_locked(eng);
+    }
+    xSemaphoreGive(eng->data_mutex);
+    return ENGINE_ERR_NONE;
+}
+
+engine_err_t engine_get_data_buffer_stats(engine_handle_t handle, livekit_data_buffer_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+    engine_t *eng = (engine_t *)handle;
+    reliable_buffer_get_stats(eng->reliable_buffer, stats);
+    return ENGINE_ERR_NONE;
+}
+
+engine_err_t engine_get_data_dispatch_stats(engine_handle_t handle, livekit_data_dispatch_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+    engine_t *eng = (engine_t *)handle;
+    data_dispatch_get_stats(eng->data_dispatch, stats);
+    return ENGINE_ERR_NONE;
+}
+
+engine_err_t engine_get_audio_jitter_stats(engine_handle_t handle, livekit_audio_jitter_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+#if CONFIG_LK_JITTER_BUFFER
+    engine_t *eng = (engine_t *)handle;
+    if (eng->jitter_buffer == NULL) {
+        return ENGINE_ERR_MEDIA;
+    }
+    xSemaphoreTake(eng->jitter_mutex, portMAX_DELAY);
+    jitter_buffer_get_stats(eng->jitter_buffer, stats);
+    xSemaphoreGive(eng->jitter_mutex);
+    return ENGINE_ERR_NONE;
+#else
+    return ENGINE_ERR_MEDIA;
+#endif
+}
+
+engine_err_t engine_get_video_render_stats(engine_handle_t handle, livekit_video_render_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+    engine_t *eng = (engine_t *)handle;
+    if (eng->video_renderer == NULL) {
+        return ENGINE_ERR_MEDIA;
+    }
+    video_renderer_get_stats(eng->video_renderer, stats);
+    return ENGINE_ERR_NONE;
+}
+
+engine_err_t engine_get_publish_bitrate_stats(engine_handle_t handle, livekit_bitrate_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+#if CONFIG_LK_BITRATE_CONTROL
+    engine_t *eng = (engine_t *)handle;
+    if (eng->bitrate_controller == NULL) {
+        return ENGINE_ERR_MEDIA;
+    }
+    xSemaphoreTake(eng->bitrate_mutex, portMAX_DELAY);
+    bitrate_controller_get_stats(eng->bitrate_controller, stats);
+    xSemaphoreGive(eng->bitrate_mutex);
+    return ENGINE_ERR_NONE;
+#else
+    return ENGINE_ERR_MEDIA;
+#endif
+}
+
+engine_err_t engine_get_audio_dtx_stats(engine_handle_t handle, livekit_audio_dtx_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
+    }
+#if CONFIG_LK_AUDIO_DTX
+    engine_t *eng = (engine_t *)handle;
+    if (eng->voice_activity == NULL) {
+        return ENGINE_ERR_MEDIA;
+    }
+    voice_activity_get_stats(eng->voice_activity, stats);
+    return ENGINE_ERR_NONE;
+#else
+    return ENGINE_ERR_MEDIA;
+#endif
+}
+
+engine_err_t engine_get_reconnect_stats(engine_handle_t handle, livekit_reconnect_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ENGINE_ERR_INVALID_ARG;
     }
+    engine_t *eng = (engine_t *)handle;
+    *stats = eng->reconnect_stats;
     return ENGINE_ERR_NONE;
 }
\ No newline at end of file
@@ -50,9 +50,15 @@ typedef struct {
 typedef struct {
     void *ctx;
     void (*on_state_changed)(livekit_connection_state_t state, void *ctx);
+    /// Invoked on the data dispatch task; the packet is freed after it returns.
     void (*on_data_packet)(livekit_pb_data_packet_t* packet, void *ctx);
     void (*on_room_info)(const livekit_pb_room_t* info, void *ctx);
     void (*on_participant_info)(const livekit_pb_participant_info_t* info, bool is_local, void *ctx);
+    /// Decides whether to subscribe to a remote track; if NULL, all supported tracks are subscribed.
+    /// Invoked on the engine task.
+    bool (*should_subscribe)(const livekit_pb_participant_info_t* participant, const livekit_pb_track_info_t* track, void *ctx);
+    /// What to do when the buffer of reliable packets waiting to be sent is full.
+    livekit_data_buffer_policy_t data_buffer_policy;
     engine_media_options_t media;
 } engine_options_t;
 
@@ -64,17 +70,52 @@ engine_handle_t engine_init(const engine_options_t *options);
 engine_err_t engine_destroy(engine_handle_t handle);
 
 /// Connect the engine.
-engine_err_t engine_connect(engine_handle_t handle, const char* server_url, const char* token);
+///
+/// In standby, the engine connects but does not publish until activated with
+/// `engine_set_standby`.
+///
+engine_err_t engine_connect(engine_handle_t handle, const char* server_url, const char* token, bool standby);
+
+/// Switches between publishing and standby, keeping the connection.
+engine_err_t engine_set_standby(engine_handle_t handle, bool standby);
 
 /// Close the engine.
 engine_err_t engine_close(engine_handle_t handle);
 
+/// Reevaluates subscriptions to remote tracks after the subscription policy changed.
+engine_err_t engine_update_subscriptions(engine_handle_t handle);
+
 /// Returns the reason why the engine connection failed.
 livekit_failure_reason_t engine_get_failure_reason(engine_handle_t handle);
 
 /// Sends a data packet to the remote peer.
+///
+/// Reliable packets sent while the engine is connecting or reconnecting are buffered
+/// and sent in order once connected. Safe to call from any task.
+///
 engine_err_t engine_send_data_packet(engine_handle_t handle, const livekit_pb_data_packet_t* packet, bool reliable);
 
+/// Returns statistics for reliable packets buffered while not connected.
+engine_err_t engine_get_data_buffer_stats(engine_handle_t handle, livekit_data_buffer_stats_t *stats);
+
+/// Returns statistics for incoming data packets handed off to the dispatch task.
+engine_err_t engine_get_data_dispatch_stats(engine_handle_t handle, livekit_data_dispatch_stats_t *stats);
+
+/// Returns statistics for the subscribed audio jitter buffer.
+engine_err_t engine_get_audio_jitter_stats(engine_handle_t handle, livekit_audio_jitter_stats_t *stats);
+
+/// Returns statistics for subscribed video decoding.
+engine_err_t engine_get_video_render_stats(engine_handle_t handle, livekit_video_render_stats_t *stats);
+
+/// Returns statistics for published media bitrate adaptation.
+engine_err_t engine_get_publish_bitrate_stats(engine_handle_t handle, livekit_bitrate_stats_t *stats);
+
+/// Returns statistics for silence suppression of published audio.
+engine_err_t engine_get_audio_dtx_stats(engine_handle_t handle, livekit_audio_dtx_stats_t *stats);
+
+/// Returns time taken to recover lost connections, by recovery path.
+engine_err_t engine_get_reconnect_stats(engine_handle_t handle, livekit_reconnect_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,341 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "jitter_buffer.h"
+
+/// Frame duration assumed until one is measured from consecutive frames.
+#define DEFAULT_FRAME_DURATION_MS 20
+
+/// Target delay in multiples of the measured jitter (on top of one frame).
+#define JITTER_MULTIPLIER 3
+
+/// Minimum time between two target delay reductions.
+#define SHRINK_INTERVAL_MS 1000
+
+/// Clock rate of pts already in milliseconds.
+#define MS_CLOCK_RATE 1000
+
+typedef struct {
+    uint32_t pts;
+    uint8_t *data;
+    size_t size;
+} slot_t;
+
+typedef struct {
+    jitter_buffer_config_t config;
+
+    /// Buffered frames sorted by pts.
+    slot_t *slots;
+    uint16_t count;
+
+    bool started;
+    /// Last pushed pts in the stream's time base and its unwrapped (64-bit) value,
+    /// used to convert pts to milliseconds across 32-bit rollover.
+    uint32_t last_pts;
+    uint64_t last_ext_pts;
+    /// Maps sender pts to local time: playout time is `pts + offset + target delay`.
+    uint32_t offset;
+    /// pts of the next frame to be played; earlier frames are late.
+    uint32_t playhead;
+    uint32_t frame_duration;
+
+    uint32_t last_arrival;
+    uint32_t last_arrival_pts;
+    /// Smoothed inter-arrival jitter in 1/16 ms (RFC 3550, section 6.4.1).
+    uint32_t jitter_q4;
+
+    uint32_t target_delay;
+    uint32_t last_shrink;
+
+    livekit_audio_jitter_stats_t stats;
+} jitter_buffer_t;
+
+static inline int32_t time_diff(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+static inline uint32_t clamp_delay(const jitter_buffer_t *jb, uint32_t delay)
+{
+    if (delay < jb->config.min_delay_ms) return jb->config.min_delay_ms;
+    if (delay > jb->config.max_delay_ms) return jb->config.max_delay_ms;
+    return delay;
+}
+
+/// Target delay suggested by the current jitter estimate.
+static inline uint32_t desired_delay(const jitter_buffer_t *jb)
+{
+    uint32_t jitter = (jb->jitter_q4 + 8) >> 4;
+    return clamp_delay(jb, jb->frame_duration + JITTER_MULTIPLIER * jitter);
+}
+
+static inline uint32_t due_time(const jitter_buffer_t *jb, uint32_t pts)
+{
+    return pts + jb->offset + jb->target_delay;
+}
+
+/// Converts a pushed pts to milliseconds.
+///
+/// Timestamps are unwrapped relative to the previous push, so reordered frames and
+/// rollover of the 32-bit clock keep a continuous millisecond timeline.
+///
+static uint32_t pts_to_ms(jitter_buffer_t *jb, uint32_t pts)
+{
+    uint32_t clock_rate = jb->config.clock_rate;
+    if (clock_rate == 0 || clock_rate == MS_CLOCK_RATE) {
+        return pts;
+    }
+    if (!jb->started) {
+        // Start one full cycle in so that frames reordered before the first one stay positive.
+        jb->last_ext_pts = ((uint64_t)1 << 32) + pts;
+    } else {
+        jb->last_ext_pts = (uint64_t)((int64_t)jb->last_ext_pts + time_diff(pts, jb->last_pts));
+    }
+    jb->last_pts = pts;
+    return (uint32_t)(jb->last_ext_pts * MS_CLOCK_RATE / clock_rate);
+}
+
+static void free_slot(slot_t *slot)
+{
+    free(slot->data);
+    slot->data = NULL;
+}
+
+/// Removes the first `n` slots, which the caller has already freed or taken.
+static void remove_head(jitter_buffer_t *jb, uint16_t n)
+{
+    jb->count -= n;
+    memmove(&jb->slots[0], &jb->slots[n], jb->count * sizeof(slot_t));
+}
+
+static void update_jitter(jitter_buffer_t *jb, uint32_t pts, uint32_t now_ms)
+{
+    int32_t pts_delta = time_diff(pts, jb->last_arrival_pts);
+    int32_t d = time_diff(now_ms, jb->last_arrival) - pts_delta;
+    uint32_t abs_d = (uint32_t)(d < 0 ? -d : d);
+    jb->jitter_q4 = jb->jitter_q4 + abs_d - ((jb->jitter_q4 + 8) >> 4);
+
+    // Frame duration is the smallest positive pts step seen between arrivals.
+    if (pts_delta > 0 && (uint32_t)pts_delta < jb->frame_duration) {
+        jb->frame_duration = (uint32_t)pts_delta;
+    }
+    jb->last_arrival = now_ms;
+    jb->last_arrival_pts = pts;
+
+    // Grow immediately so the next burst is absorbed; shrinking is done on playout.
+    uint32_t desired = desired_delay(jb);
+    if (desired > jb->target_delay) {
+        jb->target_delay = desired;
+        jb->last_shrink = now_ms;
+    }
+}
+
+jitter_buffer_handle_t jitter_buffer_create(const jitter_buffer_config_t *config)
+{
+    if (config == NULL || config->max_frames == 0 || config->min_delay_ms > config->max_delay_ms) {
+        return NULL;
+    }
+    jitter_buffer_t *jb = calloc(1, sizeof(jitter_buffer_t));
+    if (jb == NULL) {
+        return NULL;
+    }
+    jb->slots = calloc(config->max_frames, sizeof(slot_t));
+    if (jb->slots == NULL) {
+        free(jb);
+        return NULL;
+    }
+    jb->config = *config;
+    jitter_buffer_reset(jb);
+    return jb;
+}
+
+void jitter_buffer_destroy(jitter_buffer_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    jitter_buffer_t *jb = (jitter_buffer_t *)handle;
+    jitter_buffer_reset(jb);
+    free(jb->slots);
+    free(jb);
+}
+
+jitter_buffer_err_t jitter_buffer_push(
+    jitter_buffer_handle_t handle,
+    uint32_t pts,
+    const uint8_t *data,
+    size_t size,
+    uint32_t now_ms)
+{
+    if (handle == NULL || data == NULL || size == 0) {
+        return JITTER_BUFFER_ERR_INVALID_ARG;
+    }
+    jitter_buffer_t *jb = (jitter_buffer_t *)handle;
+    pts = pts_to_ms(jb, pts);
+
+    if (!jb->started) {
+        jb->started = true;
+        jb->offset = now_ms - pts;
+        jb->playhead = pts;
+        jb->last_arrival = now_ms;
+        jb->last_arrival_pts = pts;
+        jb->last_shrink = now_ms;
+    } else {
+        if (time_diff(pts, jb->playhead) < 0) {
+            jb->stats.late_dropped++;
+            return JITTER_BUFFER_ERR_LATE;
+        }
+        update_jitter(jb, pts, now_ms);
+        // A frame arriving earlier than the reference means the first frame was
+        // itself delayed; re-anchor so that delay is not carried forever.
+        if (time_diff(now_ms - pts, jb->offset) < 0) {
+            jb->offset = now_ms - pts;
+        }
+    }
+
+    // Find the insertion point, searching from the back since frames mostly arrive in order.
+    uint16_t pos = jb->count;
+    while (pos > 0 && time_diff(jb->slots[pos - 1].pts, pts) > 0) {
+        pos--;
+    }
+    if (pos > 0 && jb->slots[pos - 1].pts == pts) {
+        return JITTER_BUFFER_ERR_DUPLICATE;
+    }
+    if (jb->count == jb->config.max_frames && pos == 0) {
+        // Older than everything in a full buffer; it would be dropped first anyway.
+        jb->stats.overflow_dropped++;
+        return JITTER_BUFFER_ERR_FULL;
+    }
+
+    uint8_t *copy = malloc(size);
+    if (copy == NULL) {
+        return JITTER_BUFFER_ERR_NO_MEM;
+    }
+    memcpy(copy, data, size);
+
+    if (jb->count == jb->config.max_frames) {
+        // Make room by dropping the oldest frame.
+        free_slot(&jb->slots[0]);
+        jb->playhead = jb->slots[0].pts + jb->frame_duration;
+        remove_head(jb, 1);
+        jb->stats.overflow_dropped++;
+        pos--;
+    }
+    memmove(&jb->slots[pos + 1], &jb->slots[pos], (jb->count - pos) * sizeof(slot_t));
+    jb->slots[pos] = (slot_t){ .pts = pts, .data = copy, .size = size };
+    jb->count++;
+    return JITTER_BUFFER_ERR_NONE;
+}
+
+bool jitter_buffer_pop(jitter_buffer_handle_t handle, uint32_t now_ms, jitter_buffer_frame_t *frame)
+{
+    if (handle == NULL || frame == NULL) {
+        return false;
+    }
+    jitter_buffer_t *jb = (jitter_buffer_t *)handle;
+
+    // Shrink by at most one frame per interval once jitter has subsided.
+    uint32_t desired = desired_delay(jb);
+    if (desired < jb->target_delay && time_diff(now_ms, jb->last_shrink) >= SHRINK_INTERVAL_MS) {
+        uint32_t step = jb->target_delay - desired;
+        if (step > jb->frame_duration) step = jb->frame_duration;
+        jb->target_delay -= step;
+        jb->last_shrink = now_ms;
+    }
+
+    while (jb->count > 0) {
+        slot_t *head = &jb->slots[0];
+        int32_t lateness = time_diff(now_ms, due_time(jb, head->pts));
+        if (lateness < 0) {
+            return false;
+        }
+        if (head->pts != jb->playhead && time_diff(head->pts, jb->playhead) > 0) {
+            jb->stats.concealed += (uint32_t)time_diff(head->pts, jb->playhead) / jb->frame_duration;
+        }
+        jb->playhead = head->pts + jb->frame_duration;
+
+        // Playing a frame more than one frame past its time would add that much
+        // latency for the rest of the stream, so drop it instead.
+        if ((uint32_t)lateness > jb->frame_duration) {
+            free_slot(head);
+            remove_head(jb, 1);
+            jb->stats.late_dropped++;
+            continue;
+        }
+        *frame = (jitter_buffer_frame_t){ .pts = head->pts, .data = head->data, .size = head->size };
+        remove_head(jb, 1);
+        jb->stats.played++;
+        return true;
+    }
+    return false;
+}
+
+uint32_t jitter_buffer_time_to_next(jitter_buffer_handle_t handle, uint32_t now_ms)
+{
+    if (handle == NULL) {
+        return UINT32_MAX;
+    }
+    jitter_buffer_t *jb = (jitter_buffer_t *)handle;
+    if (jb->count == 0) {
+        return UINT32_MAX;
+    }
+    int32_t remaining = time_diff(due_time(jb, jb->slots[0].pts), now_ms);
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+void jitter_buffer_set_clock_rate(jitter_buffer_handle_t handle, uint32_t clock_rate)
+{
+    if (handle == NULL) {
+        return;
+    }
+    jitter_buffer_t *jb = (jitter_buffer_t *)handle;
+    if (jb->config.clock_rate == clock_rate) {
+        return;
+    }
+    jitter_buffer_reset(jb);
+    jb->config.clock_rate = clock_rate;
+}
+
+void jitter_buffer_reset(jitter_buffer_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    jitter_buffer_t *jb = (jitter_buffer_t *)handle;
+    for (uint16_t i = 0; i < jb->count; i++) {
+        free_slot(&jb->slots[i]);
+    }
+    jb->count = 0;
+    jb->started = false;
+    jb->jitter_q4 = 0;
+    jb->frame_duration = DEFAULT_FRAME_DURATION_MS;
+    jb->target_delay = clamp_delay(jb, DEFAULT_FRAME_DURATION_MS);
+}
+
+void jitter_buffer_get_stats(jitter_buffer_handle_t handle, livekit_audio_jitter_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return;
+    }
+    jitter_buffer_t *jb = (jitter_buffer_t *)handle;
+    *stats = jb->stats;
+    stats->target_delay_ms = jb->target_delay;
+    stats->jitter_ms = (jb->jitter_q4 + 8) >> 4;
+    stats->buffered_frames = jb->count;
+}
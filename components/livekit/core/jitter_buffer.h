@@ -0,0 +1,118 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "livekit_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Adaptive jitter buffer for received audio frames.
+///
+/// Frames are ordered by pts and released once their playout time,
+/// `pts + offset + target delay`, is reached. Received pts are converted from the
+/// stream's clock rate (e.g. the 48 kHz RTP clock for Opus) to milliseconds on push,
+/// unwrapping timestamp rollover, and released frames carry the converted pts. The offset maps the sender's clock to
+/// the local clock using the earliest observed arrival. The target delay follows the
+/// measured inter-arrival jitter: it grows immediately when jitter increases and
+/// shrinks one frame at a time once the network has been calm for a while.
+///
+/// Frames arriving after the playhead has passed them, or too late to be played on
+/// time, are dropped. Missing frames are only counted (as concealed) when the next
+/// frame is due: no substitute audio is generated, so the gap is left to the
+/// decoder, which plays the next frame in its place.
+///
+/// The buffer is not thread-safe and takes the current time as a parameter so that
+/// recorded arrival traces can be replayed deterministically.
+///
+typedef void *jitter_buffer_handle_t;
+
+typedef enum {
+    JITTER_BUFFER_ERR_NONE        =  0,
+    JITTER_BUFFER_ERR_INVALID_ARG = -1,
+    JITTER_BUFFER_ERR_NO_MEM      = -2,
+    JITTER_BUFFER_ERR_LATE        = -3, // Frame arrived after its playout time.
+    JITTER_BUFFER_ERR_DUPLICATE   = -4, // Frame with the same pts is already buffered.
+    JITTER_BUFFER_ERR_FULL        = -5, // Buffer is full and the frame is older than all buffered frames.
+} jitter_buffer_err_t;
+
+typedef struct {
+    /// Lower bound for the target delay in milliseconds.
+    uint32_t min_delay_ms;
+    /// Upper bound for the target delay in milliseconds.
+    uint32_t max_delay_ms;
+    /// Maximum number of buffered frames; the oldest frame is dropped when full.
+    uint16_t max_frames;
+    /// Clock rate of pushed pts in Hz; 0 means pts are already in milliseconds.
+    uint32_t clock_rate;
+} jitter_buffer_config_t;
+
+/// A frame released for playout; `data` is owned by the caller and must be freed.
+typedef struct {
+    /// Presentation time in milliseconds.
+    uint32_t pts;
+    uint8_t *data;
+    size_t size;
+} jitter_buffer_frame_t;
+
+/// Creates a buffer.
+jitter_buffer_handle_t jitter_buffer_create(const jitter_buffer_config_t *config);
+
+/// Destroys a buffer, discarding any buffered frames.
+void jitter_buffer_destroy(jitter_buffer_handle_t handle);
+
+/// Inserts a copy of a received frame.
+///
+/// @param pts Presentation time in units of the configured clock rate.
+/// @param now_ms Arrival time in milliseconds.
+///
+jitter_buffer_err_t jitter_buffer_push(
+    jitter_buffer_handle_t handle,
+    uint32_t pts,
+    const uint8_t *data,
+    size_t size,
+    uint32_t now_ms
+);
+
+/// Releases the next frame if it is due for playout.
+///
+/// Call repeatedly until it returns false to release all due frames.
+///
+bool jitter_buffer_pop(jitter_buffer_handle_t handle, uint32_t now_ms, jitter_buffer_frame_t *frame);
+
+/// Returns the time in milliseconds until the next frame is due, or UINT32_MAX if empty.
+uint32_t jitter_buffer_time_to_next(jitter_buffer_handle_t handle, uint32_t now_ms);
+
+/// Changes the clock rate of pushed pts, e.g. once the stream's codec is known.
+///
+/// Buffered frames use the old time base, so the buffer is reset when the rate changes.
+///
+void jitter_buffer_set_clock_rate(jitter_buffer_handle_t handle, uint32_t clock_rate);
+
+/// Discards all frames and timing state, e.g. when the stream restarts; counters are kept.
+void jitter_buffer_reset(jitter_buffer_handle_t handle);
+
+/// Returns the buffer's current delay and counters.
+void jitter_buffer_get_stats(jitter_buffer_handle_t handle, livekit_audio_jitter_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "json_scan.h"
+
+// The scanner follows RFC 8259 strictly; anything it accepts is also accepted
+// by cJSON with the same result, which the tests check by differential fuzzing.
+
+/// Maximum length of a decoded character in UTF-8.
+#define UTF8_MAX_LEN 4
+
+typedef struct {
+    const char *p;
+    const char *end;
+} cursor_t;
+
+// MARK: - Characters
+
+static inline bool is_end(const cursor_t *c)
+{
+    return c->p >= c->end || *c->p == '\0';
+}
+
+static inline void skip_whitespace(cursor_t *c)
+{
+    while (!is_end(c) && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+        c->p++;
+    }
+}
+
+static inline bool is_digit(char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+static int hex_value(char ch)
+{
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+/// Parses the `XXXX` of a `\uXXXX` escape starting at `p`.
+static bool read_hex4(const char *p, const char *end, uint32_t *out)
+{
+    if (end - p < 4) return false;
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hex_value(p[i]);
+        if (digit < 0) return false;
+        value = (value << 4) | (uint32_t)digit;
+    }
+    *out = value;
+    return true;
+}
+
+static size_t utf8_encode(uint32_t code_point, uint8_t out[UTF8_MAX_LEN])
+{
+    if (code_point < 0x80) {
+        out[0] = (uint8_t)code_point;
+        return 1;
+    }
+    if (code_point < 0x800) {
+        out[0] = (uint8_t)(0xC0 | (code_point >> 6));
+        out[1] = (uint8_t)(0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if (code_point < 0x10000) {
+        out[0] = (uint8_t)(0xE0 | (code_point >> 12));
+        out[1] = (uint8_t)(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = (uint8_t)(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = (uint8_t)(0xF0 | (code_point >> 18));
+    out[1] = (uint8_t)(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = (uint8_t)(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = (uint8_t)(0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+/// Decodes one character of a string body at `p` into `out`.
+///
+/// Multi-byte UTF-8 sequences are passed through a byte at a time. Never
+/// produces more bytes than it consumes, so the output may overwrite the input.
+///
+/// @return Pointer past the character, or NULL if it is invalid.
+///
+static const char *decode_char(const char *p, const char *end, uint8_t out[UTF8_MAX_LEN], size_t *out_len)
+{
+    if ((uint8_t)*p < 0x20) {
+        // Control characters must be escaped
+        return NULL;
+    }
+    if (*p != '\\') {
+        out[0] = (uint8_t)*p;
+        *out_len = 1;
+        return p + 1;
+    }
+    if (end - p < 2) return NULL;
+    char escaped;
+    switch (p[1]) {
+        case '"':  escaped = '"';  break;
+        case '\\': escaped = '\\'; break;
+        case '/':  escaped = '/';  break;
+        case 'b':  escaped = '\b'; break;
+        case 'f':  escaped = '\f'; break;
+        case 'n':  escaped = '\n'; break;
+        case 'r':  escaped = '\r'; break;
+        case 't':  escaped = '\t'; break;
+        case 'u': {
+            uint32_t code_point;
+            if (!read_hex4(p + 2, end, &code_point)) return NULL;
+            p += 6;
+            if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+                // Low surrogate without a preceding high surrogate
+                return NULL;
+            }
+            if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                uint32_t low;
+                if (end - p < 2 || p[0] != '\\' || p[1] != 'u' ||
+                    !read_hex4(p + 2, end, &low) ||
+                    low < 0xDC00 || low > 0xDFFF) {
+                    return NULL;
+                }
+                p += 6;
+                code_point = 0x10000 + (((code_point & 0x3FF) << 10) | (low & 0x3FF));
+            }
+            if (code_point == 0) return NULL;
+            *out_len = utf8_encode(code_point, out);
+            return p;
+        }
+        default:
+            return NULL;
+    }
+    out[0] = (uint8_t)escaped;
+    *out_len = 1;
+    return p + 2;
+}
+
+// MARK: - Validation
+
+static bool scan_value(cursor_t *c, int depth);
+
+/// Scans a string, comparing its decoded content with `key` if not NULL.
+static bool scan_string(cursor_t *c, const char *key, bool *is_match)
+{
+    c->p++; // Opening quote
+    size_t key_pos = 0;
+    bool matches = key != NULL;
+    while (!is_end(c)) {
+        if (*c->p == '"') {
+            c->p++;
+            if (is_match != NULL) {
+                *is_match = matches && key[key_pos] == '\0';
+            }
+            return true;
+        }
+        uint8_t decoded[UTF8_MAX_LEN];
+        size_t decoded_len;
+        c->p = decode_char(c->p, c->end, decoded, &decoded_len);
+        if (c->p == NULL) return false;
+        for (size_t i = 0; matches && i < decoded_len; i++) {
+            // Decoded bytes are never NUL, so this also stops at the end of `key`
+            if ((uint8_t)key[key_pos] != decoded[i]) {
+                matches = false;
+            } else {
+                key_pos++;
+            }
+        }
+    }
+    return false;
+}
+
+static bool scan_literal(cursor_t *c, const char *literal)
+{
+    size_t len = strlen(literal);
+    if ((size_t)(c->end - c->p) < len || strncmp(c->p, literal, len) != 0) {
+        return false;
+    }
+    c->p += len;
+    return true;
+}
+
+static bool scan_digits(cursor_t *c)
+{
+    if (is_end(c) || !is_digit(*c->p)) return false;
+    while (!is_end(c) && is_digit(*c->p)) c->p++;
+    return true;
+}
+
+static bool scan_number(cursor_t *c)
+{
+    if (*c->p == '-') c->p++;
+    if (is_end(c)) return false;
+    if (*c->p == '0') {
+        c->p++;
+    } else if (!scan_digits(c)) {
+        return false;
+    }
+    if (!is_end(c) && *c->p == '.') {
+        c->p++;
+        if (!scan_digits(c)) return false;
+    }
+    if (!is_end(c) && (*c->p == 'e' || *c->p == 'E')) {
+        c->p++;
+        if (!is_end(c) && (*c->p == '+' || *c->p == '-')) c->p++;
+        if (!scan_digits(c)) return false;
+    }
+    return true;
+}
+
+static bool scan_array(cursor_t *c, int depth)
+{
+    c->p++; // Opening bracket
+    skip_whitespace(c);
+    if (!is_end(c) && *c->p == ']') {
+        c->p++;
+        return true;
+    }
+    while (true) {
+        skip_whitespace(c);
+        if (!scan_value(c, depth)) return false;
+        skip_whitespace(c);
+        if (is_end(c)) return false;
+        if (*c->p == ']') {
+            c->p++;
+            return true;
+        }
+        if (*c->p != ',') return false;
+        c->p++;
+    }
+}
+
+/// Scans an object, recording in `value_out` where the first member named `key` starts.
+static bool scan_object(cursor_t *c, int depth, const char *key, const char **value_out)
+{
+    c->p++; // Opening brace
+    skip_whitespace(c);
+    if (!is_end(c) && *c->p == '}') {
+        c->p++;
+        return true;
+    }
+    while (true) {
+        skip_whitespace(c);
+        if (is_end(c) || *c->p != '"') return false;
+        bool is_match = false;
+        if (!scan_string(c, *value_out == NULL ? key : NULL, &is_match)) return false;
+        skip_whitespace(c);
+        if (is_end(c) || *c->p != ':') return false;
+        c->p++;
+        skip_whitespace(c);
+        if (is_match) {
+            *value_out = c->p;
+        }
+        if (!scan_value(c, depth)) return false;
+        skip_whitespace(c);
+        if (is_end(c)) return false;
+        if (*c->p == '}') {
+            c->p++;
+            return true;
+        }
+        if (*c->p != ',') return false;
+        c->p++;
+    }
+}
+
+static bool scan_value(cursor_t *c, int depth)
+{
+    if (is_end(c)) return false;
+    switch (*c->p) {
+        case '"': return scan_string(c, NULL, NULL);
+        case 't': return scan_literal(c, "true");
+        case 'f': return scan_literal(c, "false");
+        case 'n': return scan_literal(c, "null");
+        case '[':
+            if (depth >= JSON_SCAN_MAX_DEPTH) return false;
+            return scan_array(c, depth + 1);
+        case '{': {
+            if (depth >= JSON_SCAN_MAX_DEPTH) return false;
+            const char *unused = NULL;
+            return scan_object(c, depth + 1, NULL, &unused);
+        }
+        default:
+            if (*c->p == '-' || is_digit(*c->p)) {
+                return scan_number(c);
+            }
+            return false;
+    }
+}
+
+// MARK: - Public API
+
+json_scan_err_t json_scan_get_string(
+    char *json,
+    size_t len,
+    const char *key,
+    const char **value_out,
+    size_t *value_len_out
+) {
+    if (json == NULL || key == NULL || value_out == NULL) {
+        return JSON_SCAN_ERR_INVALID_ARG;
+    }
+    cursor_t c = { .p = json, .end = json + len };
+    const char *value = NULL;
+
+    skip_whitespace(&c);
+    if (is_end(&c) || *c.p != '{') return JSON_SCAN_ERR_SYNTAX;
+    if (!scan_object(&c, 1, key, &value)) return JSON_SCAN_ERR_SYNTAX;
+    skip_whitespace(&c);
+    if (!is_end(&c)) return JSON_SCAN_ERR_SYNTAX;
+
+    if (value == NULL) return JSON_SCAN_ERR_NOT_FOUND;
+    if (*value != '"') return JSON_SCAN_ERR_TYPE;
+
+    // The object is valid, so the string is well-formed and decodes without errors.
+    char *start = json + (value - json) + 1;
+    const char *read = start;
+    char *write = start;
+    while (*read != '"') {
+        uint8_t decoded[UTF8_MAX_LEN];
+        size_t decoded_len;
+        read = decode_char(read, c.end, decoded, &decoded_len);
+        memcpy(write, decoded, decoded_len);
+        write += decoded_len;
+    }
+    *write = '\0';
+
+    *value_out = start;
+    if (value_len_out != NULL) {
+        *value_len_out = (size_t)(write - start);
+    }
+    return JSON_SCAN_ERR_NONE;
+}
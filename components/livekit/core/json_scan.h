@@ -0,0 +1,73 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Extracts single fields from small JSON documents without building a tree.
+///
+/// Signaling embeds a few JSON documents (e.g. `TrickleRequest.candidate_init`)
+/// from which only one string field is needed. Scanning them in place avoids
+/// the heap allocations of a full parse for every message.
+///
+
+typedef enum {
+    JSON_SCAN_ERR_NONE        =  0,
+    JSON_SCAN_ERR_INVALID_ARG = -1,
+    /// The document is not a well-formed JSON object.
+    JSON_SCAN_ERR_SYNTAX      = -2,
+    /// The object has no member with the given key.
+    JSON_SCAN_ERR_NOT_FOUND   = -3,
+    /// The member's value is not a string.
+    JSON_SCAN_ERR_TYPE        = -4,
+} json_scan_err_t;
+
+/// Maximum depth of nested arrays and objects accepted in a document.
+#define JSON_SCAN_MAX_DEPTH 32
+
+/// Finds a string member of a top-level JSON object and decodes it in place.
+///
+/// The whole object is validated before the value is decoded. Escape sequences,
+/// including UTF-16 surrogate pairs, are decoded to UTF-8 over the encoded value,
+/// which is then NUL-terminated; as decoding never lengthens a string, no other
+/// memory is needed. If a key appears more than once, the first member is used.
+///
+/// @param json[in,out] JSON text; modified in place only on success, after which
+///                     it is no longer valid JSON.
+/// @param len[in] Length of `json` in bytes. Scanning also stops at a NUL byte.
+/// @param key[in] Member name, compared with the key after decoding escapes.
+/// @param value_out[out] Decoded value, pointing into `json`.
+/// @param value_len_out[out] Length of the decoded value in bytes (optional).
+///
+/// @note A value containing `\u0000` is rejected, as it cannot be represented
+///       in a NUL-terminated string.
+///
+json_scan_err_t json_scan_get_string(
+    char *json,
+    size_t len,
+    const char *key,
+    const char **value_out,
+    size_t *value_len_out
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -15,12 +15,17 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <esp_log.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "esp_peer.h"
 #include "engine.h"
 #include "rpc_manager.h"
 #include "data_stream_reader.h"
 #include "data_stream_writer.h"
+#include "participant_cache.h"
+#include "sub_policy.h"
 #include "system.h"
 #include "livekit.h"
 
@@ -33,6 +38,14 @@ typedef struct {
     engine_handle_t engine;
     livekit_room_options_t options;
     livekit_connection_state_t state;
+    /// Guards `options.subscription_policy`, which is read on the engine task.
+    SemaphoreHandle_t policy_mutex;
+    /// Last known participant state, if `options.cache_participants` is set.
+    participant_cache_handle_t participant_cache;
+    /// Guards `participant_cache`, which is updated on the engine task.
+    SemaphoreHandle_t participant_mutex;
+    /// SID of the local participant in the session the cache belongs to.
+    livekit_pb_sid_t local_sid;
 } livekit_room_t;
 
 static bool send_reliable_packet(const livekit_pb_data_packet_t* packet, void *ctx)
@@ -55,11 +68,12 @@ static void on_user_packet(const livekit_pb_user_packet_t* packet, const char* s
     if (room->options.on_data_received == NULL) {
         return;
     }
+    const protocol_bytes_t *payload = packet->payload.arg;
     livekit_data_received_t data = {
         .topic = packet->topic,
         .payload = {
-            .bytes = packet->payload->bytes,
-            .size = packet->payload->size
+            .bytes = payload != NULL ? (uint8_t *)payload->bytes : NULL,
+            .size = payload != NULL ? payload->size : 0
         },
         .sender_identity = (char*)sender_identity
     };
@@ -119,10 +133,22 @@ static void populate_media_options(
     media_options->renderer = sub_options->renderer;
 }
 
+static void clear_participant_cache(livekit_room_t *room)
+{
+    xSemaphoreTake(room->participant_mutex, portMAX_DELAY);
+    participant_cache_clear(room->participant_cache);
+    room->local_sid[0] = '\0';
+    xSemaphoreGive(room->participant_mutex);
+}
+
 static void on_eng_state_changed(livekit_connection_state_t state, void *ctx)
 {
     livekit_room_t *room = (livekit_room_t *)ctx;
     room->state = state;
+    if (room->participant_cache != NULL &&
+        (state == LIVEKIT_CONNECTION_STATE_DISCONNECTED || state == LIVEKIT_CONNECTION_STATE_FAILED)) {
+        clear_participant_cache(room);
+    }
     if (room->options.on_state_changed != NULL) {
         room->options.on_state_changed(state, room->options.ctx);
     }
@@ -173,13 +199,9 @@ static void on_eng_room_info(const livekit_pb_room_t* info, void *ctx)
     room->options.on_room_info(&room_info, room->options.ctx);
 }
 
-static void on_eng_participant_info(const livekit_pb_participant_info_t* info, bool is_local, void *ctx)
+static inline livekit_participant_info_t convert_participant_info(const livekit_pb_participant_info_t* info)
 {
-    livekit_room_t *room = (livekit_room_t *)ctx;
-    if (room->options.on_participant_info == NULL) {
-        return;
-    }
-    const livekit_participant_info_t participant_info = {
+    return (livekit_participant_info_t){
         .sid = info->sid,
         .identity = info->identity,
         .name = info->name,
@@ -187,10 +209,89 @@ static void on_eng_participant_info(const livekit_pb_participant_info_t* info, b
         // Assumes enum values are the same as defined in the protocol.
         .kind = (livekit_participant_kind_t)info->kind,
         .state = (livekit_participant_state_t)info->state,
+        .changed_fields = LIVEKIT_PARTICIPANT_FIELD_ALL,
     };
+}
+
+/// Records a participant in the cache, reporting it only if its information changed.
+static void update_cached_participant(livekit_room_t *room, const livekit_pb_participant_info_t* info, bool is_local)
+{
+    livekit_participant_info_t participant_info;
+    xSemaphoreTake(room->participant_mutex, portMAX_DELAY);
+    if (is_local && strncmp(room->local_sid, info->sid, sizeof(room->local_sid)) != 0) {
+        // A new session after a full reconnect: participants that left in the
+        // meantime will not be reported as disconnected, so start over.
+        participant_cache_clear(room->participant_cache);
+        strlcpy(room->local_sid, info->sid, sizeof(room->local_sid));
+    }
+    participant_cache_err_t err = participant_cache_update(room->participant_cache, info, &participant_info);
+    xSemaphoreGive(room->participant_mutex);
+
+    if (err != PARTICIPANT_CACHE_ERR_NONE) {
+        ESP_LOGD(TAG, "Participant not cached: sid=%s, error=%d", info->sid, err);
+        participant_info = convert_participant_info(info);
+    }
+    // Cached strings are only replaced on this task, so they stay valid while
+    // the handler runs.
+    if (participant_info.changed_fields != 0 && room->options.on_participant_info != NULL) {
+        room->options.on_participant_info(&participant_info, room->options.ctx);
+    }
+    if (err == PARTICIPANT_CACHE_ERR_NONE && info->state == LIVEKIT_PB_PARTICIPANT_INFO_STATE_DISCONNECTED) {
+        xSemaphoreTake(room->participant_mutex, portMAX_DELAY);
+        participant_cache_remove(room->participant_cache, info->sid);
+        xSemaphoreGive(room->participant_mutex);
+    }
+}
+
+static void on_eng_participant_info(const livekit_pb_participant_info_t* info, bool is_local, void *ctx)
+{
+    livekit_room_t *room = (livekit_room_t *)ctx;
+    if (room->participant_cache != NULL) {
+        update_cached_participant(room, info, is_local);
+        return;
+    }
+    if (room->options.on_participant_info == NULL) {
+        return;
+    }
+    const livekit_participant_info_t participant_info = convert_participant_info(info);
     room->options.on_participant_info(&participant_info, room->options.ctx);
 }
 
+// MARK: - Subscription policy
+
+static bool on_eng_should_subscribe(const livekit_pb_participant_info_t* participant, const livekit_pb_track_info_t* track, void *ctx)
+{
+    livekit_room_t *room = (livekit_room_t *)ctx;
+    bool subscribe = true;
+    bool (*callback)(const livekit_participant_info_t*, const livekit_track_info_t*, void*) = NULL;
+
+    xSemaphoreTake(room->policy_mutex, portMAX_DELAY);
+    const livekit_sub_policy_t *policy = &room->options.subscription_policy;
+    switch (sub_policy_evaluate(policy, participant)) {
+        case SUB_POLICY_DENY:
+            subscribe = false;
+            break;
+        case SUB_POLICY_ASK:
+            callback = policy->should_subscribe;
+            break;
+        default:
+            break;
+    }
+    xSemaphoreGive(room->policy_mutex);
+
+    // Invoke the callback outside the lock so it may change the policy.
+    if (callback != NULL) {
+        const livekit_participant_info_t participant_info = convert_participant_info(participant);
+        const livekit_track_info_t track_info = {
+            .sid = track->sid,
+            .kind = track->type == LIVEKIT_PB_TRACK_TYPE_VIDEO ?
+                LIVEKIT_MEDIA_TYPE_VIDEO : LIVEKIT_MEDIA_TYPE_AUDIO,
+        };
+        subscribe = callback(&participant_info, &track_info, room->options.ctx);
+    }
+    return subscribe;
+}
+
 livekit_err_t livekit_room_create(livekit_room_handle_t *handle, const livekit_room_options_t *options)
 {
     if (handle == NULL || options == NULL) {
@@ -222,6 +323,14 @@ livekit_err_t livekit_room_create(livekit_room_handle_t *handle, const livekit_r
         ESP_LOGE(TAG, "Encode options must be set for video publishing");
         return LIVEKIT_ERR_INVALID_ARG;
     }
+    if (!sub_policy_is_valid(&options->subscription_policy)) {
+        ESP_LOGE(TAG, "Invalid subscription policy");
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    if (options->data_buffer_policy > LIVEKIT_DATA_BUFFER_POLICY_BLOCK) {
+        ESP_LOGE(TAG, "Invalid data buffer policy");
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
 
     livekit_room_t *room = calloc(1, sizeof(livekit_room_t));
     if (room == NULL) {
@@ -229,6 +338,15 @@ livekit_err_t livekit_room_create(livekit_room_handle_t *handle, const livekit_r
     }
     room->state = LIVEKIT_CONNECTION_STATE_DISCONNECTED;
     room->options = *options;
+    room->policy_mutex = xSemaphoreCreateMutex();
+    if (room->policy_mutex == NULL ||
+        sub_policy_copy(&room->options.subscription_policy, &options->subscription_policy) != LIVEKIT_ERR_NONE) {
+        if (room->policy_mutex != NULL) {
+            vSemaphoreDelete(room->policy_mutex);
+        }
+        free(room);
+        return LIVEKIT_ERR_NO_MEM;
+    }
 
     engine_media_options_t media_options = {};
     populate_media_options(&media_options, &options->publish, &options->subscribe);
@@ -239,11 +357,22 @@ livekit_err_t livekit_room_create(livekit_room_handle_t *handle, const livekit_r
         .on_data_packet = on_eng_data_packet,
         .on_room_info = on_eng_room_info,
         .on_participant_info = on_eng_participant_info,
+        .should_subscribe = on_eng_should_subscribe,
+        .data_buffer_policy = options->data_buffer_policy,
         .ctx = room
     };
 
     int ret = LIVEKIT_ERR_OTHER;
     do {
+        if (options->cache_participants) {
+            room->participant_cache = participant_cache_create(CONFIG_LK_MAX_CACHED_PARTICIPANTS);
+            room->participant_mutex = xSemaphoreCreateMutex();
+            if (room->participant_cache == NULL || room->participant_mutex == NULL) {
+                ESP_LOGE(TAG, "Failed to create participant cache");
+                ret = LIVEKIT_ERR_NO_MEM;
+                break;
+            }
+        }
         room->engine = engine_init(&eng_options);
         if (room->engine == NULL) {
             ESP_LOGE(TAG, "Failed to create engine");
@@ -278,6 +407,12 @@ livekit_err_t livekit_room_create(livekit_room_handle_t *handle, const livekit_r
         return LIVEKIT_ERR_NONE;
     } while (0);
 
+    participant_cache_destroy(room->participant_cache);
+    if (room->participant_mutex != NULL) {
+        vSemaphoreDelete(room->participant_mutex);
+    }
+    sub_policy_free(&room->options.subscription_policy);
+    vSemaphoreDelete(room->policy_mutex);
     free(room);
     return ret;
 }
@@ -293,6 +428,12 @@ livekit_err_t livekit_room_destroy(livekit_room_handle_t handle)
     rpc_manager_destroy(room->rpc_manager);
     data_stream_reader_destroy(room->data_stream_reader);
     data_stream_writer_destroy(room->data_stream_writer);
+    participant_cache_destroy(room->participant_cache);
+    if (room->participant_mutex != NULL) {
+        vSemaphoreDelete(room->participant_mutex);
+    }
+    sub_policy_free(&room->options.subscription_policy);
+    vSemaphoreDelete(room->policy_mutex);
     free(room);
     return LIVEKIT_ERR_NONE;
 }
@@ -304,13 +445,51 @@ livekit_err_t livekit_room_connect(livekit_room_handle_t handle, const char *ser
     }
     livekit_room_t *room = (livekit_room_t *)handle;
 
-    if (engine_connect(room->engine, server_url, token) != ENGINE_ERR_NONE) {
+    if (engine_connect(room->engine, server_url, token, false) != ENGINE_ERR_NONE) {
+        ESP_LOGE(TAG, "Failed to connect engine");
+        return LIVEKIT_ERR_OTHER;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_connect_standby(livekit_room_handle_t handle, const char *server_url, const char *token)
+{
+    if (handle == NULL || server_url == NULL || token == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+
+    if (engine_connect(room->engine, server_url, token, true) != ENGINE_ERR_NONE) {
         ESP_LOGE(TAG, "Failed to connect engine");
         return LIVEKIT_ERR_OTHER;
     }
     return LIVEKIT_ERR_NONE;
 }
 
+livekit_err_t livekit_room_activate(livekit_room_handle_t handle)
+{
+    if (handle == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_set_standby(room->engine, false) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_OTHER;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_standby(livekit_room_handle_t handle)
+{
+    if (handle == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_set_standby(room->engine, true) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_OTHER;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
 livekit_err_t livekit_room_close(livekit_room_handle_t handle)
 {
     if (handle == NULL) {
@@ -321,6 +500,29 @@ livekit_err_t livekit_room_close(livekit_room_handle_t handle)
     return LIVEKIT_ERR_NONE;
 }
 
+livekit_err_t livekit_room_set_subscription_policy(livekit_room_handle_t handle, const livekit_sub_policy_t *policy)
+{
+    if (handle == NULL || policy == NULL || !sub_policy_is_valid(policy)) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+
+    livekit_sub_policy_t copy;
+    if (sub_policy_copy(&copy, policy) != LIVEKIT_ERR_NONE) {
+        return LIVEKIT_ERR_NO_MEM;
+    }
+    xSemaphoreTake(room->policy_mutex, portMAX_DELAY);
+    livekit_sub_policy_t previous = room->options.subscription_policy;
+    room->options.subscription_policy = copy;
+    xSemaphoreGive(room->policy_mutex);
+    sub_policy_free(&previous);
+
+    if (engine_update_subscriptions(room->engine) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
 livekit_connection_state_t livekit_room_get_state(livekit_room_handle_t handle)
 {
     if (handle == NULL) {
@@ -379,24 +581,69 @@ livekit_failure_reason_t livekit_room_get_failure_reason(livekit_room_handle_t h
     return engine_get_failure_reason(room->engine);
 }
 
-livekit_err_t livekit_room_publish_data(livekit_room_handle_t handle, livekit_data_publish_options_t *options)
+livekit_err_t livekit_room_get_reconnect_stats(livekit_room_handle_t handle, livekit_reconnect_stats_t *stats)
 {
-    if (handle == NULL || options == NULL || options->payload == NULL) {
+    if (handle == NULL || stats == NULL) {
         return LIVEKIT_ERR_INVALID_ARG;
     }
     livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_get_reconnect_stats(room->engine, stats) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
+    return LIVEKIT_ERR_NONE;
+}
 
-    // TODO: Can this be done without allocating additional memory?
-    pb_bytes_array_t *bytes_array = malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(options->payload->size));
-    if (bytes_array == NULL) {
-        return LIVEKIT_ERR_NO_MEM;
+livekit_err_t livekit_room_get_participant(livekit_room_handle_t handle, const char *sid, livekit_participant_info_t *info)
+{
+    if (handle == NULL || sid == NULL || info == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
     }
-    bytes_array->size = (pb_size_t)options->payload->size;
-    memcpy(bytes_array->bytes, options->payload->bytes, options->payload->size);
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (room->participant_cache == NULL) {
+        ESP_LOGE(TAG, "Participant cache not enabled");
+        return LIVEKIT_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(room->participant_mutex, portMAX_DELAY);
+    participant_cache_err_t err = participant_cache_get(room->participant_cache, sid, info);
+    xSemaphoreGive(room->participant_mutex);
+
+    switch (err) {
+        case PARTICIPANT_CACHE_ERR_NONE:      return LIVEKIT_ERR_NONE;
+        case PARTICIPANT_CACHE_ERR_NOT_FOUND: return LIVEKIT_ERR_NOT_FOUND;
+        default:                              return LIVEKIT_ERR_OTHER;
+    }
+}
 
+livekit_err_t livekit_room_release_participant(livekit_room_handle_t handle, livekit_participant_info_t *info)
+{
+    if (handle == NULL || info == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (room->participant_cache == NULL) {
+        return LIVEKIT_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(room->participant_mutex, portMAX_DELAY);
+    participant_cache_release(room->participant_cache, info);
+    xSemaphoreGive(room->participant_mutex);
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_publish_data(livekit_room_handle_t handle, livekit_data_publish_options_t *options)
+{
+    if (handle == NULL || options == NULL || options->payload == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+
+    // Payload is encoded straight from the caller's buffer.
+    protocol_bytes_t payload = {
+        .bytes = options->payload->bytes,
+        .size = options->payload->size
+    };
     livekit_pb_user_packet_t user_packet = {
         .topic = options->topic,
-        .payload = bytes_array
+        .payload = { .arg = &payload }
     };
     livekit_pb_data_packet_t packet = LIVEKIT_PB_DATA_PACKET_INIT_ZERO;
     packet.which_value = LIVEKIT_PB_DATA_PACKET_USER_TAG;
@@ -408,10 +655,80 @@ livekit_err_t livekit_room_publish_data(livekit_room_handle_t handle, livekit_da
 
     if (engine_send_data_packet(room->engine, &packet, !options->lossy) != ENGINE_ERR_NONE) {
         ESP_LOGE(TAG, "Failed to send data packet");
-        free(bytes_array);
         return LIVEKIT_ERR_ENGINE;
     }
-    free(bytes_array);
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_get_data_buffer_stats(livekit_room_handle_t handle, livekit_data_buffer_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_get_data_buffer_stats(room->engine, stats) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_get_data_dispatch_stats(livekit_room_handle_t handle, livekit_data_dispatch_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_get_data_dispatch_stats(room->engine, stats) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_get_audio_jitter_stats(livekit_room_handle_t handle, livekit_audio_jitter_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_get_audio_jitter_stats(room->engine, stats) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_get_video_render_stats(livekit_room_handle_t handle, livekit_video_render_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_get_video_render_stats(room->engine, stats) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_get_publish_bitrate_stats(livekit_room_handle_t handle, livekit_bitrate_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_get_publish_bitrate_stats(room->engine, stats) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+livekit_err_t livekit_room_get_audio_dtx_stats(livekit_room_handle_t handle, livekit_audio_dtx_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return LIVEKIT_ERR_INVALID_ARG;
+    }
+    livekit_room_t *room = (livekit_room_t *)handle;
+    if (engine_get_audio_dtx_stats(room->engine, stats) != ENGINE_ERR_NONE) {
+        return LIVEKIT_ERR_ENGINE;
+    }
     return LIVEKIT_ERR_NONE;
 }
 
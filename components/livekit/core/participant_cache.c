@@ -0,0 +1,342 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <khash.h>
+
+#include "participant_cache.h"
+
+/// A string shared by everything holding the same value.
+typedef struct {
+    uint32_t refs;
+    char str[];
+} interned_t;
+
+#define INTERNED(s) ((interned_t *)(void *)((char *)(s) - offsetof(interned_t, str)))
+
+/// Cached state of a participant; strings are interned.
+typedef struct {
+    const char *identity;
+    const char *name;
+    const char *metadata;
+    livekit_participant_kind_t kind;
+    livekit_participant_state_t state;
+} cached_participant_t;
+
+// Interned strings, keyed by value.
+KHASH_SET_INIT_STR(strings)
+// Participants, keyed by their interned SID.
+KHASH_MAP_INIT_STR(participants, cached_participant_t)
+
+typedef struct {
+    size_t max_participants;
+    khash_t(strings) *strings;
+    khash_t(participants) *participants;
+    participant_cache_stats_t stats;
+} participant_cache_t;
+
+// MARK: - Interning
+
+/// Gets the shared copy of a string, creating it if needed.
+static bool intern(participant_cache_t *cache, const char *str, const char **interned_out)
+{
+    if (str == NULL) {
+        *interned_out = NULL;
+        return true;
+    }
+    khiter_t key = kh_get(strings, cache->strings, str);
+    if (key != kh_end(cache->strings)) {
+        const char *interned = kh_key(cache->strings, key);
+        INTERNED(interned)->refs++;
+        *interned_out = interned;
+        return true;
+    }
+    size_t size = strlen(str) + 1;
+    interned_t *entry = malloc(sizeof(interned_t) + size);
+    if (entry == NULL) {
+        return false;
+    }
+    entry->refs = 1;
+    memcpy(entry->str, str, size);
+
+    int put_result;
+    kh_put(strings, cache->strings, entry->str, &put_result);
+    if (put_result < 0) {
+        free(entry);
+        return false;
+    }
+    cache->stats.string_bytes += size;
+    *interned_out = entry->str;
+    return true;
+}
+
+static void retain(const char *interned)
+{
+    if (interned != NULL) {
+        INTERNED(interned)->refs++;
+    }
+}
+
+static void release(participant_cache_t *cache, const char *interned)
+{
+    if (interned == NULL) {
+        return;
+    }
+    interned_t *entry = INTERNED(interned);
+    if (--entry->refs > 0) {
+        return;
+    }
+    khiter_t key = kh_get(strings, cache->strings, interned);
+    if (key != kh_end(cache->strings)) {
+        kh_del(strings, cache->strings, key);
+    }
+    cache->stats.string_bytes -= strlen(interned) + 1;
+    free(entry);
+}
+
+// MARK: - Participants
+
+/// Protocol strings are omitted when empty; treat both forms alike.
+static const char *normalize(const char *str)
+{
+    return str != NULL && str[0] != '\0' ? str : NULL;
+}
+
+/// Replaces a cached string if the value differs, marking the field as changed.
+static bool update_string(
+    participant_cache_t *cache,
+    const char **cached,
+    const char *value,
+    uint32_t field,
+    uint32_t *changed
+) {
+    value = normalize(value);
+    bool is_equal = *cached == NULL || value == NULL ?
+        *cached == value : strcmp(*cached, value) == 0;
+    if (is_equal) {
+        return true;
+    }
+    const char *interned;
+    if (!intern(cache, value, &interned)) {
+        return false;
+    }
+    release(cache, *cached);
+    *cached = interned;
+    *changed |= field;
+    return true;
+}
+
+static void release_participant(participant_cache_t *cache, khiter_t key)
+{
+    cached_participant_t *participant = &kh_value(cache->participants, key);
+    release(cache, participant->identity);
+    release(cache, participant->name);
+    release(cache, participant->metadata);
+    release(cache, kh_key(cache->participants, key));
+}
+
+static void fill_info(participant_cache_t *cache, khiter_t key, uint32_t changed, livekit_participant_info_t *info_out)
+{
+    const cached_participant_t *participant = &kh_value(cache->participants, key);
+    *info_out = (livekit_participant_info_t){
+        .sid = kh_key(cache->participants, key),
+        .identity = participant->identity,
+        .name = participant->name,
+        .metadata = participant->metadata,
+        .kind = participant->kind,
+        .state = participant->state,
+        .changed_fields = changed,
+    };
+}
+
+participant_cache_handle_t participant_cache_create(size_t max_participants)
+{
+    if (max_participants == 0) {
+        return NULL;
+    }
+    participant_cache_t *cache = calloc(1, sizeof(participant_cache_t));
+    if (cache == NULL) {
+        return NULL;
+    }
+    cache->max_participants = max_participants;
+    cache->strings = kh_init(strings);
+    cache->participants = kh_init(participants);
+    if (cache->strings == NULL || cache->participants == NULL) {
+        participant_cache_destroy(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void participant_cache_destroy(participant_cache_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    participant_cache_t *cache = (participant_cache_t *)handle;
+    if (cache->participants != NULL) {
+        participant_cache_clear(cache);
+        kh_destroy(participants, cache->participants);
+    }
+    if (cache->strings != NULL) {
+        // Only left over if snapshots were not released.
+        for (khiter_t key = kh_begin(cache->strings); key != kh_end(cache->strings); key++) {
+            if (kh_exist(cache->strings, key)) {
+                free(INTERNED(kh_key(cache->strings, key)));
+            }
+        }
+        kh_destroy(strings, cache->strings);
+    }
+    free(cache);
+}
+
+participant_cache_err_t participant_cache_update(
+    participant_cache_handle_t handle,
+    const livekit_pb_participant_info_t *info,
+    livekit_participant_info_t *info_out
+) {
+    if (handle == NULL || info == NULL || info_out == NULL || info->sid[0] == '\0') {
+        return PARTICIPANT_CACHE_ERR_INVALID_ARG;
+    }
+    participant_cache_t *cache = (participant_cache_t *)handle;
+    uint32_t changed = 0;
+
+    khiter_t key = kh_get(participants, cache->participants, info->sid);
+    bool is_new = key == kh_end(cache->participants);
+    if (is_new) {
+        if (kh_size(cache->participants) >= cache->max_participants) {
+            return PARTICIPANT_CACHE_ERR_FULL;
+        }
+        const char *sid;
+        if (!intern(cache, info->sid, &sid)) {
+            return PARTICIPANT_CACHE_ERR_NO_MEM;
+        }
+        int put_result;
+        key = kh_put(participants, cache->participants, sid, &put_result);
+        if (put_result < 0) {
+            release(cache, sid);
+            return PARTICIPANT_CACHE_ERR_NO_MEM;
+        }
+        kh_value(cache->participants, key) = (cached_participant_t){};
+        changed = LIVEKIT_PARTICIPANT_FIELD_ALL;
+    }
+
+    cached_participant_t *participant = &kh_value(cache->participants, key);
+    if (!update_string(cache, &participant->identity, info->identity, LIVEKIT_PARTICIPANT_FIELD_IDENTITY, &changed) ||
+        !update_string(cache, &participant->name, info->name, LIVEKIT_PARTICIPANT_FIELD_NAME, &changed) ||
+        !update_string(cache, &participant->metadata, info->metadata, LIVEKIT_PARTICIPANT_FIELD_METADATA, &changed)) {
+        if (is_new) {
+            release_participant(cache, key);
+            kh_del(participants, cache->participants, key);
+        }
+        return PARTICIPANT_CACHE_ERR_NO_MEM;
+    }
+    // Assumes enum values are the same as defined in the protocol.
+    livekit_participant_kind_t kind = (livekit_participant_kind_t)info->kind;
+    if (participant->kind != kind) {
+        participant->kind = kind;
+        changed |= LIVEKIT_PARTICIPANT_FIELD_KIND;
+    }
+    livekit_participant_state_t state = (livekit_participant_state_t)info->state;
+    if (participant->state != state) {
+        participant->state = state;
+        changed |= LIVEKIT_PARTICIPANT_FIELD_STATE;
+    }
+
+    cache->stats.updates++;
+    if (changed == 0) {
+        cache->stats.unchanged++;
+    }
+    fill_info(cache, key, changed, info_out);
+    return PARTICIPANT_CACHE_ERR_NONE;
+}
+
+participant_cache_err_t participant_cache_get(
+    participant_cache_handle_t handle,
+    const char *sid,
+    livekit_participant_info_t *info_out
+) {
+    if (handle == NULL || sid == NULL || info_out == NULL) {
+        return PARTICIPANT_CACHE_ERR_INVALID_ARG;
+    }
+    participant_cache_t *cache = (participant_cache_t *)handle;
+    khiter_t key = kh_get(participants, cache->participants, sid);
+    if (key == kh_end(cache->participants)) {
+        return PARTICIPANT_CACHE_ERR_NOT_FOUND;
+    }
+    fill_info(cache, key, 0, info_out);
+    retain(info_out->sid);
+    retain(info_out->identity);
+    retain(info_out->name);
+    retain(info_out->metadata);
+    return PARTICIPANT_CACHE_ERR_NONE;
+}
+
+void participant_cache_release(participant_cache_handle_t handle, livekit_participant_info_t *info)
+{
+    if (handle == NULL || info == NULL) {
+        return;
+    }
+    participant_cache_t *cache = (participant_cache_t *)handle;
+    release(cache, info->sid);
+    release(cache, info->identity);
+    release(cache, info->name);
+    release(cache, info->metadata);
+    memset(info, 0, sizeof(*info));
+}
+
+participant_cache_err_t participant_cache_remove(participant_cache_handle_t handle, const char *sid)
+{
+    if (handle == NULL || sid == NULL) {
+        return PARTICIPANT_CACHE_ERR_INVALID_ARG;
+    }
+    participant_cache_t *cache = (participant_cache_t *)handle;
+    khiter_t key = kh_get(participants, cache->participants, sid);
+    if (key == kh_end(cache->participants)) {
+        return PARTICIPANT_CACHE_ERR_NOT_FOUND;
+    }
+    release_participant(cache, key);
+    kh_del(participants, cache->participants, key);
+    return PARTICIPANT_CACHE_ERR_NONE;
+}
+
+void participant_cache_clear(participant_cache_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    participant_cache_t *cache = (participant_cache_t *)handle;
+    for (khiter_t key = kh_begin(cache->participants); key != kh_end(cache->participants); key++) {
+        if (kh_exist(cache->participants, key)) {
+            release_participant(cache, key);
+        }
+    }
+    kh_clear(participants, cache->participants);
+}
+
+participant_cache_err_t participant_cache_get_stats(participant_cache_handle_t handle, participant_cache_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return PARTICIPANT_CACHE_ERR_INVALID_ARG;
+    }
+    participant_cache_t *cache = (participant_cache_t *)handle;
+    *stats = cache->stats;
+    stats->participants = kh_size(cache->participants);
+    stats->strings = kh_size(cache->strings);
+    return PARTICIPANT_CACHE_ERR_NONE;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "livekit.h"
+#include "protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Last known state of each participant in a room, keyed by SID.
+///
+/// Updates are compared against the cached state so only changed fields are
+/// reported. Strings are interned: a single reference-counted copy of each
+/// distinct value is shared by all participants and by snapshots handed out
+/// with `participant_cache_get`. Updates and lookups are O(1).
+///
+/// Not thread-safe; callers must serialize access.
+///
+typedef void *participant_cache_handle_t;
+
+typedef enum {
+    PARTICIPANT_CACHE_ERR_NONE        =  0,
+    PARTICIPANT_CACHE_ERR_INVALID_ARG = -1,
+    PARTICIPANT_CACHE_ERR_NO_MEM      = -2,
+    PARTICIPANT_CACHE_ERR_NOT_FOUND   = -3,
+    /// The cache holds its maximum number of participants.
+    PARTICIPANT_CACHE_ERR_FULL        = -4,
+} participant_cache_err_t;
+
+typedef struct {
+    /// Participants currently cached.
+    uint32_t participants;
+    /// Distinct strings currently interned.
+    uint32_t strings;
+    /// Bytes held by interned strings, including terminators.
+    size_t string_bytes;
+    /// Updates applied since the cache was created.
+    uint32_t updates;
+    /// Of those, updates that changed no field.
+    uint32_t unchanged;
+} participant_cache_stats_t;
+
+/// Creates a cache holding up to `max_participants` participants.
+participant_cache_handle_t participant_cache_create(size_t max_participants);
+
+/// Destroys a cache.
+///
+/// Snapshots retained with `participant_cache_get` must be released first.
+///
+void participant_cache_destroy(participant_cache_handle_t handle);
+
+/// Records a participant's latest state.
+///
+/// @param info_out[out] Cached state, with `changed_fields` set to the fields that
+///                      differ from the previous state (all fields for a participant
+///                      not seen before). Strings remain valid until the participant
+///                      is next updated or removed.
+/// @return @ref PARTICIPANT_CACHE_ERR_FULL or @ref PARTICIPANT_CACHE_ERR_NO_MEM if
+///         the participant could not be cached, in which case `info_out` is not set.
+///
+participant_cache_err_t participant_cache_update(
+    participant_cache_handle_t handle,
+    const livekit_pb_participant_info_t *info,
+    livekit_participant_info_t *info_out
+);
+
+/// Gets a snapshot of a participant's cached state.
+///
+/// The snapshot's strings are retained, so they stay valid after the participant
+/// is updated or removed; release them with `participant_cache_release`.
+///
+participant_cache_err_t participant_cache_get(
+    participant_cache_handle_t handle,
+    const char *sid,
+    livekit_participant_info_t *info_out
+);
+
+/// Releases a snapshot obtained with `participant_cache_get`.
+void participant_cache_release(participant_cache_handle_t handle, livekit_participant_info_t *info);
+
+/// Forgets a participant, e.g. once it has disconnected.
+participant_cache_err_t participant_cache_remove(participant_cache_handle_t handle, const char *sid);
+
+/// Forgets all participants.
+void participant_cache_clear(participant_cache_handle_t handle);
+
+/// Gets statistics for the cache.
+participant_cache_err_t participant_cache_get_stats(participant_cache_handle_t handle, participant_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
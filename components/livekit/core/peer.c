@@ -19,6 +19,7 @@
 #include "esp_peer.h"
 #include "esp_peer_default.h"
 #include "media_lib_os.h"
+#include "protocol_encoder.h"
 #include "utils.h"
 
 #include "peer.h"
@@ -49,6 +50,7 @@ typedef struct {
 
     uint16_t reliable_stream_id;
     uint16_t lossy_stream_id;
+    protocol_encoder_handle_t encoder;
 
 #if CONFIG_LK_BENCHMARK
     uint64_t start_time;
@@ -275,6 +277,12 @@ peer_err_t peer_create(peer_handle_t *handle, peer_options_t *options)
         free(peer);
         return PEER_ERR_NO_MEM;
     }
+    peer->encoder = protocol_encoder_create();
+    if (peer->encoder == NULL) {
+        media_lib_event_group_destroy(peer->wait_event);
+        free(peer);
+        return PEER_ERR_NO_MEM;
+    }
 
     peer->options = *options;
     peer->ice_role = options->role == PEER_ROLE_SUBSCRIBER ?
@@ -297,6 +305,12 @@ peer_err_t peer_create(peer_handle_t *handle, peer_options_t *options)
     esp_peer_media_dir_t video_dir = get_media_direction(options->media->video_dir, peer->options.role);
     ESP_LOGD(TAG(peer), "Audio dir: %d, Video dir: %d", audio_dir, video_dir);
 
+    esp_peer_video_stream_info_t video_info = options->media->video_info;
+    if (video_dir == ESP_PEER_MEDIA_DIR_RECV_ONLY && video_info.codec == ESP_PEER_VIDEO_CODEC_NONE) {
+        // Codec must be set for video to be negotiated, even when only receiving.
+        video_info.codec = ESP_PEER_VIDEO_CODEC_H264;
+    }
+
     esp_peer_cfg_t peer_cfg = {
         .server_lists = options->server_list,
         .server_num = options->server_count,
@@ -305,7 +319,7 @@ peer_err_t peer_create(peer_handle_t *handle, peer_options_t *options)
         .audio_dir = audio_dir,
         .video_dir = video_dir,
         .audio_info = options->media->audio_info,
-        .video_info = options->media->video_info,
+        .video_info = video_info,
         .enable_data_channel = true,
         .manual_ch_create = true,
         .no_auto_reconnect = false,
@@ -325,6 +339,7 @@ peer_err_t peer_create(peer_handle_t *handle, peer_options_t *options)
     };
     if (esp_peer_open(&peer_cfg, esp_peer_get_default_impl(), &peer->connection) != ESP_PEER_ERR_NONE) {
         ESP_LOGE(TAG(peer), "Failed to open peer");
+        protocol_encoder_destroy(peer->encoder);
         media_lib_event_group_destroy(peer->wait_event);
         free(peer);
         return PEER_ERR_RTC;
@@ -342,6 +357,7 @@ peer_err_t peer_destroy(peer_handle_t handle)
     if (peer && peer->wait_event) {
         media_lib_event_group_destroy(peer->wait_event);
     }
+    protocol_encoder_destroy(peer->encoder);
     free(peer);
     return PEER_ERR_NONE;
 }
@@ -401,6 +417,42 @@ peer_err_t peer_disconnect(peer_handle_t handle)
     return PEER_ERR_NONE;
 }
 
+peer_err_t peer_restart_ice(peer_handle_t handle)
+{
+    if (handle == NULL) {
+        return PEER_ERR_INVALID_ARG;
+    }
+    peer_t *peer = (peer_t *)handle;
+    if (peer->connection == NULL || !peer->running) {
+        return PEER_ERR_INVALID_STATE;
+    }
+#if CONFIG_LK_BENCHMARK
+    peer->start_time = get_unix_time_ms();
+#endif
+    // The peer task and data channel configuration are kept; only the
+    // transport is torn down. The publisher generates a new offer, while the
+    // subscriber waits for one from the server.
+    esp_peer_disconnect(peer->connection);
+    peer->reliable_stream_id = STREAM_ID_INVALID;
+    peer->lossy_stream_id = STREAM_ID_INVALID;
+    peer->state = CONNECTION_STATE_CONNECTING;
+
+    if (esp_peer_new_connection(peer->connection) != ESP_PEER_ERR_NONE) {
+        ESP_LOGE(TAG(peer), "Failed to restart connection");
+        return PEER_ERR_RTC;
+    }
+    ESP_LOGI(TAG(peer), "Restarting ICE");
+    return PEER_ERR_NONE;
+}
+
+connection_state_t peer_get_state(peer_handle_t handle)
+{
+    if (handle == NULL) {
+        return CONNECTION_STATE_DISCONNECTED;
+    }
+    return ((peer_t *)handle)->state;
+}
+
 peer_err_t peer_handle_sdp(peer_handle_t handle, const char *sdp)
 {
     if (handle == NULL || sdp == NULL) {
@@ -422,26 +474,39 @@ peer_err_t peer_handle_sdp(peer_handle_t handle, const char *sdp)
 
 peer_err_t peer_handle_ice_candidate(peer_handle_t handle, const char *candidate)
 {
-    if (handle == NULL || candidate == NULL) {
+    return peer_handle_ice_candidates(handle, &candidate, 1);
+}
+
+peer_err_t peer_handle_ice_candidates(peer_handle_t handle, const char *const *candidates, size_t count)
+{
+    if (handle == NULL || candidates == NULL) {
         return PEER_ERR_INVALID_ARG;
     }
     peer_t *peer = (peer_t *)handle;
 
-    esp_peer_msg_t msg = {
-        .type = ESP_PEER_MSG_TYPE_CANDIDATE,
-        .data = (void *)candidate,
-        .size = (int)strlen(candidate)
-    };
-    if (esp_peer_send_msg(peer->connection, &msg) != ESP_PEER_ERR_NONE) {
-        ESP_LOGE(TAG(peer), "Failed to handle ICE candidate");
-        return PEER_ERR_RTC;
+    peer_err_t ret = PEER_ERR_NONE;
+    for (size_t i = 0; i < count; i++) {
+        if (candidates[i] == NULL) {
+            ret = PEER_ERR_INVALID_ARG;
+            continue;
+        }
+        esp_peer_msg_t msg = {
+            .type = ESP_PEER_MSG_TYPE_CANDIDATE,
+            .data = (void *)candidates[i],
+            .size = (int)strlen(candidates[i])
+        };
+        // Keep going so one bad candidate does not drop the rest of the batch.
+        if (esp_peer_send_msg(peer->connection, &msg) != ESP_PEER_ERR_NONE) {
+            ESP_LOGE(TAG(peer), "Failed to handle ICE candidate");
+            ret = PEER_ERR_RTC;
+        }
     }
-    return PEER_ERR_NONE;
+    return ret;
 }
 
-peer_err_t peer_send_data_packet(peer_handle_t handle, const livekit_pb_data_packet_t* packet, bool reliable)
+peer_err_t peer_send_data(peer_handle_t handle, const uint8_t *data, size_t size, bool reliable)
 {
-    if (handle == NULL || packet == NULL) {
+    if (handle == NULL || data == NULL) {
         return PEER_ERR_INVALID_ARG;
     }
     peer_t *peer = (peer_t *)handle;
@@ -454,33 +519,31 @@ peer_err_t peer_send_data_packet(peer_handle_t handle, const livekit_pb_data_pac
     }
     esp_peer_data_frame_t frame_info = {
         .type = ESP_PEER_DATA_CHANNEL_DATA,
-        .stream_id = stream_id
+        .stream_id = stream_id,
+        .data = (uint8_t *)data,
+        .size = (int)size
     };
-
-    size_t encoded_size = protocol_data_packet_encoded_size(packet);
-    if (encoded_size == 0) {
-        return PEER_ERR_MESSAGE;
+    if (esp_peer_send_data(peer->connection, &frame_info) != ESP_PEER_ERR_NONE) {
+        ESP_LOGE(TAG(peer), "Data channel send failed");
+        return PEER_ERR_RTC;
     }
-    uint8_t *enc_buf = (uint8_t *)malloc(encoded_size);
-    if (enc_buf == NULL) {
-        return PEER_ERR_NO_MEM;
+    return PEER_ERR_NONE;
+}
+
+peer_err_t peer_send_data_packet(peer_handle_t handle, const livekit_pb_data_packet_t* packet, bool reliable)
+{
+    if (handle == NULL || packet == NULL) {
+        return PEER_ERR_INVALID_ARG;
     }
-    int ret = PEER_ERR_NONE;
-    do {
-        if (!protocol_data_packet_encode(packet, enc_buf, encoded_size)) {
-            ret = PEER_ERR_MESSAGE;
-            break;
-        }
-        frame_info.data = enc_buf;
-        frame_info.size = (int)encoded_size;
-        if (esp_peer_send_data(peer->connection, &frame_info) != ESP_PEER_ERR_NONE) {
-            ESP_LOGE(TAG(peer), "Data channel send failed");
-            ret = PEER_ERR_RTC;
-            break;
-        }
-    } while (0);
+    peer_t *peer = (peer_t *)handle;
 
-    free(enc_buf);
+    const uint8_t *enc_buf = NULL;
+    size_t encoded_size = 0;
+    if (!protocol_encoder_encode_data_packet(peer->encoder, packet, &enc_buf, &encoded_size)) {
+        return PEER_ERR_MESSAGE;
+    }
+    peer_err_t ret = peer_send_data(handle, enc_buf, encoded_size, reliable);
+    protocol_encoder_release(peer->encoder);
     return ret;
 }
 
@@ -492,7 +555,9 @@ peer_err_t peer_send_audio(peer_handle_t handle, esp_peer_audio_frame_t* frame)
     peer_t *peer = (peer_t *)handle;
     assert(peer->options.role == PEER_ROLE_PUBLISHER);
 
-    esp_peer_send_audio(peer->connection, frame);
+    if (esp_peer_send_audio(peer->connection, frame) != ESP_PEER_ERR_NONE) {
+        return PEER_ERR_RTC;
+    }
     return PEER_ERR_NONE;
 }
 
@@ -504,6 +569,8 @@ peer_err_t peer_send_video(peer_handle_t handle, esp_peer_video_frame_t* frame)
     peer_t *peer = (peer_t *)handle;
     assert(peer->options.role == PEER_ROLE_PUBLISHER);
 
-    esp_peer_send_video(peer->connection, frame);
+    if (esp_peer_send_video(peer->connection, frame) != ESP_PEER_ERR_NONE) {
+        return PEER_ERR_RTC;
+    }
     return PEER_ERR_NONE;
 }
\ No newline at end of file
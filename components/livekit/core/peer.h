@@ -93,15 +93,36 @@ peer_err_t peer_destroy(peer_handle_t handle);
 peer_err_t peer_connect(peer_handle_t handle);
 peer_err_t peer_disconnect(peer_handle_t handle);
 
+/// Restarts ICE on a failed connection, keeping the peer and its task.
+///
+/// On the publisher, generates a new offer (delivered through `on_sdp`) which must
+/// be sent to the remote peer; the answer is handled with `peer_handle_sdp` as for
+/// the initial connection. On the subscriber, the transport is reset so that the
+/// next offer from the server, which initiates the restart, can be answered.
+///
+peer_err_t peer_restart_ice(peer_handle_t handle);
+
+/// Returns the peer's current connection state.
+connection_state_t peer_get_state(peer_handle_t handle);
+
 /// Handles an SDP message from the remote peer.
 peer_err_t peer_handle_sdp(peer_handle_t handle, const char *sdp);
 
 /// Handles an ICE candidate from the remote peer.
 peer_err_t peer_handle_ice_candidate(peer_handle_t handle, const char *candidate);
 
+/// Handles a batch of ICE candidates from the remote peer.
+///
+/// Every candidate is applied even if an earlier one fails; the last error is returned.
+///
+peer_err_t peer_handle_ice_candidates(peer_handle_t handle, const char *const *candidates, size_t count);
+
 /// Sends a data packet to the remote peer.
 peer_err_t peer_send_data_packet(peer_handle_t handle, const livekit_pb_data_packet_t* packet, bool reliable);
 
+/// Sends an already encoded data packet to the remote peer.
+peer_err_t peer_send_data(peer_handle_t handle, const uint8_t *data, size_t size, bool reliable);
+
 /// Sends an audio frame to the remote peer.
 /// @warning Only use on publisher peer.
 peer_err_t peer_send_audio(peer_handle_t handle, esp_peer_audio_frame_t* frame);
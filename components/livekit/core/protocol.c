@@ -15,15 +15,21 @@
  */
 
 #include <inttypes.h>
+#include <stdlib.h>
 #include "esp_log.h"
-#include "cJSON.h"
 #include "pb_encode.h"
 #include "pb_decode.h"
 
+#include "json_scan.h"
+#include "protocol_arena.h"
 #include "protocol.h"
 
 static const char *TAG = "livekit_protocol";
 
+/// Decoded messages typically need about twice their encoded size in memory,
+/// plus the headers of a few small allocations.
+#define ARENA_SIZE_HINT(len) ((len) * 2 + 64)
+
 static int32_t decode_first_tag(const pb_byte_t *buf, size_t len)
 {
     pb_istream_t stream = pb_istream_from_buffer(buf, len);
@@ -38,11 +44,60 @@ static int32_t decode_first_tag(const pb_byte_t *buf, size_t len)
 
 // MARK: - Data packet
 
+bool protocol_user_packet_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field)
+{
+    if (field->tag != LIVEKIT_PB_USER_PACKET_PAYLOAD_TAG) {
+        return true;
+    }
+    pb_callback_t *payload_field = (pb_callback_t *)field->pData;
+
+    if (ostream != NULL) {
+        const protocol_bytes_t *payload = payload_field->arg;
+        if (payload == NULL || payload->size == 0) {
+            return true;
+        }
+        return pb_encode_tag_for_field(ostream, field) &&
+            pb_encode_string(ostream, (const pb_byte_t *)payload->bytes, payload->size);
+    }
+    if (istream != NULL) {
+        // Allocate the descriptor and data together; freed by `protocol_data_packet_free`.
+        size_t size = istream->bytes_left;
+        protocol_bytes_t *payload = protocol_arena_realloc(NULL, sizeof(protocol_bytes_t) + size);
+        if (payload == NULL) {
+            PB_RETURN_ERROR(istream, "no memory for payload");
+        }
+        uint8_t *bytes = (uint8_t *)(payload + 1);
+        if (!pb_read(istream, (pb_byte_t *)bytes, size)) {
+            protocol_arena_free(payload);
+            return false;
+        }
+        payload->bytes = bytes;
+        payload->size = size;
+
+        protocol_arena_free(payload_field->arg);
+        payload_field->arg = payload;
+    }
+    return true;
+}
+
+/// Frees fields of a data packet not covered by `pb_release`.
+static void data_packet_release_callbacks(livekit_pb_data_packet_t *packet)
+{
+    if (packet->which_value == LIVEKIT_PB_DATA_PACKET_USER_TAG) {
+        protocol_arena_free(packet->value.user.payload.arg);
+        packet->value.user.payload.arg = NULL;
+    }
+}
+
 __attribute__((always_inline))
 inline bool protocol_data_packet_decode(const uint8_t *buf, size_t len, livekit_pb_data_packet_t *out)
 {
     pb_istream_t stream = pb_istream_from_buffer((const pb_byte_t *)buf, len);
-    if (!pb_decode(&stream, LIVEKIT_PB_DATA_PACKET_FIELDS, out)) {
+    protocol_arena_begin(ARENA_SIZE_HINT(len));
+    bool decoded = pb_decode(&stream, LIVEKIT_PB_DATA_PACKET_FIELDS, out);
+    protocol_arena_end();
+    if (!decoded) {
+        data_packet_release_callbacks(out);
         ESP_LOGE(TAG, "Failed to decode data packet: type=%" PRId32 ", error=%s",
             decode_first_tag(buf, len), stream.errmsg);
         return false;
@@ -53,52 +108,211 @@ inline bool protocol_data_packet_decode(const uint8_t *buf, size_t len, livekit_
 __attribute__((always_inline))
 inline void protocol_data_packet_free(livekit_pb_data_packet_t *packet)
 {
-    pb_release(LIVEKIT_PB_DATA_PACKET_FIELDS, packet);
+    data_packet_release_callbacks(packet);
+    protocol_arena_release(LIVEKIT_PB_DATA_PACKET_FIELDS, packet);
 }
 
-__attribute__((always_inline))
-inline size_t protocol_data_packet_encoded_size(const livekit_pb_data_packet_t *packet)
+// MARK: - Participants
+
+/// Location of a repeated participant field within the buffer it was decoded from.
+typedef struct {
+    /// Payload of the first element.
+    const pb_byte_t *first;
+    size_t first_size;
+    /// End of the last element's payload. Elements after the first are found by
+    /// scanning the fields between the two, which may be interleaved with others.
+    const pb_byte_t *end;
+    uint32_t tag;
+    size_t count;
+    /// Buffer decoded from, if owned by the response.
+    void *owned_buf;
+} participant_list_t;
+
+bool protocol_participants_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field)
 {
-    size_t encoded_size = 0;
-    if (!pb_get_encoded_size(&encoded_size, LIVEKIT_PB_DATA_PACKET_FIELDS, packet)) {
+    if (field->submsg_desc != LIVEKIT_PB_PARTICIPANT_INFO_FIELDS) {
+        return true;
+    }
+    pb_callback_t *list_field = (pb_callback_t *)field->pData;
+    participant_list_t *list = list_field->arg;
+
+    if (ostream != NULL && list != NULL) {
+        // Participants are only received; fail rather than drop them silently.
+        PB_RETURN_ERROR(ostream, "participants cannot be encoded");
+    }
+    if (istream != NULL) {
+        // Keep the element encoded where it is; it is decoded when visited. Only
+        // its location is recorded, which relies on the response being decoded
+        // from a buffer (`protocol_signal_response_decode`), whose stream state is
+        // the read position. Freed by `protocol_signal_response_free`.
+        const pb_byte_t *element = (const pb_byte_t *)istream->state;
+        size_t size = istream->bytes_left;
+        if (list == NULL) {
+            list = protocol_arena_realloc(NULL, sizeof(participant_list_t));
+            if (list == NULL) {
+                PB_RETURN_ERROR(istream, "no memory for participants");
+            }
+            *list = (participant_list_t) {
+                .first = element,
+                .first_size = size,
+                .tag = field->tag
+            };
+            list_field->arg = list;
+        }
+        if (!pb_read(istream, NULL, size)) {
+            return false;
+        }
+        list->end = element + size;
+        list->count++;
+    }
+    return true;
+}
+
+size_t protocol_participants_count(const pb_callback_t *participants)
+{
+    if (participants == NULL || participants->arg == NULL) {
         return 0;
     }
-    return encoded_size;
+    return ((const participant_list_t *)participants->arg)->count;
 }
 
-__attribute__((always_inline))
-inline bool protocol_data_packet_encode(const livekit_pb_data_packet_t *packet, uint8_t *dest, size_t encoded_size)
+/// Decodes a single participant and passes it to the visitor.
+static bool visit_participant(pb_istream_t *element, protocol_participant_visitor_t visitor, void *ctx)
 {
-    pb_ostream_t stream = pb_ostream_from_buffer((pb_byte_t *)dest, encoded_size);
-    if (!pb_encode(&stream, LIVEKIT_PB_DATA_PACKET_FIELDS, packet)) {
-        ESP_LOGE(TAG, "Failed to encode data packet: type=%" PRIu16 ", error=%s",
-            packet->which_value, stream.errmsg);
+    // Only one participant is decoded at a time, each into its own arena.
+    livekit_pb_participant_info_t participant = LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO;
+    protocol_arena_begin(ARENA_SIZE_HINT(element->bytes_left));
+    bool decoded = pb_decode(element, LIVEKIT_PB_PARTICIPANT_INFO_FIELDS, &participant);
+    protocol_arena_end();
+    if (!decoded) {
+        ESP_LOGE(TAG, "Failed to decode participant: error=%s", PB_GET_ERROR(element));
         return false;
     }
-    return stream.bytes_written == encoded_size;
+    visitor(&participant, ctx);
+    protocol_arena_release(LIVEKIT_PB_PARTICIPANT_INFO_FIELDS, &participant);
+    return true;
+}
+
+bool protocol_participants_visit(
+    const pb_callback_t *participants,
+    protocol_participant_visitor_t visitor,
+    void *ctx
+) {
+    if (participants == NULL || visitor == NULL) {
+        return false;
+    }
+    const participant_list_t *list = participants->arg;
+    if (list == NULL) {
+        return true;
+    }
+    pb_istream_t first = pb_istream_from_buffer(list->first, list->first_size);
+    if (!visit_participant(&first, visitor, ctx)) {
+        return false;
+    }
+    const pb_byte_t *rest = list->first + list->first_size;
+    pb_istream_t stream = pb_istream_from_buffer(rest, (size_t)(list->end - rest));
+    while (stream.bytes_left > 0) {
+        pb_wire_type_t wire_type;
+        uint32_t tag;
+        bool eof = false;
+        if (!pb_decode_tag(&stream, &wire_type, &tag, &eof) || eof) {
+            return false;
+        }
+        if (tag != list->tag || wire_type != PB_WT_STRING) {
+            if (!pb_skip_field(&stream, wire_type)) {
+                return false;
+            }
+            continue;
+        }
+        pb_istream_t element;
+        if (!pb_make_string_substream(&stream, &element)) {
+            return false;
+        }
+        bool visited = visit_participant(&element, visitor, ctx);
+        if (!pb_close_string_substream(&stream, &element) || !visited) {
+            return false;
+        }
+    }
+    return true;
 }
 
 // MARK: - Signal response
 
+/// Returns the participant list of a signal response, if it has one.
+static participant_list_t *signal_response_participants(livekit_pb_signal_response_t *res)
+{
+    switch (res->which_message) {
+        case LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG:
+            return res->message.join.other_participants.arg;
+        case LIVEKIT_PB_SIGNAL_RESPONSE_UPDATE_TAG:
+            return res->message.update.participants.arg;
+        default:
+            return NULL;
+    }
+}
+
+/// Frees fields of a signal response not covered by `pb_release`.
+static void signal_response_release_callbacks(livekit_pb_signal_response_t *res)
+{
+    participant_list_t *list = signal_response_participants(res);
+    if (list == NULL) {
+        return;
+    }
+    free(list->owned_buf);
+    protocol_arena_free(list);
+    switch (res->which_message) {
+        case LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG:
+            res->message.join.other_participants.arg = NULL;
+            break;
+        case LIVEKIT_PB_SIGNAL_RESPONSE_UPDATE_TAG:
+            res->message.update.participants.arg = NULL;
+            break;
+        default:
+            break;
+    }
+}
+
+bool protocol_signal_response_refers_to_buffer(const uint8_t *buf, size_t len)
+{
+    int32_t type = decode_first_tag(buf, len);
+    return type == LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG ||
+        type == LIVEKIT_PB_SIGNAL_RESPONSE_UPDATE_TAG;
+}
+
 __attribute__((always_inline))
-inline bool protocol_signal_response_decode(const uint8_t *buf, size_t len, livekit_pb_signal_response_t* out)
+inline bool protocol_signal_response_decode(const uint8_t *buf, size_t len, bool owned, livekit_pb_signal_response_t* out)
 {
     pb_istream_t stream = pb_istream_from_buffer((const pb_byte_t *)buf, len);
-    if (!pb_decode(&stream, LIVEKIT_PB_SIGNAL_RESPONSE_FIELDS, out)) {
+    protocol_arena_begin(ARENA_SIZE_HINT(len));
+    bool decoded = pb_decode(&stream, LIVEKIT_PB_SIGNAL_RESPONSE_FIELDS, out);
+    protocol_arena_end();
+    if (!decoded) {
+        signal_response_release_callbacks(out);
         ESP_LOGE(TAG, "Failed to decode signal res: type=%" PRId32 ", error=%s",
             decode_first_tag(buf, len), stream.errmsg);
+        if (owned) free((void *)buf);
         return false;
     }
+    if (owned) {
+        // Keep the buffer only if participants are to be decoded from it.
+        participant_list_t *list = signal_response_participants(out);
+        if (list != NULL) {
+            list->owned_buf = (void *)buf;
+        } else {
+            free((void *)buf);
+        }
+    }
     return true;
 }
 
 __attribute__((always_inline))
 inline void protocol_signal_response_free(livekit_pb_signal_response_t *res)
 {
-    pb_release(LIVEKIT_PB_SIGNAL_RESPONSE_FIELDS, res);
+    signal_response_release_callbacks(res);
+    protocol_arena_release(LIVEKIT_PB_SIGNAL_RESPONSE_FIELDS, res);
 }
 
-bool protocol_signal_trickle_get_candidate(const livekit_pb_trickle_request_t *trickle, char **candidate_out)
+bool protocol_signal_trickle_get_candidate(livekit_pb_trickle_request_t *trickle, const char **candidate_out)
 {
     if (trickle == NULL || candidate_out == NULL) {
         return false;
@@ -107,54 +321,16 @@ bool protocol_signal_trickle_get_candidate(const livekit_pb_trickle_request_t *t
         ESP_LOGE(TAG, "candidate_init is NULL");
         return false;
     }
-
-    bool ret = false;
-    cJSON *candidate_init = NULL;
-    do {
-        candidate_init = cJSON_Parse(trickle->candidate_init);
-        if (candidate_init == NULL) {
-            const char *error_ptr = cJSON_GetErrorPtr();
-            if (error_ptr != NULL) {
-                ESP_LOGE(TAG, "Failed to parse candidate_init: %s", error_ptr);
-            }
-            break;
-        }
-        cJSON *candidate = cJSON_GetObjectItemCaseSensitive(candidate_init, "candidate");
-        if (!cJSON_IsString(candidate) || (candidate->valuestring == NULL)) {
-            ESP_LOGE(TAG, "Missing candidate key in candidate_init");
-            break;
-        }
-        *candidate_out = strdup(candidate->valuestring);
-        if (*candidate_out == NULL) {
-            break;
-        }
-        ret = true;
-    } while(0);
-
-    cJSON_Delete(candidate_init);
-    return ret;
-}
-
-// MARK: - Signal request
-
-__attribute__((always_inline))
-inline size_t protocol_signal_request_encoded_size(const livekit_pb_signal_request_t *req)
-{
-    size_t encoded_size = 0;
-    if (!pb_get_encoded_size(&encoded_size, LIVEKIT_PB_SIGNAL_REQUEST_FIELDS, req)) {
-        return 0;
-    }
-    return encoded_size;
-}
-
-__attribute__((always_inline))
-inline bool protocol_signal_request_encode(const livekit_pb_signal_request_t *req, uint8_t *dest, size_t encoded_size)
-{
-    pb_ostream_t stream = pb_ostream_from_buffer((pb_byte_t *)dest, encoded_size);
-    if (!pb_encode(&stream, LIVEKIT_PB_SIGNAL_REQUEST_FIELDS, req)) {
-        ESP_LOGE(TAG, "Failed to encode signal req: type=%" PRIu16 ", error=%s",
-            req->which_message, stream.errmsg);
+    json_scan_err_t err = json_scan_get_string(
+        trickle->candidate_init,
+        strlen(trickle->candidate_init),
+        "candidate",
+        candidate_out,
+        NULL
+    );
+    if (err != JSON_SCAN_ERR_NONE) {
+        ESP_LOGE(TAG, "Failed to get candidate from candidate_init: error=%d", err);
         return false;
     }
-    return stream.bytes_written == encoded_size;
+    return true;
 }
@@ -28,6 +28,17 @@ extern "C" {
 /// Server identifier (SID) type.
 typedef char livekit_pb_sid_t[16];
 
+/// Bytes referenced by a callback field's `arg` (e.g. `livekit_pb_user_packet_t.payload`).
+///
+/// When encoding, point `arg` at a `protocol_bytes_t` describing the caller's buffer;
+/// the bytes are written directly into the output stream without an intermediate copy.
+/// When decoding, `arg` is set to a `protocol_bytes_t` owned by the decoded message.
+///
+typedef struct {
+    const uint8_t *bytes;
+    size_t size;
+} protocol_bytes_t;
+
 // MARK: - Data packet
 
 /// Decodes a data packet.
@@ -39,46 +50,68 @@ bool protocol_data_packet_decode(const uint8_t *buf, size_t len, livekit_pb_data
 /// Frees a data packet.
 void protocol_data_packet_free(livekit_pb_data_packet_t *packet);
 
-/// Returns the encoded size of a data packet.
+// MARK: - Participants
+
+/// Handler for each participant visited by `protocol_participants_visit`.
 ///
-/// @returns The encoded size of the packet or 0 if the encoded size cannot be determined.
+/// The participant is only valid for the duration of the call.
 ///
-size_t protocol_data_packet_encoded_size(const livekit_pb_data_packet_t *packet);
+typedef void (*protocol_participant_visitor_t)(const livekit_pb_participant_info_t *participant, void *ctx);
+
+/// Returns the number of participants in a participant list field
+/// (e.g. `livekit_pb_participant_update_t.participants`).
+size_t protocol_participants_count(const pb_callback_t *participants);
 
-/// Encodes a data packet into the provided buffer.
-bool protocol_data_packet_encode(const livekit_pb_data_packet_t *packet, uint8_t *dest, size_t encoded_size);
+/// Visits the participants in a participant list field in order.
+///
+/// Participant lists are left encoded in the buffer a signal response was
+/// decoded from, so large rooms need neither every participant decoded at once
+/// nor a copy of the list. Each participant is decoded just before it is passed
+/// to the visitor and released after.
+///
+/// @return false if a participant could not be decoded, in which case the
+///         remaining participants are not visited.
+///
+bool protocol_participants_visit(
+    const pb_callback_t *participants,
+    protocol_participant_visitor_t visitor,
+    void *ctx
+);
 
 // MARK: - Signal response
 
 /// Decodes a signal response.
 ///
+/// Participant lists refer to `buf` (see `protocol_signal_response_refers_to_buffer`),
+/// so it must remain valid until the response is freed unless `owned` is set.
 /// When the response is no longer needed, free using `protocol_signal_response_free`.
 ///
-bool protocol_signal_response_decode(const uint8_t *buf, size_t len, livekit_pb_signal_response_t* out);
+/// @param owned Whether the response takes ownership of `buf`, which must have
+///              been allocated with `malloc`. It is freed as soon as it is no
+///              longer referenced, including when decoding fails.
+///
+bool protocol_signal_response_decode(const uint8_t *buf, size_t len, bool owned, livekit_pb_signal_response_t* out);
+
+/// Returns whether an encoded signal response refers to its buffer once decoded.
+///
+/// True for join responses and participant updates, whose participant lists
+/// are decoded from the buffer when visited.
+///
+bool protocol_signal_response_refers_to_buffer(const uint8_t *buf, size_t len);
 
 /// Frees a signal response.
 void protocol_signal_response_free(livekit_pb_signal_response_t *res);
 
 /// Extract ICE candidate string from a trickle request.
 ///
-/// The caller is responsible for freeing the candidate string if it is not NULL.
+/// The candidate is decoded in place within `candidate_init`, which is consumed;
+/// the returned string remains valid for as long as the trickle request.
 ///
 bool protocol_signal_trickle_get_candidate(
-    const livekit_pb_trickle_request_t *trickle,
-    char **candidate_out
+    livekit_pb_trickle_request_t *trickle,
+    const char **candidate_out
 );
 
-// MARK: - Signal request
-
-/// Returns the encoded size of a signal request.
-///
-/// @returns The encoded size of the request or 0 if the encoded size cannot be determined.
-///
-size_t protocol_signal_request_encoded_size(const livekit_pb_signal_request_t *req);
-
-/// Encodes a signal request into the provided buffer.
-bool protocol_signal_request_encode(const livekit_pb_signal_request_t *req, uint8_t *dest, size_t encoded_size);
-
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
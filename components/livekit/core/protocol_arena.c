@@ -0,0 +1,289 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "pb_allocator.h"
+#include "pb_decode.h"
+
+#include "protocol_arena.h"
+
+#define ARENA_ALIGN 8
+#define ARENA_ALIGN_UP(n) (((n) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+
+/// A contiguous block that allocations are carved out of.
+///
+/// Holds one reference per live allocation plus one for the arena scope while
+/// it is the scope's current chunk.
+///
+typedef struct {
+    atomic_uint refs;
+    size_t capacity;
+    size_t used;
+} arena_chunk_t;
+
+/// Header preceding every allocation.
+typedef struct {
+    /// Owning chunk or NULL for a heap allocation.
+    arena_chunk_t *chunk;
+    /// Usable size of the allocation.
+    size_t capacity;
+} arena_header_t;
+
+#define CHUNK_HEADER_SIZE ARENA_ALIGN_UP(sizeof(arena_chunk_t))
+#define ALLOC_HEADER_SIZE ARENA_ALIGN_UP(sizeof(arena_header_t))
+
+#define CHUNK_DATA(chunk) ((uint8_t *)(chunk) + CHUNK_HEADER_SIZE)
+#define HEADER_FOR(ptr) ((arena_header_t *)((uint8_t *)(ptr) - ALLOC_HEADER_SIZE))
+
+static bool is_enabled = true;
+
+static __thread uint8_t scope_depth;
+/// Whether allocations in the current scope are carved out of chunks.
+static __thread bool is_chunked;
+static __thread const pb_allocator_t *previous_allocator;
+static __thread arena_chunk_t *current_chunk;
+static __thread size_t current_size_hint;
+
+static atomic_uint stat_allocs;
+static atomic_uint stat_heap_allocs;
+static atomic_uint stat_heap_frees;
+
+// MARK: - Chunks
+
+static arena_chunk_t *chunk_create(size_t min_capacity)
+{
+    // Sized to the message, so small packets take little memory.
+    size_t capacity = current_size_hint;
+    if (capacity < min_capacity) capacity = min_capacity;
+
+#if CONFIG_SPIRAM
+    arena_chunk_t *chunk = heap_caps_malloc_prefer(CHUNK_HEADER_SIZE + capacity, 2,
+        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT);
+#else
+    arena_chunk_t *chunk = malloc(CHUNK_HEADER_SIZE + capacity);
+#endif
+    if (chunk == NULL) {
+        return NULL;
+    }
+    atomic_fetch_add(&stat_heap_allocs, 1);
+    atomic_init(&chunk->refs, 1);
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    return chunk;
+}
+
+static void chunk_release(arena_chunk_t *chunk)
+{
+    if (atomic_fetch_sub(&chunk->refs, 1) == 1) {
+        atomic_fetch_add(&stat_heap_frees, 1);
+        free(chunk);
+    }
+}
+
+// MARK: - Allocation
+
+static void *arena_alloc(size_t size)
+{
+    size_t capacity = ARENA_ALIGN_UP(size);
+    size_t needed = ALLOC_HEADER_SIZE + capacity;
+
+    if (current_chunk == NULL || current_chunk->capacity - current_chunk->used < needed) {
+        if (current_chunk != NULL) {
+            // The size hint was too small; grow geometrically.
+            current_size_hint = current_chunk->capacity * 2;
+            if (current_size_hint < CONFIG_LK_PROTOCOL_ARENA_CHUNK_SIZE) {
+                current_size_hint = CONFIG_LK_PROTOCOL_ARENA_CHUNK_SIZE;
+            }
+        }
+        arena_chunk_t *chunk = chunk_create(needed);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        if (current_chunk != NULL) {
+            // Drop the scope reference; the old chunk lives on until its
+            // allocations are released.
+            chunk_release(current_chunk);
+        }
+        current_chunk = chunk;
+    }
+    arena_header_t *header = (arena_header_t *)(CHUNK_DATA(current_chunk) + current_chunk->used);
+    current_chunk->used += needed;
+    atomic_fetch_add(&current_chunk->refs, 1);
+
+    header->chunk = current_chunk;
+    header->capacity = capacity;
+    return (uint8_t *)header + ALLOC_HEADER_SIZE;
+}
+
+static void *heap_alloc(void *ptr, size_t size)
+{
+    arena_header_t *header = realloc(ptr != NULL ? HEADER_FOR(ptr) : NULL, ALLOC_HEADER_SIZE + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    if (ptr == NULL) {
+        atomic_fetch_add(&stat_heap_allocs, 1);
+    }
+    header->chunk = NULL;
+    header->capacity = size;
+    return (uint8_t *)header + ALLOC_HEADER_SIZE;
+}
+
+/// Attempts to grow the most recent allocation in the current chunk in place.
+static bool arena_try_extend(arena_header_t *header, size_t size)
+{
+    arena_chunk_t *chunk = header->chunk;
+    if (!is_chunked || chunk != current_chunk) {
+        return false;
+    }
+    uint8_t *end = (uint8_t *)header + ALLOC_HEADER_SIZE + header->capacity;
+    if (end != CHUNK_DATA(chunk) + chunk->used) {
+        return false;
+    }
+    size_t capacity = ARENA_ALIGN_UP(size);
+    size_t extra = capacity - header->capacity;
+    if (chunk->capacity - chunk->used < extra) {
+        return false;
+    }
+    chunk->used += extra;
+    header->capacity = capacity;
+    return true;
+}
+
+void *protocol_arena_realloc(void *ptr, size_t size)
+{
+    atomic_fetch_add(&stat_allocs, 1);
+
+    if (ptr == NULL) {
+        return is_chunked ? arena_alloc(size) : heap_alloc(NULL, size);
+    }
+    arena_header_t *header = HEADER_FOR(ptr);
+    if (size <= header->capacity) {
+        return ptr;
+    }
+    if (header->chunk == NULL) {
+        return heap_alloc(ptr, size);
+    }
+    if (arena_try_extend(header, size)) {
+        return ptr;
+    }
+
+    // nanopb grows repeated fields one element at a time, so reserve extra
+    // capacity to avoid copying on every element.
+    size_t grown = header->capacity * 2;
+    void *moved = is_chunked ?
+        arena_alloc(grown > size ? grown : size) :
+        heap_alloc(NULL, size);
+    if (moved == NULL) {
+        return NULL;
+    }
+    memcpy(moved, ptr, header->capacity);
+    protocol_arena_free(ptr);
+    return moved;
+}
+
+void protocol_arena_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    arena_header_t *header = HEADER_FOR(ptr);
+    if (header->chunk == NULL) {
+        atomic_fetch_add(&stat_heap_frees, 1);
+        free(header);
+        return;
+    }
+    chunk_release(header->chunk);
+}
+
+// MARK: - Scope
+
+#if CONFIG_LK_PROTOCOL_ARENA
+static const pb_allocator_t arena_allocator = {
+    .realloc = protocol_arena_realloc,
+    .free = protocol_arena_free
+};
+#endif
+
+void protocol_arena_begin(size_t size_hint)
+{
+#if CONFIG_LK_PROTOCOL_ARENA
+    if (scope_depth++ > 0) {
+        return;
+    }
+    // nanopb allocates through the arena even when chunks are disabled, so
+    // that its allocations are counted and released consistently.
+    previous_allocator = pb_allocator_set(&arena_allocator);
+    is_chunked = is_enabled;
+    current_size_hint = ARENA_ALIGN_UP(size_hint);
+    // The first chunk is created lazily so messages without pointer
+    // fields cost no allocations.
+    current_chunk = NULL;
+#endif
+}
+
+void protocol_arena_end(void)
+{
+#if CONFIG_LK_PROTOCOL_ARENA
+    if (scope_depth == 0 || --scope_depth > 0) {
+        return;
+    }
+    pb_allocator_set(previous_allocator);
+    is_chunked = false;
+    if (current_chunk != NULL) {
+        chunk_release(current_chunk);
+        current_chunk = NULL;
+    }
+#endif
+}
+
+void protocol_arena_release(const pb_msgdesc_t *fields, void *message)
+{
+#if CONFIG_LK_PROTOCOL_ARENA
+    const pb_allocator_t *previous = pb_allocator_set(&arena_allocator);
+    pb_release(fields, message);
+    pb_allocator_set(previous);
+#else
+    pb_release(fields, message);
+#endif
+}
+
+void protocol_arena_set_enabled(bool enabled)
+{
+    is_enabled = enabled;
+}
+
+// MARK: - Stats
+
+void protocol_arena_get_stats(protocol_arena_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->allocs = atomic_load(&stat_allocs);
+    stats->heap_allocs = atomic_load(&stat_heap_allocs);
+    stats->heap_frees = atomic_load(&stat_heap_frees);
+}
+
+void protocol_arena_reset_stats(void)
+{
+    atomic_store(&stat_allocs, 0);
+    atomic_store(&stat_heap_allocs, 0);
+    atomic_store(&stat_heap_frees, 0);
+}
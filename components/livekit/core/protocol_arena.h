@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Allocation counters used to compare the arena and heap decode paths.
+typedef struct {
+    /// Allocations requested with `protocol_arena_realloc`.
+    uint32_t allocs;
+    /// Underlying heap allocations (arena chunks and fallback allocations).
+    uint32_t heap_allocs;
+    /// Underlying heap frees.
+    uint32_t heap_frees;
+} protocol_arena_stats_t;
+
+/// Begins a per-message arena scope on the calling task.
+///
+/// Until the matching `protocol_arena_end`, nanopb's pointer fields and the
+/// buffers of this component's field callbacks (e.g. user packet payloads) are
+/// carved out of a single chunk (preferring PSRAM when available) instead of
+/// individual heap allocations. nanopb reaches the arena through its per-thread
+/// allocator (see `pb_allocator.h`), which is installed only while a scope is
+/// open or a message is released, so other nanopb users are unaffected.
+/// Chunks are reference counted per allocation, so releasing a message with
+/// `protocol_arena_release` frees its chunk exactly once.
+///
+/// @param size_hint Expected total size of the allocations in this scope; the
+///                  first chunk is sized to fit it.
+///
+void protocol_arena_begin(size_t size_hint);
+
+/// Ends the arena scope on the calling task.
+///
+/// Allocations made in the scope remain valid until released with
+/// `protocol_arena_release` or `protocol_arena_free`.
+///
+void protocol_arena_end(void);
+
+/// Releases the pointer fields of a message decoded in an arena scope.
+///
+/// Use instead of `pb_release`, on any task.
+///
+void protocol_arena_release(const pb_msgdesc_t *fields, void *message);
+
+/// Enables or disables arena scopes at runtime.
+///
+/// When disabled, allocations go to the heap, one each. Enabled by default;
+/// intended for benchmarking.
+///
+void protocol_arena_set_enabled(bool enabled);
+
+/// Returns allocation counters since the last reset.
+void protocol_arena_get_stats(protocol_arena_stats_t *stats);
+
+/// Resets allocation counters.
+void protocol_arena_reset_stats(void);
+
+/// Allocates or grows a buffer, from the current scope's chunk if there is one.
+void *protocol_arena_realloc(void *ptr, size_t size);
+
+/// Frees a buffer allocated with `protocol_arena_realloc`.
+void protocol_arena_free(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "pb_encode.h"
+
+#include "protocol_encoder.h"
+
+static const char *TAG = "livekit_encoder";
+
+typedef struct {
+    SemaphoreHandle_t mutex;
+    uint8_t *buf;
+    size_t capacity;
+    /// One-off buffer holding the current message if it exceeded the maximum scratch size.
+    uint8_t *oversized_buf;
+    protocol_encoder_stats_t stats;
+} encoder_t;
+
+protocol_encoder_handle_t protocol_encoder_create(void)
+{
+    encoder_t *enc = calloc(1, sizeof(encoder_t));
+    if (enc == NULL) {
+        return NULL;
+    }
+    enc->mutex = xSemaphoreCreateMutex();
+    enc->buf = malloc(CONFIG_LK_ENCODE_BUFFER_SIZE);
+    if (enc->mutex == NULL || enc->buf == NULL) {
+        protocol_encoder_destroy(enc);
+        return NULL;
+    }
+    enc->capacity = CONFIG_LK_ENCODE_BUFFER_SIZE;
+    return enc;
+}
+
+void protocol_encoder_destroy(protocol_encoder_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    encoder_t *enc = (encoder_t *)handle;
+#if CONFIG_LK_BENCHMARK
+    if (enc->stats.encodes > 0) {
+        ESP_LOGI(TAG, "[BENCH] Encoded %" PRIu32 " messages: avg=%" PRIu64 "us, max=%" PRIu32 "us, grows=%" PRIu32 ", oversized=%" PRIu32 ", capacity=%u",
+            enc->stats.encodes,
+            enc->stats.encode_time_us / enc->stats.encodes,
+            enc->stats.max_encode_time_us,
+            enc->stats.grows,
+            enc->stats.oversized,
+            (unsigned)enc->capacity);
+    }
+#endif
+    if (enc->mutex != NULL) {
+        vSemaphoreDelete(enc->mutex);
+    }
+    free(enc->buf);
+    free(enc);
+}
+
+/// Returns a buffer of at least `size` bytes for a message that did not fit.
+static uint8_t *buffer_for_size(encoder_t *enc, size_t size)
+{
+    if (size > CONFIG_LK_ENCODE_BUFFER_MAX_SIZE) {
+        enc->oversized_buf = malloc(size);
+        if (enc->oversized_buf != NULL) {
+            enc->stats.oversized++;
+        }
+        return enc->oversized_buf;
+    }
+    size_t capacity = enc->capacity * 2;
+    if (capacity < size) capacity = size;
+    if (capacity > CONFIG_LK_ENCODE_BUFFER_MAX_SIZE) capacity = CONFIG_LK_ENCODE_BUFFER_MAX_SIZE;
+
+    uint8_t *buf = realloc(enc->buf, capacity);
+    if (buf == NULL) {
+        return NULL;
+    }
+    enc->buf = buf;
+    enc->capacity = capacity;
+    enc->stats.grows++;
+    ESP_LOGD(TAG, "Grew encode buffer: capacity=%u", (unsigned)capacity);
+    return enc->buf;
+}
+
+static bool encode(
+    encoder_t *enc,
+    const pb_msgdesc_t *fields,
+    const void *msg,
+    const uint8_t **out,
+    size_t *out_size)
+{
+    if (enc == NULL || msg == NULL || out == NULL || out_size == NULL) {
+        return false;
+    }
+    xSemaphoreTake(enc->mutex, portMAX_DELAY);
+    int64_t start = esp_timer_get_time();
+
+    uint8_t *dest = enc->buf;
+    pb_ostream_t stream = pb_ostream_from_buffer((pb_byte_t *)dest, enc->capacity);
+    if (!pb_encode(&stream, fields, msg)) {
+        // Determine whether the scratch buffer was too small or encoding failed.
+        size_t size = 0;
+        if (!pb_get_encoded_size(&size, fields, msg) || size <= enc->capacity) {
+            ESP_LOGE(TAG, "Failed to encode message: error=%s", stream.errmsg);
+            xSemaphoreGive(enc->mutex);
+            return false;
+        }
+        dest = buffer_for_size(enc, size);
+        if (dest == NULL) {
+            ESP_LOGE(TAG, "No memory to encode message: size=%u", (unsigned)size);
+            xSemaphoreGive(enc->mutex);
+            return false;
+        }
+        stream = pb_ostream_from_buffer((pb_byte_t *)dest, size);
+        if (!pb_encode(&stream, fields, msg)) {
+            ESP_LOGE(TAG, "Failed to encode message: error=%s", stream.errmsg);
+            protocol_encoder_release(enc);
+            return false;
+        }
+    }
+
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    enc->stats.encodes++;
+    enc->stats.encode_time_us += elapsed;
+    if (elapsed > enc->stats.max_encode_time_us) {
+        enc->stats.max_encode_time_us = elapsed;
+    }
+    *out = dest;
+    *out_size = stream.bytes_written;
+    return true;
+}
+
+bool protocol_encoder_encode_signal_request(
+    protocol_encoder_handle_t handle,
+    const livekit_pb_signal_request_t *req,
+    const uint8_t **out,
+    size_t *out_size)
+{
+    return encode((encoder_t *)handle, LIVEKIT_PB_SIGNAL_REQUEST_FIELDS, req, out, out_size);
+}
+
+bool protocol_encoder_encode_data_packet(
+    protocol_encoder_handle_t handle,
+    const livekit_pb_data_packet_t *packet,
+    const uint8_t **out,
+    size_t *out_size)
+{
+    return encode((encoder_t *)handle, LIVEKIT_PB_DATA_PACKET_FIELDS, packet, out, out_size);
+}
+
+void protocol_encoder_release(protocol_encoder_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    encoder_t *enc = (encoder_t *)handle;
+    if (enc->oversized_buf != NULL) {
+        free(enc->oversized_buf);
+        enc->oversized_buf = NULL;
+    }
+    xSemaphoreGive(enc->mutex);
+}
+
+void protocol_encoder_get_stats(protocol_encoder_handle_t handle, protocol_encoder_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return;
+    }
+    encoder_t *enc = (encoder_t *)handle;
+    xSemaphoreTake(enc->mutex, portMAX_DELAY);
+    *stats = enc->stats;
+    stats->capacity = enc->capacity;
+    xSemaphoreGive(enc->mutex);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Reusable scratch buffer for encoding outgoing messages.
+///
+/// Messages are encoded in a single pass into a buffer owned by the encoder,
+/// which grows on demand up to `CONFIG_LK_ENCODE_BUFFER_MAX_SIZE`. Larger messages
+/// are encoded into a one-off allocation without growing the scratch buffer.
+///
+/// An encode call locks the encoder until `protocol_encoder_release` is called,
+/// so the encoded bytes can be sent directly from the scratch buffer.
+///
+typedef void *protocol_encoder_handle_t;
+
+/// Encoder counters.
+typedef struct {
+    /// Number of messages encoded.
+    uint32_t encodes;
+    /// Total time spent encoding in microseconds.
+    uint64_t encode_time_us;
+    /// Longest single encode in microseconds.
+    uint32_t max_encode_time_us;
+    /// Number of times the scratch buffer was grown.
+    uint32_t grows;
+    /// Number of messages too large for the scratch buffer.
+    uint32_t oversized;
+    /// Current scratch buffer capacity in bytes.
+    size_t capacity;
+} protocol_encoder_stats_t;
+
+/// Creates an encoder with the initial scratch capacity `CONFIG_LK_ENCODE_BUFFER_SIZE`.
+protocol_encoder_handle_t protocol_encoder_create(void);
+
+/// Destroys an encoder.
+void protocol_encoder_destroy(protocol_encoder_handle_t handle);
+
+/// Encodes a signal request.
+///
+/// On success, `out` and `out_size` describe the encoded bytes, which remain valid
+/// until `protocol_encoder_release` is called. On failure, the encoder is not locked.
+///
+bool protocol_encoder_encode_signal_request(
+    protocol_encoder_handle_t handle,
+    const livekit_pb_signal_request_t *req,
+    const uint8_t **out,
+    size_t *out_size
+);
+
+/// Encodes a data packet.
+///
+/// On success, `out` and `out_size` describe the encoded bytes, which remain valid
+/// until `protocol_encoder_release` is called. On failure, the encoder is not locked.
+///
+bool protocol_encoder_encode_data_packet(
+    protocol_encoder_handle_t handle,
+    const livekit_pb_data_packet_t *packet,
+    const uint8_t **out,
+    size_t *out_size
+);
+
+/// Releases the bytes from the last successful encode and unlocks the encoder.
+void protocol_encoder_release(protocol_encoder_handle_t handle);
+
+/// Returns the encoder's counters.
+void protocol_encoder_get_stats(protocol_encoder_handle_t handle, protocol_encoder_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
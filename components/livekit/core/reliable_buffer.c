@@ -0,0 +1,268 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#include "reliable_buffer.h"
+
+static const char *TAG = "livekit_reliable_buf";
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+} entry_t;
+
+typedef struct {
+    SemaphoreHandle_t mutex;
+    livekit_data_buffer_policy_t policy;
+    /// Given whenever packets leave the buffer to wake blocked senders.
+    SemaphoreHandle_t space_sem;
+    entry_t entries[CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS];
+    uint16_t head;
+    uint16_t count;
+    size_t bytes;
+    livekit_data_buffer_stats_t stats;
+} reliable_buffer_t;
+
+static inline bool has_space(const reliable_buffer_t *buf, size_t size)
+{
+    return buf->count < CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS &&
+        buf->bytes + size <= CONFIG_LK_RELIABLE_BUFFER_SIZE;
+}
+
+/// Removes the oldest entry. Must be called with the mutex held.
+static void pop_head(reliable_buffer_t *buf)
+{
+    entry_t *entry = &buf->entries[buf->head];
+    buf->bytes -= entry->size;
+    free(entry->data);
+    entry->data = NULL;
+    entry->size = 0;
+    buf->head = (uint16_t)((buf->head + 1) % CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS);
+    buf->count--;
+}
+
+static inline void signal_space(reliable_buffer_t *buf)
+{
+    if (buf->policy == LIVEKIT_DATA_BUFFER_POLICY_BLOCK) {
+        xSemaphoreGive(buf->space_sem);
+    }
+}
+
+/// Waits for space while the buffer is full. Must be called with the mutex held.
+static bool wait_for_space(reliable_buffer_t *buf, size_t size)
+{
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(CONFIG_LK_RELIABLE_BUFFER_BLOCK_TIMEOUT_MS);
+    while (!has_space(buf, size)) {
+        xSemaphoreGive(buf->mutex);
+        TickType_t now = xTaskGetTickCount();
+        bool woke = (int32_t)(deadline - now) > 0 &&
+            xSemaphoreTake(buf->space_sem, deadline - now) == pdTRUE;
+        xSemaphoreTake(buf->mutex, portMAX_DELAY);
+        if (!woke && !has_space(buf, size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static livekit_data_buffer_policy_t default_policy(void)
+{
+#if CONFIG_LK_RELIABLE_BUFFER_POLICY_REJECT
+    return LIVEKIT_DATA_BUFFER_POLICY_REJECT;
+#elif CONFIG_LK_RELIABLE_BUFFER_POLICY_BLOCK
+    return LIVEKIT_DATA_BUFFER_POLICY_BLOCK;
+#else
+    return LIVEKIT_DATA_BUFFER_POLICY_DROP_OLDEST;
+#endif
+}
+
+reliable_buffer_handle_t reliable_buffer_create(livekit_data_buffer_policy_t policy)
+{
+    if (policy > LIVEKIT_DATA_BUFFER_POLICY_BLOCK) {
+        return NULL;
+    }
+    reliable_buffer_t *buf = calloc(1, sizeof(reliable_buffer_t));
+    if (buf == NULL) {
+        return NULL;
+    }
+    buf->policy = policy != LIVEKIT_DATA_BUFFER_POLICY_DEFAULT ? policy : default_policy();
+    buf->mutex = xSemaphoreCreateMutex();
+    if (buf->mutex == NULL) {
+        free(buf);
+        return NULL;
+    }
+    if (buf->policy == LIVEKIT_DATA_BUFFER_POLICY_BLOCK) {
+        buf->space_sem = xSemaphoreCreateBinary();
+        if (buf->space_sem == NULL) {
+            vSemaphoreDelete(buf->mutex);
+            free(buf);
+            return NULL;
+        }
+    }
+    return buf;
+}
+
+void reliable_buffer_destroy(reliable_buffer_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    reliable_buffer_t *buf = (reliable_buffer_t *)handle;
+    while (buf->count > 0) {
+        pop_head(buf);
+    }
+    if (buf->space_sem != NULL) {
+        vSemaphoreDelete(buf->space_sem);
+    }
+    vSemaphoreDelete(buf->mutex);
+    free(buf);
+}
+
+reliable_buffer_err_t reliable_buffer_push(reliable_buffer_handle_t handle, const uint8_t *data, size_t size)
+{
+    if (handle == NULL || data == NULL || size == 0) {
+        return RELIABLE_BUFFER_ERR_INVALID_ARG;
+    }
+    reliable_buffer_t *buf = (reliable_buffer_t *)handle;
+
+    if (size > CONFIG_LK_RELIABLE_BUFFER_SIZE) {
+        xSemaphoreTake(buf->mutex, portMAX_DELAY);
+        buf->stats.rejected++;
+        xSemaphoreGive(buf->mutex);
+        return RELIABLE_BUFFER_ERR_FULL;
+    }
+
+    // Copy outside the lock; buffered packets may sit for seconds, so prefer PSRAM.
+    uint8_t *copy = heap_caps_malloc_prefer(size, 2,
+        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT);
+    if (copy == NULL) {
+        return RELIABLE_BUFFER_ERR_NO_MEM;
+    }
+    memcpy(copy, data, size);
+
+    xSemaphoreTake(buf->mutex, portMAX_DELAY);
+    bool is_accepted = true;
+    switch (buf->policy) {
+        case LIVEKIT_DATA_BUFFER_POLICY_DROP_OLDEST:
+            while (!has_space(buf, size)) {
+                pop_head(buf);
+                buf->stats.dropped++;
+            }
+            break;
+        case LIVEKIT_DATA_BUFFER_POLICY_BLOCK:
+            is_accepted = wait_for_space(buf, size);
+            break;
+        default:
+            is_accepted = has_space(buf, size);
+            break;
+    }
+    if (!is_accepted) {
+        buf->stats.rejected++;
+        xSemaphoreGive(buf->mutex);
+        free(copy);
+        return RELIABLE_BUFFER_ERR_FULL;
+    }
+    uint16_t tail = (uint16_t)((buf->head + buf->count) % CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS);
+    buf->entries[tail] = (entry_t){ .data = copy, .size = size };
+    buf->count++;
+    buf->bytes += size;
+    buf->stats.total_buffered++;
+    xSemaphoreGive(buf->mutex);
+    return RELIABLE_BUFFER_ERR_NONE;
+}
+
+bool reliable_buffer_flush(reliable_buffer_handle_t handle, reliable_buffer_send_fn_t send, void *ctx)
+{
+    if (handle == NULL || send == NULL) {
+        return false;
+    }
+    reliable_buffer_t *buf = (reliable_buffer_t *)handle;
+
+    // The lock is held while sending so that entries cannot be dropped mid-send
+    // and packets sent concurrently queue behind the ones being flushed.
+    xSemaphoreTake(buf->mutex, portMAX_DELAY);
+    uint32_t flushed = 0;
+    while (buf->count > 0) {
+        entry_t *entry = &buf->entries[buf->head];
+        if (!send(entry->data, entry->size, ctx)) {
+            ESP_LOGW(TAG, "Flush stopped: %u packets remain", buf->count);
+            break;
+        }
+        pop_head(buf);
+        buf->stats.sent++;
+        flushed++;
+    }
+    bool drained = buf->count == 0;
+    xSemaphoreGive(buf->mutex);
+
+    if (flushed > 0) {
+        ESP_LOGD(TAG, "Flushed %" PRIu32 " buffered packets", flushed);
+        signal_space(buf);
+    }
+    return drained;
+}
+
+void reliable_buffer_clear(reliable_buffer_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    reliable_buffer_t *buf = (reliable_buffer_t *)handle;
+    xSemaphoreTake(buf->mutex, portMAX_DELAY);
+    uint16_t cleared = buf->count;
+    while (buf->count > 0) {
+        pop_head(buf);
+    }
+    buf->stats.dropped += cleared;
+    xSemaphoreGive(buf->mutex);
+
+    if (cleared > 0) {
+        ESP_LOGW(TAG, "Dropped %u buffered packets", cleared);
+        signal_space(buf);
+    }
+}
+
+bool reliable_buffer_is_empty(reliable_buffer_handle_t handle)
+{
+    if (handle == NULL) {
+        return true;
+    }
+    reliable_buffer_t *buf = (reliable_buffer_t *)handle;
+    xSemaphoreTake(buf->mutex, portMAX_DELAY);
+    bool empty = buf->count == 0;
+    xSemaphoreGive(buf->mutex);
+    return empty;
+}
+
+void reliable_buffer_get_stats(reliable_buffer_handle_t handle, livekit_data_buffer_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return;
+    }
+    reliable_buffer_t *buf = (reliable_buffer_t *)handle;
+    xSemaphoreTake(buf->mutex, portMAX_DELAY);
+    *stats = buf->stats;
+    stats->buffered = buf->count;
+    stats->buffered_bytes = buf->bytes;
+    xSemaphoreGive(buf->mutex);
+}
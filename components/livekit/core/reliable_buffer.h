@@ -0,0 +1,76 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "livekit_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Bounded FIFO of encoded reliable data packets held while the engine is not connected.
+///
+/// Capacity is limited both by packet count (`CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS`) and
+/// total bytes (`CONFIG_LK_RELIABLE_BUFFER_SIZE`); what happens when either limit is
+/// reached is determined by the policy the buffer is created with.
+///
+typedef void *reliable_buffer_handle_t;
+
+typedef enum {
+    RELIABLE_BUFFER_ERR_NONE        =  0,
+    RELIABLE_BUFFER_ERR_INVALID_ARG = -1,
+    RELIABLE_BUFFER_ERR_NO_MEM      = -2,
+    RELIABLE_BUFFER_ERR_FULL        = -3, // Rejected by the overflow policy.
+} reliable_buffer_err_t;
+
+/// Sends a single encoded packet; returns false if the packet could not be sent.
+typedef bool (*reliable_buffer_send_fn_t)(const uint8_t *data, size_t size, void *ctx);
+
+/// Creates a buffer.
+///
+/// @param policy Overflow policy; @ref LIVEKIT_DATA_BUFFER_POLICY_DEFAULT selects
+///               the `CONFIG_LK_RELIABLE_BUFFER_POLICY` choice.
+///
+reliable_buffer_handle_t reliable_buffer_create(livekit_data_buffer_policy_t policy);
+
+/// Destroys a buffer, discarding any buffered packets.
+void reliable_buffer_destroy(reliable_buffer_handle_t handle);
+
+/// Appends a copy of an encoded packet to the buffer.
+reliable_buffer_err_t reliable_buffer_push(reliable_buffer_handle_t handle, const uint8_t *data, size_t size);
+
+/// Sends buffered packets in order until the buffer is empty or a send fails.
+///
+/// @returns True if the buffer was fully drained.
+///
+bool reliable_buffer_flush(reliable_buffer_handle_t handle, reliable_buffer_send_fn_t send, void *ctx);
+
+/// Discards all buffered packets, counting them as dropped.
+void reliable_buffer_clear(reliable_buffer_handle_t handle);
+
+/// Returns whether the buffer holds no packets.
+bool reliable_buffer_is_empty(reliable_buffer_handle_t handle);
+
+/// Returns the buffer's counters.
+void reliable_buffer_get_stats(reliable_buffer_handle_t handle, livekit_data_buffer_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,15 +23,17 @@
 #endif
 #include "esp_websocket_client.h"
 #include "esp_tls.h"
+#include "pb_encode.h"
 
 #include "protocol.h"
+#include "protocol_encoder.h"
 #include "signaling.h"
 #include "url.h"
 #include "utils.h"
+#include "ws_reassembler.h"
 
 static const char *TAG = "livekit_signaling";
 
-#define SIGNAL_WS_BUFFER_SIZE          20 * 1024
 #define SIGNAL_WS_RECONNECT_TIMEOUT_MS 1000
 #define SIGNAL_WS_NETWORK_TIMEOUT_MS   10000
 #define SIGNAL_WS_CLOSE_CODE           1000
@@ -45,6 +47,9 @@ typedef struct {
     TimerHandle_t ping_interval_timer;
     TimerHandle_t ping_timeout_timer;
     int64_t rtt;
+    protocol_encoder_handle_t encoder;
+    /// Reassembles responses received in several chunks or frames.
+    ws_reassembler_handle_t reassembler;
 
 #if CONFIG_LK_BENCHMARK
     uint64_t start_time;
@@ -70,30 +75,20 @@ static inline signal_state_t failed_state_from_http_status(int status)
 
 static signal_err_t send_request(signal_t *sg, livekit_pb_signal_request_t *request)
 {
-    size_t encoded_size = protocol_signal_request_encoded_size(request);
-    if (encoded_size == 0) {
+    const uint8_t *enc_buf = NULL;
+    size_t encoded_size = 0;
+    if (!protocol_encoder_encode_signal_request(sg->encoder, request, &enc_buf, &encoded_size)) {
         return SIGNAL_ERR_MESSAGE;
     }
-    uint8_t *enc_buf = (uint8_t *)malloc(encoded_size);
-    if (enc_buf == NULL) {
-        return SIGNAL_ERR_NO_MEM;
-    }
     int ret = SIGNAL_ERR_NONE;
-    do {
-        if (!protocol_signal_request_encode(request, enc_buf, encoded_size)) {
-            ret = SIGNAL_ERR_MESSAGE;
-            break;
-        }
-        if (esp_websocket_client_send_bin(sg->ws,
-                (const char *)enc_buf,
-                (int)encoded_size,
-                portMAX_DELAY) < 0) {
-            //ESP_LOGE(TAG, "Failed to send request");
-            ret = SIGNAL_ERR_MESSAGE;
-            break;
-        }
-    } while (0);
-    free(enc_buf);
+    if (esp_websocket_client_send_bin(sg->ws,
+            (const char *)enc_buf,
+            (int)encoded_size,
+            portMAX_DELAY) < 0) {
+        //ESP_LOGE(TAG, "Failed to send request");
+        ret = SIGNAL_ERR_MESSAGE;
+    }
+    protocol_encoder_release(sg->encoder);
     return ret;
 }
 
@@ -119,7 +114,8 @@ static void on_ping_timeout_expired(TimerHandle_t handle)
 static inline bool res_middleware(signal_t *sg, livekit_pb_signal_response_t *res)
 {
     if (res->which_message != LIVEKIT_PB_SIGNAL_RESPONSE_PONG_RESP_TAG &&
-        res->which_message != LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG) {
+        res->which_message != LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG &&
+        res->which_message != LIVEKIT_PB_SIGNAL_RESPONSE_RECONNECT_TAG) {
         return true;
     }
     switch (res->which_message) {
@@ -133,6 +129,11 @@ static inline bool res_middleware(signal_t *sg, livekit_pb_signal_response_t *re
             xTimerChangePeriod(sg->ping_timeout_timer, pdMS_TO_TICKS(ping_timeout_ms), 0);
             xTimerStart(sg->ping_timeout_timer, 0);
             return true;
+        case LIVEKIT_PB_SIGNAL_RESPONSE_RECONNECT_TAG:
+            // Resumed session: keep the intervals from the original join.
+            xTimerStart(sg->ping_interval_timer, 0);
+            xTimerStart(sg->ping_timeout_timer, 0);
+            return true;
         case LIVEKIT_PB_SIGNAL_RESPONSE_PONG_RESP_TAG:
             livekit_pb_pong_t *pong = &res->message.pong_resp;
             // Calculate round trip time (RTT) and restart ping timeout timer.
@@ -144,6 +145,60 @@ static inline bool res_middleware(signal_t *sg, livekit_pb_signal_response_t *re
     }
 }
 
+/// Decodes a complete response and forwards it to the receiver.
+static void handle_message(signal_t *sg, const uint8_t *message, size_t len)
+{
+    // Decoded in place into storage the receiver can keep, so taking ownership
+    // does not copy the response.
+    livekit_pb_signal_response_t *res = sg->options.alloc_res(sg->options.ctx);
+    if (res == NULL) {
+        ESP_LOGE(TAG, "Dropped signal response: no storage");
+        return;
+    }
+    memset(res, 0, sizeof(*res));
+
+    // Participant lists are decoded from the message when visited, so responses
+    // carrying them take the message with them: a reassembled one is detached
+    // from the reassembler, while one received in a single chunk is still in the
+    // client's buffer and is copied.
+    bool owned = false;
+    if (protocol_signal_response_refers_to_buffer(message, len)) {
+        uint8_t *buf = ws_reassembler_take(sg->reassembler);
+        if (buf == NULL) {
+            buf = malloc(len);
+            if (buf == NULL) {
+                ESP_LOGE(TAG, "Dropped signal response: no memory for %zu bytes", len);
+                sg->options.free_res(res, sg->options.ctx);
+                return;
+            }
+            memcpy(buf, message, len);
+        }
+        message = buf;
+        owned = true;
+    }
+    if (!protocol_signal_response_decode(message, len, owned, res)) {
+        sg->options.free_res(res, sg->options.ctx);
+        return;
+    }
+    if (res->which_message == 0) {
+        // Response type is not supported yet.
+        protocol_signal_response_free(res);
+        sg->options.free_res(res, sg->options.ctx);
+        return;
+    }
+    if (!res_middleware(sg, res)) {
+        // Don't forward.
+        protocol_signal_response_free(res);
+        sg->options.free_res(res, sg->options.ctx);
+        return;
+    }
+    if (!sg->options.on_res(res, sg->options.ctx)) {
+        // Ownership was not taken.
+        protocol_signal_response_free(res);
+        sg->options.free_res(res, sg->options.ctx);
+    }
+}
+
 static void on_ws_event(void *ctx, esp_event_base_t base, int32_t event_id, void *event_data)
 {
     signal_t *sg = (signal_t *)ctx;
@@ -155,11 +210,13 @@ static void on_ws_event(void *ctx, esp_event_base_t base, int32_t event_id, void
             sg->start_time = get_unix_time_ms();
 #endif
             sg->is_terminal_state = false;
+            ws_reassembler_reset(sg->reassembler);
             change_state(sg, SIGNAL_STATE_CONNECTING);
             break;
         case WEBSOCKET_EVENT_CLOSED:
         case WEBSOCKET_EVENT_DISCONNECTED:
         case WEBSOCKET_EVENT_FINISH:
+            ws_reassembler_reset(sg->reassembler);
             if (sg->is_terminal_state) {
                 break;
             }
@@ -190,28 +247,31 @@ static void on_ws_event(void *ctx, esp_event_base_t base, int32_t event_id, void
             change_state(sg, SIGNAL_STATE_CONNECTED);
             break;
         case WEBSOCKET_EVENT_DATA:
-            if (data->op_code != WS_TRANSPORT_OPCODES_BINARY) {
+            if (data->data_len < 0 || data->payload_len < 0 || data->payload_offset < 0) {
                 break;
             }
-            if (data->data_len < 1) break;
-            livekit_pb_signal_response_t res = {};
-            if (!protocol_signal_response_decode((const uint8_t *)data->data_ptr, (size_t)data->data_len, &res)) {
+            // Frames larger than the client's buffer arrive in several chunks,
+            // and messages may be split into several frames.
+            ws_reassembler_chunk_t chunk = {
+                .opcode = data->op_code,
+                .fin = data->fin,
+                .data = (const uint8_t *)data->data_ptr,
+                .data_len = (size_t)data->data_len,
+                .payload_offset = (size_t)data->payload_offset,
+                .payload_len = (size_t)data->payload_len
+            };
+            const uint8_t *message = NULL;
+            size_t message_len = 0;
+            ws_reassembler_err_t err = ws_reassembler_push(sg->reassembler, &chunk, &message, &message_len);
+            if (err != WS_REASSEMBLER_ERR_NONE) {
+                ESP_LOGE(TAG, "Dropped signal response: error=%d, payload_len=%d", err, data->payload_len);
                 break;
             }
-            if (res.which_message == 0) {
-                // Response type is not supported yet.
-                protocol_signal_response_free(&res);
-                break;
-            }
-            if (!res_middleware(sg, &res)) {
-                // Don't forward.
-                protocol_signal_response_free(&res);
-                break;
-            }
-            if (!sg->options.on_res(&res, sg->options.ctx)) {
-                // Ownership was not taken.
-                protocol_signal_response_free(&res);
+            if (message == NULL || message_len < 1) break;
+            if (message != chunk.data) {
+                ESP_LOGD(TAG, "Reassembled signal response: size=%zu", message_len);
             }
+            handle_message(sg, message, message_len);
             break;
         default:
             break;
@@ -222,6 +282,8 @@ signal_handle_t signal_init(const signal_options_t *options)
 {
     if (options == NULL ||
         options->on_state_changed == NULL ||
+        options->alloc_res == NULL ||
+        options->free_res == NULL ||
         options->on_res == NULL) {
         return NULL;
     }
@@ -231,6 +293,14 @@ signal_handle_t signal_init(const signal_options_t *options)
     }
     sg->options = *options;
 
+    sg->encoder = protocol_encoder_create();
+    if (sg->encoder == NULL) {
+        goto _init_failed;
+    }
+    sg->reassembler = ws_reassembler_create(CONFIG_LK_SIGNAL_MAX_MESSAGE_SIZE);
+    if (sg->reassembler == NULL) {
+        goto _init_failed;
+    }
     sg->ping_interval_timer = xTimerCreate(
         "ping_interval",
         pdMS_TO_TICKS(1000), // Will be overwritten before start
@@ -253,7 +323,7 @@ signal_handle_t signal_init(const signal_options_t *options)
     }
     // URL will be set on connect
     static esp_websocket_client_config_t ws_config = {
-        .buffer_size = SIGNAL_WS_BUFFER_SIZE,
+        .buffer_size = CONFIG_LK_SIGNAL_WS_BUFFER_SIZE,
         .disable_pingpong_discon = true,
         .network_timeout_ms = SIGNAL_WS_NETWORK_TIMEOUT_MS,
         .disable_auto_reconnect = true,
@@ -298,22 +368,16 @@ signal_err_t signal_destroy(signal_handle_t handle)
     if (sg->ws != NULL) {
         esp_websocket_client_destroy(sg->ws);
     }
+    protocol_encoder_destroy(sg->encoder);
+    ws_reassembler_destroy(sg->reassembler);
     free(sg);
     return SIGNAL_ERR_NONE;
 }
 
-signal_err_t signal_connect(signal_handle_t handle, const char* server_url, const char* token)
+static signal_err_t connect_with_options(signal_t *sg, const url_build_options *options, const char* token)
 {
-    if (server_url == NULL || token == NULL || handle == NULL) {
-        return SIGNAL_ERR_INVALID_ARG;
-    }
-    signal_t *sg = (signal_t *)handle;
-
     char* url = NULL;
-    url_build_options options = {
-        .server_url = server_url
-    };
-    if (!url_build(&options, &url)) {
+    if (!url_build(options, &url)) {
         return SIGNAL_ERR_INVALID_URL;
     }
     ESP_LOGI(TAG, "Connecting to server: %s", url);
@@ -345,6 +409,35 @@ signal_err_t signal_connect(signal_handle_t handle, const char* server_url, cons
     return SIGNAL_ERR_NONE;
 }
 
+signal_err_t signal_connect(signal_handle_t handle, const char* server_url, const char* token)
+{
+    if (server_url == NULL || token == NULL || handle == NULL) {
+        return SIGNAL_ERR_INVALID_ARG;
+    }
+    url_build_options options = {
+        .server_url = server_url
+    };
+    return connect_with_options((signal_t *)handle, &options, token);
+}
+
+signal_err_t signal_resume(
+    signal_handle_t handle,
+    const char* server_url,
+    const char* token,
+    const char* participant_sid,
+    livekit_pb_reconnect_reason_t reason
+) {
+    if (server_url == NULL || token == NULL || participant_sid == NULL || handle == NULL) {
+        return SIGNAL_ERR_INVALID_ARG;
+    }
+    url_build_options options = {
+        .server_url = server_url,
+        .resume_participant_sid = participant_sid,
+        .resume_reason = reason
+    };
+    return connect_with_options((signal_t *)handle, &options, token);
+}
+
 signal_err_t signal_close(signal_handle_t handle)
 {
     if (handle == NULL) {
@@ -437,4 +530,58 @@ signal_err_t signal_send_update_subscription(signal_handle_t handle, const char
     req.which_message = LIVEKIT_PB_SIGNAL_REQUEST_SUBSCRIPTION_TAG;
     req.message.subscription = subscription;
     return send_request(sg, &req);
-}
\ No newline at end of file
+}
+
+static bool encode_track_sid(pb_ostream_t *stream, const pb_field_t *field, void * const *arg)
+{
+    const char *sid = (const char *)*arg;
+    return pb_encode_tag_for_field(stream, field) &&
+        pb_encode_string(stream, (const pb_byte_t *)sid, strlen(sid));
+}
+
+signal_err_t signal_send_update_track_settings(signal_handle_t handle, const char *sid, bool disabled)
+{
+    if (sid == NULL || handle == NULL) {
+        return SIGNAL_ERR_INVALID_ARG;
+    }
+    signal_t *sg = (signal_t *)handle;
+    livekit_pb_signal_request_t req = LIVEKIT_PB_SIGNAL_REQUEST_INIT_ZERO;
+
+    livekit_pb_update_track_settings_t settings = LIVEKIT_PB_UPDATE_TRACK_SETTINGS_INIT_ZERO;
+    settings.track_sids.funcs.encode = encode_track_sid;
+    settings.track_sids.arg = (void *)sid;
+    settings.disabled = disabled;
+    req.which_message = LIVEKIT_PB_SIGNAL_REQUEST_TRACK_SETTING_TAG;
+    req.message.track_setting = settings;
+    return send_request(sg, &req);
+}
+
+signal_err_t signal_send_update_video_track(signal_handle_t handle, const char *sid, uint32_t width, uint32_t height)
+{
+    if (sid == NULL || handle == NULL) {
+        return SIGNAL_ERR_INVALID_ARG;
+    }
+    signal_t *sg = (signal_t *)handle;
+    livekit_pb_signal_request_t req = LIVEKIT_PB_SIGNAL_REQUEST_INIT_ZERO;
+
+    livekit_pb_update_local_video_track_t update = LIVEKIT_PB_UPDATE_LOCAL_VIDEO_TRACK_INIT_ZERO;
+    update.track_sid.funcs.encode = encode_track_sid;
+    update.track_sid.arg = (void *)sid;
+    update.width = width;
+    update.height = height;
+    req.which_message = LIVEKIT_PB_SIGNAL_REQUEST_UPDATE_VIDEO_TRACK_TAG;
+    req.message.update_video_track = update;
+    return send_request(sg, &req);
+}
+
+signal_err_t signal_send_sync_state(signal_handle_t handle, const livekit_pb_sync_state_t *sync_state)
+{
+    if (handle == NULL || sync_state == NULL) {
+        return SIGNAL_ERR_INVALID_ARG;
+    }
+    signal_t *sg = (signal_t *)handle;
+    livekit_pb_signal_request_t req = LIVEKIT_PB_SIGNAL_REQUEST_INIT_ZERO;
+    req.which_message = LIVEKIT_PB_SIGNAL_REQUEST_SYNC_STATE_TAG;
+    req.message.sync_state = *sync_state;
+    return send_request(sg, &req);
+}
@@ -82,11 +82,22 @@ typedef struct {
     /// Invoked when the connection state changes.
     void (*on_state_changed)(signal_state_t state, void *ctx);
 
+    /// Invoked to provide storage a received signal response is decoded into.
+    ///
+    /// Returns NULL if none is available, dropping the response. Storage is
+    /// returned with `free_res` unless the receiver takes ownership of the
+    /// response in `on_res`.
+    ///
+    livekit_pb_signal_response_t *(*alloc_res)(void *ctx);
+
+    /// Invoked to return storage provided by `alloc_res`.
+    void (*free_res)(livekit_pb_signal_response_t *res, void *ctx);
+
     /// Invoked when a signal response is received.
     ///
     /// The receiver returns true to take ownership of the response. If
     /// ownership is not taken (false), the response will be freed with
-    /// `protocol_signal_response_free` internally.
+    /// `protocol_signal_response_free` internally and its storage returned.
     ///
     bool (*on_res)(livekit_pb_signal_response_t *res, void *ctx);
 } signal_options_t;
@@ -98,6 +109,20 @@ signal_err_t signal_destroy(signal_handle_t handle);
 /// @note This function will close the existing connection if already connected.
 signal_err_t signal_connect(signal_handle_t handle, const char* server_url, const char* token);
 
+/// Establishes the WebSocket connection, resuming the session of an existing participant.
+///
+/// On success, the server responds with `ReconnectResponse` instead of `JoinResponse`
+/// and the existing peer connections can be kept.
+///
+/// @note This function will close the existing connection if already connected.
+signal_err_t signal_resume(
+    signal_handle_t handle,
+    const char* server_url,
+    const char* token,
+    const char* participant_sid,
+    livekit_pb_reconnect_reason_t reason
+);
+
 /// Closes the WebSocket connection
 signal_err_t signal_close(signal_handle_t handle);
 
@@ -109,6 +134,15 @@ signal_err_t signal_send_answer(signal_handle_t handle, const char *sdp);
 signal_err_t signal_send_add_track(signal_handle_t handle, livekit_pb_add_track_request_t *req);
 signal_err_t signal_send_update_subscription(signal_handle_t handle, const char *sid, bool subscribe);
 
+/// Pauses or resumes delivery of a subscribed track.
+signal_err_t signal_send_update_track_settings(signal_handle_t handle, const char *sid, bool disabled);
+
+/// Updates the advertised resolution of a published video track.
+signal_err_t signal_send_update_video_track(signal_handle_t handle, const char *sid, uint32_t width, uint32_t height);
+
+/// Sends the client's session state after a resume.
+signal_err_t signal_send_sync_state(signal_handle_t handle, const livekit_pb_sync_state_t *sync_state);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
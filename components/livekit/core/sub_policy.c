@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sub_policy.h"
+
+bool sub_policy_is_valid(const livekit_sub_policy_t *policy)
+{
+    switch (policy->type) {
+        case LIVEKIT_SUB_POLICY_ALL:
+        case LIVEKIT_SUB_POLICY_PARTICIPANT_KIND:
+            return true;
+        case LIVEKIT_SUB_POLICY_IDENTITY:
+            if (policy->identity_count > 0 && policy->identities == NULL) {
+                return false;
+            }
+            for (size_t i = 0; i < policy->identity_count; i++) {
+                if (policy->identities[i] == NULL) {
+                    return false;
+                }
+            }
+            return true;
+        case LIVEKIT_SUB_POLICY_CALLBACK:
+            return policy->should_subscribe != NULL;
+        default:
+            return false;
+    }
+}
+
+void sub_policy_free(livekit_sub_policy_t *policy)
+{
+    if (policy->identities != NULL) {
+        for (size_t i = 0; i < policy->identity_count; i++) {
+            free((char *)policy->identities[i]);
+        }
+        free((void *)policy->identities);
+    }
+    memset(policy, 0, sizeof(*policy));
+}
+
+livekit_err_t sub_policy_copy(livekit_sub_policy_t *dest, const livekit_sub_policy_t *src)
+{
+    *dest = *src;
+    dest->identities = NULL;
+    dest->identity_count = 0;
+    if (src->type != LIVEKIT_SUB_POLICY_IDENTITY || src->identity_count == 0) {
+        return LIVEKIT_ERR_NONE;
+    }
+    char **identities = calloc(src->identity_count, sizeof(char *));
+    if (identities == NULL) {
+        return LIVEKIT_ERR_NO_MEM;
+    }
+    dest->identities = (const char* const*)identities;
+    for (size_t i = 0; i < src->identity_count; i++) {
+        identities[i] = strdup(src->identities[i]);
+        if (identities[i] == NULL) {
+            sub_policy_free(dest);
+            return LIVEKIT_ERR_NO_MEM;
+        }
+        dest->identity_count = i + 1;
+    }
+    return LIVEKIT_ERR_NONE;
+}
+
+sub_policy_decision_t sub_policy_evaluate(
+    const livekit_sub_policy_t *policy,
+    const livekit_pb_participant_info_t *participant
+) {
+    switch (policy->type) {
+        case LIVEKIT_SUB_POLICY_IDENTITY:
+            for (size_t i = 0; i < policy->identity_count && participant->identity != NULL; i++) {
+                if (strcmp(policy->identities[i], participant->identity) == 0) {
+                    return SUB_POLICY_ALLOW;
+                }
+            }
+            return SUB_POLICY_DENY;
+        case LIVEKIT_SUB_POLICY_PARTICIPANT_KIND:
+            return (policy->participant_kinds & LIVEKIT_PARTICIPANT_KIND_BIT(participant->kind)) != 0 ?
+                SUB_POLICY_ALLOW : SUB_POLICY_DENY;
+        case LIVEKIT_SUB_POLICY_CALLBACK:
+            return SUB_POLICY_ASK;
+        default:
+            return SUB_POLICY_ALLOW;
+    }
+}
+
+bool sub_policy_reserve(sub_policy_counts_t *counts, livekit_pb_track_type_t type)
+{
+    bool is_video = type == LIVEKIT_PB_TRACK_TYPE_VIDEO;
+    int *count = is_video ? &counts->video : &counts->audio;
+    if (*count >= (is_video ? SUB_POLICY_MAX_VIDEO_TRACKS : SUB_POLICY_MAX_AUDIO_TRACKS)) {
+        return false;
+    }
+    (*count)++;
+    return true;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "livekit.h"
+#include "protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum number of remote audio tracks subscribed at once.
+///
+/// Subscribed audio is played through a single decoder, so frames from several
+/// tracks would interleave; more need each track decoded and mixed separately.
+///
+#define SUB_POLICY_MAX_AUDIO_TRACKS 1
+
+/// Maximum number of remote video tracks subscribed at once.
+///
+/// Subscribed video shares a single decoder and renderer, so frames from a second
+/// track would be fed to the same decoder and corrupt its reference frames.
+///
+#define SUB_POLICY_MAX_VIDEO_TRACKS 1
+
+/// Outcome of evaluating a subscription policy for a participant's track.
+typedef enum {
+    SUB_POLICY_DENY,
+    SUB_POLICY_ALLOW,
+    /// The policy's `should_subscribe` callback decides.
+    SUB_POLICY_ASK
+} sub_policy_decision_t;
+
+/// Subscriptions currently held, by media kind.
+typedef struct {
+    int audio;
+    int video;
+} sub_policy_counts_t;
+
+/// Returns whether a policy is well formed.
+bool sub_policy_is_valid(const livekit_sub_policy_t *policy);
+
+/// Copies a policy, including its identity strings.
+///
+/// Free the copy with `sub_policy_free`.
+///
+livekit_err_t sub_policy_copy(livekit_sub_policy_t *dest, const livekit_sub_policy_t *src);
+
+/// Frees a policy's identity strings and zeroes it.
+void sub_policy_free(livekit_sub_policy_t *policy);
+
+/// Decides whether a policy allows subscribing to a participant's tracks.
+sub_policy_decision_t sub_policy_evaluate(
+    const livekit_sub_policy_t *policy,
+    const livekit_pb_participant_info_t *participant
+);
+
+/// Takes a subscription slot for a track of the given type.
+///
+/// @return false if `SUB_POLICY_MAX_AUDIO_TRACKS` or `SUB_POLICY_MAX_VIDEO_TRACKS`
+///         tracks of that kind are already subscribed.
+///
+bool sub_policy_reserve(sub_policy_counts_t *counts, livekit_pb_track_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
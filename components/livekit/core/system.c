@@ -28,7 +28,7 @@ static void media_lib_scheduler(const char *name, media_lib_thread_cfg_t *cfg)
     // Thread names by components:
     // esp_capture: venc_0, aenc_0, buffer_in, AUD_SRC
     // av_render: Adec, ARender
-    // livekit: lk_peer_sub, lk_peer_pub, lk_eng_stream
+    // livekit: lk_peer_sub, lk_peer_pub, lk_peer_setup, lk_pub_audio, lk_pub_video, lk_sub_audio, lk_sub_video
 
     if (strcmp(name, "venc_0") == 0) {
 #if CONFIG_IDF_TARGET_ESP32S3
@@ -52,9 +52,29 @@ static void media_lib_scheduler(const char *name, media_lib_thread_cfg_t *cfg)
         cfg->stack_size = 25 * 1024;
         cfg->priority = 18;
         cfg->core_id = 1;
-    } else if (strcmp(name, "lk_eng_stream") == 0) {
+    } else if (strcmp(name, "lk_peer_setup") == 0) {
+        // Sets up the subscriber while the engine task sets up the publisher
+        cfg->stack_size = 8 * 1024;
+        cfg->priority = 5;
+        cfg->core_id = 1;
+    } else if (strcmp(name, "lk_pub_audio") == 0) {
+        // Higher priority than video so audio sends are never delayed by large video frames
         cfg->stack_size = 4 * 1024;
-        cfg->priority = 15;
+        cfg->priority = 16;
+        cfg->core_id = 1;
+    } else if (strcmp(name, "lk_pub_video") == 0) {
+        cfg->stack_size = 4 * 1024;
+        cfg->priority = 12;
+        cfg->core_id = 0;
+    } else if (strcmp(name, "lk_sub_audio") == 0) {
+        // Paces jitter buffer playout; above the decoder so frames are never released late
+        cfg->stack_size = 4 * 1024;
+        cfg->priority = 16;
+        cfg->core_id = 0;
+    } else if (strcmp(name, "lk_sub_video") == 0) {
+        // Decodes on this thread; below audio so video load never starves playout
+        cfg->stack_size = 8 * 1024;
+        cfg->priority = 9;
         cfg->core_id = 1;
     } else if (strcmp(name, "Adec") == 0) {
         cfg->stack_size = 40 * 1024;
@@ -15,6 +15,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "esp_log.h"
 #include "esp_idf_version.h"
@@ -41,6 +42,12 @@ static const char *TAG = "livekit_url";
     "&auto_subscribe=false" \
     "&protocol=" URL_PARAM_PROTOCOL
 
+/// Appended to resume an existing session instead of joining again.
+#define URL_RESUME_FORMAT \
+    "&reconnect=1" \
+    "&sid=%s" \
+    "&reconnect_reason=%d"
+
 bool url_build(const url_build_options *options, char **out_url)
 {
     if (out_url == NULL ||
@@ -77,5 +84,18 @@ bool url_build(const url_build_options *options, char **out_url)
     if (*out_url == NULL) {
         return false;
     }
+    if (options->resume_participant_sid != NULL) {
+        char *resume_url = NULL;
+        int ret = asprintf(&resume_url, "%s" URL_RESUME_FORMAT,
+            *out_url,
+            options->resume_participant_sid,
+            options->resume_reason
+        );
+        free(*out_url);
+        *out_url = ret < 0 ? NULL : resume_url;
+        if (*out_url == NULL) {
+            return false;
+        }
+    }
     return true;
 }
\ No newline at end of file
@@ -25,6 +25,13 @@ extern "C" {
 /// Options for building a signaling URL.
 typedef struct {
     const char *server_url;
+
+    /// SID of the local participant whose session should be resumed, or NULL
+    /// to join as a new participant.
+    const char *resume_participant_sid;
+
+    /// Why the session is being resumed (`livekit_pb_reconnect_reason_t`).
+    int resume_reason;
 } url_build_options;
 
 /// Constructs a signaling URL.
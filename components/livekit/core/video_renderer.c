@@ -0,0 +1,381 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "media_lib_os.h"
+
+#include "video_renderer.h"
+
+static const char *TAG = "livekit_video_renderer";
+
+/// Time between warnings while `video_renderer_destroy` waits for the task to exit.
+#define RENDER_TASK_JOIN_TIMEOUT_MS 2000
+
+/// Minimum time between two keyframe requests while waiting for a keyframe.
+#define KEYFRAME_REQUEST_INTERVAL_US (1000 * 1000)
+
+#define NAL_TYPE_SLICE 1
+#define NAL_TYPE_IDR   5
+#define NAL_TYPE_SPS   7
+
+typedef struct {
+    uint8_t *data;
+    uint32_t size;
+    uint32_t pts;
+    /// Wakes the task so it can observe shutdown.
+    bool stop;
+} render_item_t;
+
+typedef struct {
+    av_render_handle_t render;
+
+    QueueHandle_t queue;
+    SemaphoreHandle_t task_done_sem;
+    volatile bool is_running;
+    bool has_task;
+
+    /// Set after a drop; frames are discarded until the next keyframe. Only
+    /// accessed from the peer receive thread, like the fields below.
+    bool is_awaiting_keyframe;
+    /// Set with `is_awaiting_keyframe` when frames were dropped, so the keyframe
+    /// ending the wait also discards frames queued before the drop.
+    bool is_stale;
+    int64_t last_keyframe_request_us;
+    video_renderer_keyframe_cb_t on_keyframe_needed;
+    void *ctx;
+
+    SemaphoreHandle_t stats_mutex;
+    livekit_video_render_stats_t stats;
+    uint64_t total_decode_us;
+} renderer_t;
+
+static void render_task(void *arg)
+{
+    renderer_t *renderer = (renderer_t *)arg;
+    render_item_t item;
+
+    while (renderer->is_running) {
+        if (xQueueReceive(renderer->queue, &item, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (item.stop) {
+            break;
+        }
+        av_render_video_data_t video_data = {
+            .pts = item.pts,
+            .data = item.data,
+            .size = item.size,
+        };
+        // av_render decodes in the calling thread unless it was configured with a
+        // video decode FIFO, in which case this only measures the hand-off.
+        int64_t start_us = esp_timer_get_time();
+        int ret = av_render_add_video_data(renderer->render, &video_data);
+        uint32_t decode_us = (uint32_t)(esp_timer_get_time() - start_us);
+        free(item.data);
+
+        xSemaphoreTake(renderer->stats_mutex, portMAX_DELAY);
+        livekit_video_render_stats_t *stats = &renderer->stats;
+        if (ret == ESP_MEDIA_ERR_OK) {
+            stats->rendered++;
+            renderer->total_decode_us += decode_us;
+            if (decode_us > stats->max_decode_us) {
+                stats->max_decode_us = decode_us;
+            }
+        } else {
+            stats->decode_failed++;
+        }
+        xSemaphoreGive(renderer->stats_mutex);
+    }
+
+    xSemaphoreGive(renderer->task_done_sem);
+    media_lib_thread_destroy(NULL);
+}
+
+/// Frees queued frames, returning how many were discarded.
+static uint32_t flush_queue(renderer_t *renderer)
+{
+    uint32_t count = 0;
+    render_item_t item;
+    while (xQueueReceive(renderer->queue, &item, 0) == pdTRUE) {
+        if (!item.stop) {
+            free(item.data);
+            count++;
+        }
+    }
+    return count;
+}
+
+static inline void count_dropped(renderer_t *renderer, uint32_t count)
+{
+    xSemaphoreTake(renderer->stats_mutex, portMAX_DELAY);
+    renderer->stats.dropped += count;
+    xSemaphoreGive(renderer->stats_mutex);
+}
+
+/// Asks the sender for a keyframe unless one was requested recently.
+static void request_keyframe(renderer_t *renderer)
+{
+    if (renderer->on_keyframe_needed == NULL) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    if (renderer->last_keyframe_request_us != 0 &&
+        now_us - renderer->last_keyframe_request_us < KEYFRAME_REQUEST_INTERVAL_US) {
+        return;
+    }
+    renderer->last_keyframe_request_us = now_us;
+    xSemaphoreTake(renderer->stats_mutex, portMAX_DELAY);
+    renderer->stats.keyframe_requests++;
+    xSemaphoreGive(renderer->stats_mutex);
+    renderer->on_keyframe_needed(renderer->ctx);
+}
+
+/// Drops a frame that cannot be decoded and waits for the next keyframe.
+static void drop_until_keyframe(renderer_t *renderer)
+{
+    renderer->is_awaiting_keyframe = true;
+    renderer->is_stale = true;
+    count_dropped(renderer, 1);
+    request_keyframe(renderer);
+}
+
+bool video_renderer_is_keyframe(const uint8_t *data, size_t size)
+{
+    if (data == NULL) {
+        return false;
+    }
+    // Scan start codes (00 00 01; the 4-byte form ends the same way).
+    for (size_t i = 0; i + 3 < size; i++) {
+        if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1) {
+            continue;
+        }
+        uint8_t nal_type = data[i + 3] & 0x1F;
+        if (nal_type == NAL_TYPE_IDR || nal_type == NAL_TYPE_SPS) {
+            return true;
+        }
+        if (nal_type >= NAL_TYPE_SLICE && nal_type < NAL_TYPE_IDR) {
+            // Non-IDR slice: the remaining NAL units are slice data.
+            return false;
+        }
+        i += 3;
+    }
+    return false;
+}
+
+video_renderer_handle_t video_renderer_create(
+    av_render_handle_t render,
+    video_renderer_keyframe_cb_t on_keyframe_needed,
+    void *ctx
+) {
+    if (render == NULL) {
+        return NULL;
+    }
+    renderer_t *renderer = calloc(1, sizeof(renderer_t));
+    if (renderer == NULL) {
+        return NULL;
+    }
+    renderer->render = render;
+    renderer->on_keyframe_needed = on_keyframe_needed;
+    renderer->ctx = ctx;
+    renderer->is_running = true;
+    renderer->is_awaiting_keyframe = true;
+
+    renderer->queue = xQueueCreate(CONFIG_LK_SUB_VIDEO_QUEUE_SIZE, sizeof(render_item_t));
+    renderer->task_done_sem = xSemaphoreCreateBinary();
+    renderer->stats_mutex = xSemaphoreCreateMutex();
+    if (renderer->queue == NULL ||
+        renderer->task_done_sem == NULL ||
+        renderer->stats_mutex == NULL) {
+        goto _create_failed;
+    }
+    media_lib_thread_handle_t thread;
+    if (media_lib_thread_create_from_scheduler(&thread, "lk_sub_video", render_task, renderer) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create video render thread");
+        goto _create_failed;
+    }
+    renderer->has_task = true;
+    return renderer;
+
+_create_failed:
+    video_renderer_destroy(renderer);
+    return NULL;
+}
+
+void video_renderer_destroy(video_renderer_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    renderer_t *renderer = (renderer_t *)handle;
+    renderer->is_running = false;
+
+    if (renderer->has_task) {
+        // Discard pending frames first so the stop item always fits.
+        flush_queue(renderer);
+        render_item_t stop = { .stop = true };
+        xQueueSendToFront(renderer->queue, &stop, pdMS_TO_TICKS(RENDER_TASK_JOIN_TIMEOUT_MS));
+        // The task may still be decoding with the queue and stats below, so never give up.
+        while (xSemaphoreTake(renderer->task_done_sem, pdMS_TO_TICKS(RENDER_TASK_JOIN_TIMEOUT_MS)) != pdTRUE) {
+            ESP_LOGW(TAG, "Still waiting for video render task to exit");
+        }
+        renderer->has_task = false;
+#if CONFIG_LK_BENCHMARK
+        livekit_video_render_stats_t stats;
+        video_renderer_get_stats(renderer, &stats);
+        if (stats.received > 0) {
+            ESP_LOGI(TAG, "[BENCH] Rendered %" PRIu32 "/%" PRIu32 " video frames (%" PRIu32 "x%" PRIu32 "): dropped=%" PRIu32 ", avg_decode=%" PRIu32 "us, max_decode=%" PRIu32 "us",
+                stats.rendered,
+                stats.received,
+                stats.width,
+                stats.height,
+                stats.dropped,
+                stats.avg_decode_us,
+                stats.max_decode_us);
+        }
+#endif
+    }
+    if (renderer->queue != NULL) {
+        flush_queue(renderer);
+        vQueueDelete(renderer->queue);
+    }
+    if (renderer->task_done_sem != NULL) {
+        vSemaphoreDelete(renderer->task_done_sem);
+    }
+    if (renderer->stats_mutex != NULL) {
+        vSemaphoreDelete(renderer->stats_mutex);
+    }
+    free(renderer);
+}
+
+bool video_renderer_set_stream_info(video_renderer_handle_t handle, const esp_peer_video_stream_info_t *info)
+{
+    if (handle == NULL || info == NULL) {
+        return false;
+    }
+    renderer_t *renderer = (renderer_t *)handle;
+
+    av_render_video_info_t render_info = {
+        .width = (uint16_t)info->width,
+        .height = (uint16_t)info->height,
+        .fps = (uint8_t)info->fps,
+    };
+    switch (info->codec) {
+        case ESP_PEER_VIDEO_CODEC_H264:  render_info.codec = AV_RENDER_VIDEO_CODEC_H264; break;
+        case ESP_PEER_VIDEO_CODEC_MJPEG: render_info.codec = AV_RENDER_VIDEO_CODEC_MJPEG; break;
+        default:
+            ESP_LOGE(TAG, "Unsupported video codec: %d", info->codec);
+            return false;
+    }
+    ESP_LOGD(TAG, "Video render info: codec=%d, width=%d, height=%d, fps=%d",
+        render_info.codec, info->width, info->height, info->fps);
+
+    if (av_render_add_video_stream(renderer->render, &render_info) != ESP_MEDIA_ERR_OK) {
+        ESP_LOGE(TAG, "Failed to add video stream to renderer");
+        return false;
+    }
+    xSemaphoreTake(renderer->stats_mutex, portMAX_DELAY);
+    renderer->stats.width = (uint32_t)info->width;
+    renderer->stats.height = (uint32_t)info->height;
+    xSemaphoreGive(renderer->stats_mutex);
+    return true;
+}
+
+bool video_renderer_push(video_renderer_handle_t handle, const esp_peer_video_frame_t *frame)
+{
+    if (handle == NULL || frame == NULL || frame->data == NULL || frame->size <= 0) {
+        return false;
+    }
+    renderer_t *renderer = (renderer_t *)handle;
+    if (!renderer->is_running) {
+        return false;
+    }
+    xSemaphoreTake(renderer->stats_mutex, portMAX_DELAY);
+    renderer->stats.received++;
+    xSemaphoreGive(renderer->stats_mutex);
+
+    bool is_keyframe = video_renderer_is_keyframe(frame->data, (size_t)frame->size);
+    if (renderer->is_awaiting_keyframe && !is_keyframe) {
+        count_dropped(renderer, 1);
+        // Ask again in case the sender missed or ignored the last request.
+        request_keyframe(renderer);
+        return false;
+    }
+
+    render_item_t item = {
+        .data = malloc((size_t)frame->size),
+        .size = (uint32_t)frame->size,
+        .pts = frame->pts,
+    };
+    if (item.data == NULL) {
+        drop_until_keyframe(renderer);
+        return false;
+    }
+    memcpy(item.data, frame->data, (size_t)frame->size);
+
+    // A keyframe makes everything queued before it obsolete: flush when
+    // recovering from a drop, whose backlog would only add latency, or when
+    // the queue is full.
+    bool is_full = uxQueueSpacesAvailable(renderer->queue) == 0;
+    if (is_keyframe && (renderer->is_stale || is_full)) {
+        count_dropped(renderer, flush_queue(renderer));
+    }
+    if (xQueueSend(renderer->queue, &item, 0) != pdPASS) {
+        // Decoding is falling behind; skip ahead to the next keyframe.
+        free(item.data);
+        drop_until_keyframe(renderer);
+        return false;
+    }
+    renderer->is_awaiting_keyframe = false;
+    renderer->is_stale = false;
+
+    UBaseType_t depth = uxQueueMessagesWaiting(renderer->queue);
+    xSemaphoreTake(renderer->stats_mutex, portMAX_DELAY);
+    if (depth > renderer->stats.queue_high_water) {
+        renderer->stats.queue_high_water = (uint32_t)depth;
+    }
+    xSemaphoreGive(renderer->stats_mutex);
+    return true;
+}
+
+void video_renderer_reset(video_renderer_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    renderer_t *renderer = (renderer_t *)handle;
+    renderer->is_awaiting_keyframe = true;
+    count_dropped(renderer, flush_queue(renderer));
+}
+
+void video_renderer_get_stats(video_renderer_handle_t handle, livekit_video_render_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return;
+    }
+    renderer_t *renderer = (renderer_t *)handle;
+    xSemaphoreTake(renderer->stats_mutex, portMAX_DELAY);
+    *stats = renderer->stats;
+    stats->avg_decode_us = renderer->stats.rendered > 0 ?
+        (uint32_t)(renderer->total_decode_us / renderer->stats.rendered) : 0;
+    xSemaphoreGive(renderer->stats_mutex);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "av_render.h"
+#include "esp_peer.h"
+#include "livekit_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Feeds subscribed video frames to `av_render` from a dedicated task.
+///
+/// Frames are copied into a bounded queue (`CONFIG_LK_SUB_VIDEO_QUEUE_SIZE`) so the
+/// peer receive thread is never blocked by decoding. When decoding cannot keep up,
+/// the queue fills and frames are dropped; since H.264 frames reference earlier
+/// ones, all frames are then dropped until the next keyframe, which is requested
+/// from the sender. The keyframe also discards any stale frames still queued from
+/// before the drop.
+///
+typedef void *video_renderer_handle_t;
+
+/// Called from the thread pushing frames when a keyframe is needed to resume decoding.
+///
+/// Calls are limited to one per second while waiting for the keyframe.
+///
+typedef void (*video_renderer_keyframe_cb_t)(void *ctx);
+
+/// Creates a renderer feeding the given `av_render` instance and starts its task.
+///
+/// @param on_keyframe_needed Optional handler for keyframe requests.
+/// @param ctx Context passed to `on_keyframe_needed`.
+///
+video_renderer_handle_t video_renderer_create(
+    av_render_handle_t render,
+    video_renderer_keyframe_cb_t on_keyframe_needed,
+    void *ctx
+);
+
+/// Stops the task and frees any frames still queued.
+void video_renderer_destroy(video_renderer_handle_t handle);
+
+/// Configures the decoder for a newly negotiated stream.
+bool video_renderer_set_stream_info(video_renderer_handle_t handle, const esp_peer_video_stream_info_t *info);
+
+/// Queues a copy of a received frame without blocking.
+///
+/// @returns False if the frame was dropped.
+///
+bool video_renderer_push(video_renderer_handle_t handle, const esp_peer_video_frame_t *frame);
+
+/// Discards queued frames and waits for a keyframe, e.g. when the stream restarts.
+void video_renderer_reset(video_renderer_handle_t handle);
+
+/// Returns the renderer's counters.
+void video_renderer_get_stats(video_renderer_handle_t handle, livekit_video_render_stats_t *stats);
+
+/// Returns whether an H.264 Annex B access unit can be decoded on its own.
+///
+/// Only the NAL headers up to the first slice are inspected.
+///
+bool video_renderer_is_keyframe(const uint8_t *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "voice_activity.h"
+
+/// Level reported for digital silence (dBFS).
+#define SILENCE_LEVEL_DB -96.0f
+
+/// Frames quieter than this are never speech, whatever the noise floor (dBFS).
+#define MIN_SPEECH_LEVEL_DB -60.0f
+
+/// Rate at which the noise floor rises towards louder frames (dB per second).
+/// Speech pauses pull the floor back down, so speech itself is not absorbed.
+#define NOISE_FLOOR_RISE_DB_PER_S 4.0f
+
+/// Opus packets of at most this size carry no audio; libopus emits them in DTX mode.
+#define OPUS_DTX_MAX_SIZE 2
+
+typedef struct {
+    voice_activity_config_t config;
+    bool has_noise_floor;
+    float noise_floor_db;
+    bool has_speech;
+    uint32_t last_speech_pts;
+    bool has_pts;
+    uint32_t last_pts;
+    livekit_audio_dtx_stats_t stats;
+} voice_activity_t;
+
+/// Decodes a G.711 A-law sample to 16-bit linear PCM.
+static inline int16_t alaw_to_linear(uint8_t value)
+{
+    value ^= 0x55;
+    int16_t magnitude = (int16_t)((value & 0x0F) << 4);
+    int exponent = (value & 0x70) >> 4;
+    if (exponent == 0) {
+        magnitude += 8;
+    } else {
+        magnitude = (int16_t)((magnitude + 0x108) << (exponent - 1));
+    }
+    return (value & 0x80) ? magnitude : (int16_t)-magnitude;
+}
+
+/// Decodes a G.711 µ-law sample to 16-bit linear PCM.
+static inline int16_t ulaw_to_linear(uint8_t value)
+{
+    value = (uint8_t)~value;
+    int16_t magnitude = (int16_t)((((value & 0x0F) << 3) + 0x84) << ((value & 0x70) >> 4));
+    magnitude = (int16_t)(magnitude - 0x84);
+    return (value & 0x80) ? (int16_t)-magnitude : magnitude;
+}
+
+/// Returns the frame's RMS level relative to full scale (dBFS).
+static float g711_level_db(const uint8_t *data, size_t size, bool is_alaw)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; i++) {
+        int32_t sample = is_alaw ? alaw_to_linear(data[i]) : ulaw_to_linear(data[i]);
+        sum += (uint64_t)(sample * sample);
+    }
+    if (sum == 0) {
+        return SILENCE_LEVEL_DB;
+    }
+    float mean_square = (float)sum / (float)size / (32768.0f * 32768.0f);
+    float level_db = 10.0f * log10f(mean_square);
+    return level_db < SILENCE_LEVEL_DB ? SILENCE_LEVEL_DB : level_db;
+}
+
+/// Updates counters for a frame and returns whether it is sent.
+static bool record_frame(voice_activity_t *va, bool is_sent)
+{
+    va->stats.frames++;
+    if (!is_sent) {
+        va->stats.suppressed_frames++;
+    }
+    va->stats.suppressed_percent = (uint8_t)((uint64_t)va->stats.suppressed_frames * 100 / va->stats.frames);
+    return is_sent;
+}
+
+voice_activity_handle_t voice_activity_create(const voice_activity_config_t *config)
+{
+    if (config == NULL) {
+        return NULL;
+    }
+    voice_activity_t *va = calloc(1, sizeof(voice_activity_t));
+    if (va == NULL) {
+        return NULL;
+    }
+    va->config = *config;
+    return va;
+}
+
+void voice_activity_destroy(voice_activity_handle_t handle)
+{
+    free(handle);
+}
+
+bool voice_activity_process_g711(
+    voice_activity_handle_t handle,
+    const uint8_t *data,
+    size_t size,
+    bool is_alaw,
+    uint32_t pts)
+{
+    if (handle == NULL || data == NULL || size == 0) {
+        return true;
+    }
+    voice_activity_t *va = (voice_activity_t *)handle;
+    float level_db = g711_level_db(data, size, is_alaw);
+
+    uint32_t elapsed_ms = va->has_pts ? pts - va->last_pts : 0;
+    va->has_pts = true;
+    va->last_pts = pts;
+    if (!va->has_noise_floor) {
+        va->has_noise_floor = true;
+        va->noise_floor_db = level_db;
+    } else if (level_db < va->noise_floor_db) {
+        // Follow drops immediately: any quieter frame is at most noise.
+        va->noise_floor_db = level_db;
+    } else {
+        float rise_db = NOISE_FLOOR_RISE_DB_PER_S * (float)elapsed_ms / 1000.0f;
+        float delta_db = level_db - va->noise_floor_db;
+        va->noise_floor_db += delta_db < rise_db ? delta_db : rise_db;
+    }
+
+    bool is_speech = level_db >= MIN_SPEECH_LEVEL_DB &&
+        level_db >= va->noise_floor_db + (float)va->config.threshold_db;
+    if (is_speech) {
+        if (!va->has_speech || (int32_t)(pts - va->last_speech_pts) > (int32_t)va->config.hangover_ms) {
+            va->stats.talk_spurts++;
+        }
+        va->has_speech = true;
+        va->last_speech_pts = pts;
+        return record_frame(va, true);
+    }
+    bool is_hangover = va->has_speech &&
+        (int32_t)(pts - va->last_speech_pts) <= (int32_t)va->config.hangover_ms;
+    return record_frame(va, is_hangover);
+}
+
+bool voice_activity_process_opus(
+    voice_activity_handle_t handle,
+    const uint8_t *data,
+    size_t size,
+    uint32_t pts)
+{
+    (void)pts;
+    if (handle == NULL) {
+        return true;
+    }
+    voice_activity_t *va = (voice_activity_t *)handle;
+    // The encoder runs its own detector and keeps sending periodic comfort noise
+    // updates, which are larger than DTX packets and are sent as normal frames.
+    bool is_dtx = data == NULL || size <= OPUS_DTX_MAX_SIZE;
+    if (!is_dtx && !va->has_speech) {
+        va->stats.talk_spurts++;
+    }
+    va->has_speech = !is_dtx;
+    return record_frame(va, !is_dtx);
+}
+
+void voice_activity_reset(voice_activity_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    voice_activity_t *va = (voice_activity_t *)handle;
+    va->has_noise_floor = false;
+    va->has_speech = false;
+    va->has_pts = false;
+}
+
+void voice_activity_get_stats(voice_activity_handle_t handle, livekit_audio_dtx_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return;
+    }
+    voice_activity_t *va = (voice_activity_t *)handle;
+    *stats = va->stats;
+}
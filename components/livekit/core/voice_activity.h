@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "livekit_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Decides which encoded audio frames to send while the microphone picks up silence.
+///
+/// Opus frames the encoder has marked for discontinuous transmission (DTX) are
+/// never sent, like other WebRTC endpoints do. G.711 has no DTX mode, so frames are
+/// decoded and their level compared against a tracked noise floor instead; once
+/// the level has stayed within the threshold of the floor for the hangover time,
+/// frames are suppressed until speech resumes.
+///
+/// Frame timestamps are passed in so the detector can be driven by recorded or
+/// synthetic audio.
+///
+typedef void *voice_activity_handle_t;
+
+typedef struct {
+    /// Level above the noise floor at which a frame counts as speech (dB).
+    uint8_t threshold_db;
+    /// Time frames keep being sent after the last speech frame, so word endings
+    /// and short pauses are not cut (ms).
+    uint16_t hangover_ms;
+} voice_activity_config_t;
+
+/// Creates a detector.
+voice_activity_handle_t voice_activity_create(const voice_activity_config_t *config);
+
+/// Destroys a detector.
+void voice_activity_destroy(voice_activity_handle_t handle);
+
+/// Classifies a G.711 frame.
+///
+/// @param is_alaw True for A-law, false for µ-law.
+/// @param pts Capture timestamp of the frame (ms).
+/// @returns True if the frame should be sent.
+///
+bool voice_activity_process_g711(
+    voice_activity_handle_t handle,
+    const uint8_t *data,
+    size_t size,
+    bool is_alaw,
+    uint32_t pts
+);
+
+/// Classifies an Opus frame.
+///
+/// @param pts Capture timestamp of the frame (ms).
+/// @returns True if the frame should be sent.
+///
+bool voice_activity_process_opus(
+    voice_activity_handle_t handle,
+    const uint8_t *data,
+    size_t size,
+    uint32_t pts
+);
+
+/// Forgets the noise floor and speech state, e.g. for a new connection; counters are kept.
+void voice_activity_reset(voice_activity_handle_t handle);
+
+/// Returns suppression counters.
+void voice_activity_get_stats(voice_activity_handle_t handle, livekit_audio_dtx_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
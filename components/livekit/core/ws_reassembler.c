@@ -0,0 +1,227 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+
+#include "ws_reassembler.h"
+
+/// Control frames (close, ping, pong) have the high bit of the opcode set.
+#define IS_CONTROL_OPCODE(opcode) (((opcode) & 0x8) != 0)
+
+typedef struct {
+    size_t max_message_size;
+    uint8_t *buf;
+    size_t len;
+    size_t capacity;
+    /// Whether a message has started and its last chunk has not arrived yet.
+    bool in_message;
+    /// Whether the rest of the message in progress is being skipped.
+    bool is_discarding;
+    /// Bytes of the current frame's payload received so far.
+    size_t frame_received;
+    ws_reassembler_stats_t stats;
+} ws_reassembler_t;
+
+static void release_buffer(ws_reassembler_t *r)
+{
+    free(r->buf);
+    r->buf = NULL;
+    r->len = 0;
+    r->capacity = 0;
+}
+
+/// Skips the rest of the message in progress.
+static void discard_message(ws_reassembler_t *r)
+{
+    release_buffer(r);
+    r->is_discarding = true;
+    r->stats.dropped++;
+}
+
+static bool reserve(ws_reassembler_t *r, size_t needed)
+{
+    if (needed <= r->capacity) {
+        return true;
+    }
+    size_t capacity = r->capacity * 2;
+    if (capacity < needed) capacity = needed;
+    if (capacity > r->max_message_size) capacity = r->max_message_size;
+
+    // Reassembled messages can be large and are rarely needed, so prefer PSRAM.
+    uint8_t *buf = heap_caps_realloc_prefer(r->buf, capacity, 2,
+        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT);
+    if (buf == NULL) {
+        return false;
+    }
+    r->buf = buf;
+    r->capacity = capacity;
+    return true;
+}
+
+ws_reassembler_handle_t ws_reassembler_create(size_t max_message_size)
+{
+    if (max_message_size == 0) {
+        return NULL;
+    }
+    ws_reassembler_t *r = calloc(1, sizeof(ws_reassembler_t));
+    if (r == NULL) {
+        return NULL;
+    }
+    r->max_message_size = max_message_size;
+    return r;
+}
+
+void ws_reassembler_destroy(ws_reassembler_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    ws_reassembler_t *r = (ws_reassembler_t *)handle;
+    release_buffer(r);
+    free(r);
+}
+
+ws_reassembler_err_t ws_reassembler_push(
+    ws_reassembler_handle_t handle,
+    const ws_reassembler_chunk_t *chunk,
+    const uint8_t **message_out,
+    size_t *message_len_out
+) {
+    if (handle == NULL || chunk == NULL ||
+        message_out == NULL || message_len_out == NULL ||
+        (chunk->data == NULL && chunk->data_len > 0) ||
+        chunk->payload_offset > chunk->payload_len ||
+        chunk->data_len > chunk->payload_len - chunk->payload_offset) {
+        return WS_REASSEMBLER_ERR_INVALID_ARG;
+    }
+    ws_reassembler_t *r = (ws_reassembler_t *)handle;
+    *message_out = NULL;
+    *message_len_out = 0;
+
+    if (IS_CONTROL_OPCODE(chunk->opcode)) {
+        // May be interleaved with the frames of a fragmented message.
+        return WS_REASSEMBLER_ERR_NONE;
+    }
+
+    ws_reassembler_err_t err = WS_REASSEMBLER_ERR_NONE;
+    if (chunk->payload_offset == 0) {
+        if (chunk->opcode == WS_OPCODE_CONTINUATION) {
+            if (!r->in_message) {
+                return WS_REASSEMBLER_ERR_SEQUENCE;
+            }
+        } else {
+            if (r->in_message && !r->is_discarding) {
+                // The previous message never completed.
+                r->stats.dropped++;
+            }
+            // The previous message is no longer referenced by the caller.
+            release_buffer(r);
+            r->in_message = true;
+            r->is_discarding = chunk->opcode != WS_OPCODE_BINARY;
+        }
+        r->frame_received = 0;
+    } else if (!r->in_message) {
+        return WS_REASSEMBLER_ERR_SEQUENCE;
+    } else if (!r->is_discarding && chunk->payload_offset != r->frame_received) {
+        discard_message(r);
+        err = WS_REASSEMBLER_ERR_SEQUENCE;
+    }
+
+    bool is_last = chunk->fin && chunk->payload_offset + chunk->data_len == chunk->payload_len;
+    if (r->is_discarding) {
+        if (is_last) r->in_message = false;
+        return err;
+    }
+    r->frame_received += chunk->data_len;
+
+    if (is_last && r->len == 0 &&
+        chunk->payload_offset == 0 && chunk->opcode != WS_OPCODE_CONTINUATION) {
+        // Complete in a single chunk: return it in place.
+        r->in_message = false;
+        r->stats.messages++;
+        *message_out = chunk->data;
+        *message_len_out = chunk->data_len;
+        return WS_REASSEMBLER_ERR_NONE;
+    }
+
+    // Reserve the rest of the frame at once; its length is known up front.
+    size_t needed = r->len + (chunk->payload_len - chunk->payload_offset);
+    if (needed > r->max_message_size) {
+        discard_message(r);
+        if (is_last) r->in_message = false;
+        return WS_REASSEMBLER_ERR_TOO_LARGE;
+    }
+    if (!reserve(r, needed)) {
+        discard_message(r);
+        if (is_last) r->in_message = false;
+        return WS_REASSEMBLER_ERR_NO_MEM;
+    }
+    if (chunk->data_len > 0) {
+        memcpy(r->buf + r->len, chunk->data, chunk->data_len);
+        r->len += chunk->data_len;
+    }
+    if (!is_last) {
+        return WS_REASSEMBLER_ERR_NONE;
+    }
+    r->in_message = false;
+    r->stats.messages++;
+    r->stats.reassembled++;
+    if (r->len > r->stats.max_message_size) {
+        r->stats.max_message_size = r->len;
+    }
+    *message_out = r->buf;
+    *message_len_out = r->len;
+    return WS_REASSEMBLER_ERR_NONE;
+}
+
+uint8_t *ws_reassembler_take(ws_reassembler_handle_t handle)
+{
+    if (handle == NULL) {
+        return NULL;
+    }
+    ws_reassembler_t *r = (ws_reassembler_t *)handle;
+    if (r->in_message || r->buf == NULL) {
+        return NULL;
+    }
+    uint8_t *message = r->buf;
+    r->buf = NULL;
+    r->len = 0;
+    r->capacity = 0;
+    return message;
+}
+
+void ws_reassembler_reset(ws_reassembler_handle_t handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    ws_reassembler_t *r = (ws_reassembler_t *)handle;
+    release_buffer(r);
+    r->in_message = false;
+    r->is_discarding = false;
+    r->frame_received = 0;
+}
+
+ws_reassembler_err_t ws_reassembler_get_stats(ws_reassembler_handle_t handle, ws_reassembler_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return WS_REASSEMBLER_ERR_INVALID_ARG;
+    }
+    *stats = ((ws_reassembler_t *)handle)->stats;
+    return WS_REASSEMBLER_ERR_NONE;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2025 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Reassembles WebSocket messages from the chunks delivered by the client.
+///
+/// A message arrives in pieces in two ways: the sender may fragment it into
+/// several frames (continuation frames), and the client delivers frames larger
+/// than its receive buffer in several chunks. Chunks are accumulated in a
+/// buffer that grows as needed (preferring PSRAM) and is released when the next
+/// message starts, so small messages that arrive in a single chunk are returned
+/// without copying and no memory is held for them.
+///
+/// Not thread-safe; push chunks from a single task.
+///
+typedef void *ws_reassembler_handle_t;
+
+typedef enum {
+    WS_REASSEMBLER_ERR_NONE        =  0,
+    WS_REASSEMBLER_ERR_INVALID_ARG = -1,
+    WS_REASSEMBLER_ERR_NO_MEM      = -2,
+    /// The message exceeds the maximum size and is discarded.
+    WS_REASSEMBLER_ERR_TOO_LARGE   = -3,
+    /// A chunk does not continue the message in progress; the partial message is discarded.
+    WS_REASSEMBLER_ERR_SEQUENCE    = -4,
+} ws_reassembler_err_t;
+
+/// WebSocket frame opcodes (RFC 6455, section 5.2).
+typedef enum {
+    WS_OPCODE_CONTINUATION = 0x0,
+    WS_OPCODE_TEXT         = 0x1,
+    WS_OPCODE_BINARY       = 0x2,
+    WS_OPCODE_CLOSE        = 0x8,
+    WS_OPCODE_PING         = 0x9,
+    WS_OPCODE_PONG         = 0xA,
+} ws_opcode_t;
+
+/// A piece of a frame, as delivered by the WebSocket client.
+typedef struct {
+    /// Opcode of the frame the chunk belongs to.
+    uint8_t opcode;
+    /// Whether the frame is the last one of its message.
+    bool fin;
+    const uint8_t *data;
+    size_t data_len;
+    /// Offset of the chunk within the frame's payload.
+    size_t payload_offset;
+    /// Total length of the frame's payload.
+    size_t payload_len;
+} ws_reassembler_chunk_t;
+
+typedef struct {
+    /// Binary messages delivered complete.
+    uint32_t messages;
+    /// Of those, messages that had to be reassembled from several chunks.
+    uint32_t reassembled;
+    /// Messages discarded for being too large or out of sequence.
+    uint32_t dropped;
+    /// Largest message reassembled, in bytes.
+    size_t max_message_size;
+} ws_reassembler_stats_t;
+
+/// Creates a reassembler accepting messages of up to `max_message_size` bytes.
+ws_reassembler_handle_t ws_reassembler_create(size_t max_message_size);
+
+/// Destroys a reassembler, discarding any partial message.
+void ws_reassembler_destroy(ws_reassembler_handle_t handle);
+
+/// Adds a chunk, returning the message it completes if any.
+///
+/// Only binary messages are returned; text and control frames are skipped
+/// without disturbing a message in progress.
+///
+/// @param message_out[out] Complete message, or NULL if more chunks are needed.
+///                         Valid until the next call to `ws_reassembler_push`
+///                         or `ws_reassembler_reset`.
+/// @param message_len_out[out] Length of the complete message.
+///
+ws_reassembler_err_t ws_reassembler_push(
+    ws_reassembler_handle_t handle,
+    const ws_reassembler_chunk_t *chunk,
+    const uint8_t **message_out,
+    size_t *message_len_out
+);
+
+/// Takes ownership of the message last returned by `ws_reassembler_push`.
+///
+/// Only reassembled messages are held in the reassembler's buffer; the buffer is
+/// detached and a new one is allocated for the next message.
+///
+/// @return The message, to be released with `free`, or NULL if it was returned
+///         in place from a single chunk or is no longer held.
+///
+uint8_t *ws_reassembler_take(ws_reassembler_handle_t handle);
+
+/// Discards any partial message and releases the buffer, e.g. when the connection closes.
+void ws_reassembler_reset(ws_reassembler_handle_t handle);
+
+/// Gets statistics since the reassembler was created.
+ws_reassembler_err_t ws_reassembler_get_stats(ws_reassembler_handle_t handle, ws_reassembler_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
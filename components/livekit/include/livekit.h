@@ -36,7 +36,8 @@ typedef enum {
     LIVEKIT_ERR_ENGINE        = -3,  ///< Engine
     LIVEKIT_ERR_OTHER         = -4,  ///< Other error
     LIVEKIT_ERR_INVALID_STATE = -5,  ///< Invalid state
-    LIVEKIT_ERR_SYSTEM_INIT   = -6   ///< System not initialized
+    LIVEKIT_ERR_SYSTEM_INIT   = -6,  ///< System not initialized
+    LIVEKIT_ERR_NOT_FOUND     = -7   ///< Requested item not found
 } livekit_err_t;
 
 /// Video codec to use within a room.
@@ -170,6 +171,18 @@ typedef enum {
     LIVEKIT_PARTICIPANT_STATE_DISCONNECTED = 3
 } livekit_participant_state_t;
 
+/// Fields of @ref livekit_participant_info_t, as bits of
+/// @ref livekit_participant_info_t::changed_fields.
+/// @ingroup Info
+typedef enum {
+    LIVEKIT_PARTICIPANT_FIELD_IDENTITY = 1 << 0,
+    LIVEKIT_PARTICIPANT_FIELD_NAME     = 1 << 1,
+    LIVEKIT_PARTICIPANT_FIELD_METADATA = 1 << 2,
+    LIVEKIT_PARTICIPANT_FIELD_KIND     = 1 << 3,
+    LIVEKIT_PARTICIPANT_FIELD_STATE    = 1 << 4,
+    LIVEKIT_PARTICIPANT_FIELD_ALL      = 0x1F
+} livekit_participant_field_t;
+
 /// Information about a participant in a room.
 /// @ingroup Info
 typedef struct {
@@ -185,8 +198,67 @@ typedef struct {
     livekit_participant_kind_t kind;
     /// The current state of the participant.
     livekit_participant_state_t state;
+    /// Fields that changed since the participant was last reported, as a mask of
+    /// @ref livekit_participant_field_t values. Always @ref LIVEKIT_PARTICIPANT_FIELD_ALL
+    /// unless @ref livekit_room_options_t::cache_participants is enabled.
+    uint32_t changed_fields;
 } livekit_participant_info_t;
 
+/// Information about a remote track offered for subscription.
+/// @ingroup Subscriptions
+typedef struct {
+    /// Unique identifier generated by LiveKit server.
+    const char* sid;
+    /// Kind of media carried by the track.
+    livekit_media_kind_t kind;
+} livekit_track_info_t;
+
+/// How remote tracks are chosen for subscription.
+/// @ingroup Subscriptions
+typedef enum {
+    /// Subscribe to all tracks (default).
+    LIVEKIT_SUB_POLICY_ALL = 0,
+    /// Subscribe only to tracks published by participants with one of the given identities.
+    LIVEKIT_SUB_POLICY_IDENTITY = 1,
+    /// Subscribe only to tracks published by participants of the given kinds.
+    LIVEKIT_SUB_POLICY_PARTICIPANT_KIND = 2,
+    /// Decide for each track with a callback.
+    LIVEKIT_SUB_POLICY_CALLBACK = 3
+} livekit_sub_policy_type_t;
+
+/// Bit for a participant kind in @ref livekit_sub_policy_t::participant_kinds.
+/// @ingroup Subscriptions
+#define LIVEKIT_PARTICIPANT_KIND_BIT(kind) (1u << (kind))
+
+/// Policy for choosing which remote tracks to subscribe to.
+///
+/// Only tracks whose media kind is enabled in @ref livekit_sub_options_t::kind are
+/// considered, up to one audio track and one video track at once.
+///
+/// @ingroup Subscriptions
+///
+typedef struct {
+    /// How tracks are chosen; determines which of the fields below are used.
+    livekit_sub_policy_type_t type;
+
+    /// Identities of participants to subscribe to, for @ref LIVEKIT_SUB_POLICY_IDENTITY.
+    /// @note The strings are copied.
+    const char* const* identities;
+    /// Number of entries in `identities`.
+    size_t identity_count;
+
+    /// Participant kinds to subscribe to as a mask of @ref LIVEKIT_PARTICIPANT_KIND_BIT,
+    /// for @ref LIVEKIT_SUB_POLICY_PARTICIPANT_KIND.
+    uint32_t participant_kinds;
+
+    /// Returns whether to subscribe to a track, for @ref LIVEKIT_SUB_POLICY_CALLBACK.
+    ///
+    /// Invoked whenever the room's tracks or the policy change, with the room's
+    /// user context. Must not block.
+    ///
+    bool (*should_subscribe)(const livekit_participant_info_t* participant, const livekit_track_info_t* track, void* ctx);
+} livekit_sub_policy_t;
+
 /// Options for creating a room.
 ///
 /// This is the main way a room is configured. It is passed to
@@ -203,6 +275,15 @@ typedef struct {
     /// @note Only required if the room subscribes to media.
     livekit_sub_options_t subscribe;
 
+    /// Policy for choosing which remote tracks to subscribe to.
+    /// @see Subscriptions
+    livekit_sub_policy_t subscription_policy;
+
+    /// What to do when a reliable data packet is published while the buffer of
+    /// packets waiting for the connection is full.
+    /// @see DataPackets
+    livekit_data_buffer_policy_t data_buffer_policy;
+
     /// Handler for when the room's connection state changes.
     /// @see Connection
     void (*on_state_changed)(livekit_connection_state_t state, void* ctx);
@@ -223,6 +304,16 @@ typedef struct {
     /// @see Info
     void (*on_participant_info)(const livekit_participant_info_t* info, void* ctx);
 
+    /// Keep the last known state of each participant.
+    ///
+    /// When enabled, @ref livekit_room_options_t::on_participant_info is only invoked
+    /// when a participant's information changes, with the changed fields set in
+    /// @ref livekit_participant_info_t::changed_fields, and participants can be looked
+    /// up with @ref livekit_room_get_participant. Up to `CONFIG_LK_MAX_CACHED_PARTICIPANTS`
+    /// participants are kept; others are always reported in full.
+    /// @see Info
+    bool cache_participants;
+
     /// User context passed to all handlers.
     void* ctx;
 } livekit_room_options_t;
@@ -294,6 +385,39 @@ livekit_err_t livekit_room_destroy(livekit_room_handle_t handle);
 ///
 livekit_err_t livekit_room_connect(livekit_room_handle_t handle, const char *server_url, const char *token);
 
+/// Connects to a room asynchronously without publishing media.
+///
+/// The room connects and negotiates both peer connections as with
+/// @ref livekit_room_connect, but capture is not started, so publishing begins
+/// with little delay once @ref livekit_room_activate is called (e.g. on a
+/// push-to-talk button press). Subscribed media is still received.
+///
+/// If the room stays in standby for `CONFIG_LK_STANDBY_IDLE_TIMEOUT_S`, it is
+/// disconnected to save power.
+///
+/// @param handle[in] Room handle.
+/// @param server_url[in] URL of the LiveKit server beginning with "wss://" or "ws://".
+/// @param token[in] Server-generated token for authentication.
+/// @return @ref LIVEKIT_ERR_NONE, otherwise an error code.
+///
+livekit_err_t livekit_room_connect_standby(livekit_room_handle_t handle, const char *server_url, const char *token);
+
+/// Starts publishing media on a room in standby asynchronously.
+///
+/// If the room is still connecting, publishing starts as soon as it is connected.
+///
+/// @param handle[in] Room handle.
+/// @return @ref LIVEKIT_ERR_NONE, otherwise an error code.
+///
+livekit_err_t livekit_room_activate(livekit_room_handle_t handle);
+
+/// Stops publishing media and returns to standby asynchronously, keeping the connection.
+///
+/// @param handle[in] Room handle.
+/// @return @ref LIVEKIT_ERR_NONE, otherwise an error code.
+///
+livekit_err_t livekit_room_standby(livekit_room_handle_t handle);
+
 /// Disconnects from a room asynchronously.
 ///
 /// @param handle[in] Room handle.
@@ -332,6 +456,21 @@ livekit_failure_reason_t livekit_room_get_failure_reason(livekit_room_handle_t h
 ///
 const char* livekit_failure_reason_str(livekit_failure_reason_t reason);
 
+/// Gets the time taken to recover lost connections.
+///
+/// A failed publisher connection is first recovered with an ICE restart, which
+/// keeps the signaling session and the subscriber. A lost signaling connection
+/// or subscriber is recovered by resuming the session, which keeps the peer
+/// connections. Anything else, or a recovery that does not complete, rejoins
+/// the room. The statistics for each path are kept separately so they can be
+/// compared.
+///
+/// @param handle[in] Room handle.
+/// @param stats[out] Reconnect statistics.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code.
+///
+livekit_err_t livekit_room_get_reconnect_stats(livekit_room_handle_t handle, livekit_reconnect_stats_t *stats);
+
 /// @}
 
 /// @defgroup Info Room & Participant Info
@@ -365,6 +504,78 @@ const char* livekit_failure_reason_str(livekit_failure_reason_t reason);
 /// }
 /// @endcode
 ///
+/// The server also sends participant information for changes not reflected in the
+/// info struct (e.g. to a participant's tracks), which adds up in large rooms. Enable
+/// @ref livekit_room_options_t::cache_participants to have the room keep the last
+/// known state of each participant, so the handler is only invoked when a field
+/// actually changes and participants can be looked up by SID:
+///
+/// @code
+/// livekit_participant_info_t info;
+/// if (livekit_room_get_participant(room_handle, sid, &info) == LIVEKIT_ERR_NONE) {
+///     ESP_LOGI(TAG, "%s is %s", info.sid, info.name);
+///     livekit_room_release_participant(room_handle, &info);
+/// }
+/// @endcode
+///
+/// @{
+
+/// Looks up a participant by SID.
+///
+/// Requires @ref livekit_room_options_t::cache_participants.
+///
+/// @param handle[in] Room handle.
+/// @param sid[in] SID of the participant.
+/// @param info[out] Last known information about the participant. The strings
+///                  stay valid until released with @ref livekit_room_release_participant,
+///                  even if the participant is updated or leaves in the meantime.
+/// @return @ref LIVEKIT_ERR_NONE if successful, @ref LIVEKIT_ERR_NOT_FOUND if the
+///         participant is not in the room, otherwise an error code.
+///
+livekit_err_t livekit_room_get_participant(livekit_room_handle_t handle, const char *sid, livekit_participant_info_t *info);
+
+/// Releases participant information obtained with @ref livekit_room_get_participant.
+///
+/// @param handle[in] Room handle.
+/// @param info[in] Information to release; cleared on return.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code.
+///
+livekit_err_t livekit_room_release_participant(livekit_room_handle_t handle, livekit_participant_info_t *info);
+
+/// @}
+
+/// @defgroup Subscriptions
+///
+/// Choose which remote tracks are subscribed to.
+///
+/// By default, the room subscribes to every remote track of the kinds enabled in
+/// @ref livekit_sub_options_t::kind. A policy set in
+/// @ref livekit_room_options_t::subscription_policy, or changed at runtime, restricts
+/// this so the device never receives or decodes media it will not play, for example
+/// to only subscribe to agents:
+///
+/// @code
+/// livekit_sub_policy_t policy = {
+///     .type = LIVEKIT_SUB_POLICY_PARTICIPANT_KIND,
+///     .participant_kinds = LIVEKIT_PARTICIPANT_KIND_BIT(LIVEKIT_PARTICIPANT_KIND_AGENT)
+/// };
+/// livekit_room_set_subscription_policy(room_handle, &policy);
+/// @endcode
+///
+/// @{
+
+/// Changes the subscription policy.
+///
+/// Tracks that no longer match the policy are unsubscribed and newly matching
+/// tracks are subscribed asynchronously.
+///
+/// @param handle[in] Room handle.
+/// @param policy[in] New policy; copied.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code.
+///
+livekit_err_t livekit_room_set_subscription_policy(livekit_room_handle_t handle, const livekit_sub_policy_t *policy);
+
+/// @}
 
 /// @defgroup DataPackets Data Packets
 ///
@@ -422,6 +633,92 @@ typedef struct {
 ///
 livekit_err_t livekit_room_publish_data(livekit_room_handle_t handle, livekit_data_publish_options_t *options);
 
+/// Gets statistics for reliable data packets buffered while the room is not connected.
+///
+/// Reliable packets published while the room is connecting or reconnecting are
+/// buffered and sent in order once the connection is reestablished. The buffer
+/// size is configured with `CONFIG_LK_RELIABLE_BUFFER_*` options in Kconfig, and
+/// the overflow behavior with @ref livekit_room_options_t::data_buffer_policy.
+///
+/// @param handle[in] Room handle.
+/// @param stats[out] Buffer statistics.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code.
+///
+livekit_err_t livekit_room_get_data_buffer_stats(livekit_room_handle_t handle, livekit_data_buffer_stats_t *stats);
+
+/// Gets statistics for incoming data packets.
+///
+/// Incoming packets are queued and delivered to data and RPC handlers from a
+/// dedicated task, so handlers never block the connection. Packets arriving while
+/// the queue is full are dropped; the queue depth and task priority are configured
+/// with `CONFIG_LK_DATA_DISPATCH_*` options in Kconfig.
+///
+/// @param handle[in] Room handle.
+/// @param stats[out] Dispatch statistics.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code.
+///
+livekit_err_t livekit_room_get_data_dispatch_stats(livekit_room_handle_t handle, livekit_data_dispatch_stats_t *stats);
+
+/// @}
+
+/// @defgroup Media Media Statistics
+/// @{
+
+/// Gets statistics for the jitter buffer in front of subscribed audio playback.
+///
+/// Received audio frames are reordered and released for playout after an adaptive
+/// delay that follows the measured network jitter. Frames arriving too late to be
+/// played are dropped. Missing frames are counted but not synthesized; the next
+/// frame is played in their place. Bounds for the delay are
+/// configured with `CONFIG_LK_JITTER_BUFFER_*` options in Kconfig.
+///
+/// @param handle[in] Room handle.
+/// @param stats[out] Jitter buffer statistics.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code. Fails if the
+///     room does not subscribe to audio or the jitter buffer is disabled.
+///
+livekit_err_t livekit_room_get_audio_jitter_stats(livekit_room_handle_t handle, livekit_audio_jitter_stats_t *stats);
+
+/// Gets statistics for subscribed video decoding.
+///
+/// Use the decode times to choose a resolution the device can keep up with: when
+/// the average approaches the frame interval, frames are dropped until the next
+/// keyframe, which is requested from the sender, and `dropped` grows.
+///
+/// @param handle[in] Room handle.
+/// @param stats[out] Video render statistics.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code. Fails if the
+///     room does not subscribe to video.
+///
+livekit_err_t livekit_room_get_video_render_stats(livekit_room_handle_t handle, livekit_video_render_stats_t *stats);
+
+/// Gets statistics for published media bitrate adaptation.
+///
+/// The target is lowered when sending published frames starts to back up or fail,
+/// and raised again once the network keeps up. Compare `target_bps` with
+/// `achieved_bps` to see whether the encoders produce what they are asked for.
+/// Limits are configured with `CONFIG_LK_PUB_*_KBPS` options in Kconfig.
+///
+/// @param handle[in] Room handle.
+/// @param stats[out] Bitrate statistics.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code. Fails if the
+///     room publishes neither Opus audio nor H.264 video, or bitrate control is disabled.
+///
+livekit_err_t livekit_room_get_publish_bitrate_stats(livekit_room_handle_t handle, livekit_bitrate_stats_t *stats);
+
+/// Gets statistics for silence suppression of published audio.
+///
+/// While nobody is speaking, audio frames are not sent; `suppressed_percent` shows
+/// how much of the uplink audio this saved. Configured with `CONFIG_LK_AUDIO_DTX_*`
+/// options in Kconfig.
+///
+/// @param handle[in] Room handle.
+/// @param stats[out] Silence suppression statistics.
+/// @return @ref LIVEKIT_ERR_NONE if successful, otherwise an error code. Fails if the
+///     room does not publish audio or silence suppression is disabled.
+///
+livekit_err_t livekit_room_get_audio_dtx_stats(livekit_room_handle_t handle, livekit_audio_dtx_stats_t *stats);
+
 /// @}
 
 /// @defgroup RPC Remote Method Calls (RPC)
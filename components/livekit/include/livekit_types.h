@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -197,6 +200,165 @@ typedef enum {
     LIVEKIT_FAILURE_REASON_OTHER
 } livekit_failure_reason_t;
 
+/// Time taken to recover lost connections, by recovery path.
+/// @ingroup Connection
+typedef struct {
+    /// Publisher connections recovered with an ICE restart.
+    uint32_t ice_restarts;
+    /// ICE restarts that failed or timed out and fell back to a full reconnect.
+    uint32_t ice_restart_failures;
+    /// Duration of the most recent ICE restart in milliseconds.
+    uint32_t last_ice_restart_ms;
+    /// Average duration of ICE restarts in milliseconds.
+    uint32_t avg_ice_restart_ms;
+    /// Connections recovered by resuming the signaling session, keeping the
+    /// peer connections that were still healthy.
+    uint32_t resumes;
+    /// Resumes that were rejected or timed out and fell back to a full reconnect.
+    uint32_t resume_failures;
+    /// Time from losing the connection to being resumed, for the most recent
+    /// resume, in milliseconds.
+    uint32_t last_resume_ms;
+    /// Average duration of resumes in milliseconds.
+    uint32_t avg_resume_ms;
+    /// Connections recovered by rejoining the room.
+    uint32_t full_reconnects;
+    /// Time from losing the connection to being connected again, for the most
+    /// recent full reconnect, in milliseconds.
+    uint32_t last_full_reconnect_ms;
+    /// Average duration of full reconnects in milliseconds.
+    uint32_t avg_full_reconnect_ms;
+} livekit_reconnect_stats_t;
+
+/// What happens when a reliable data packet is published while the buffer of
+/// packets waiting for the connection is full.
+/// @ingroup DataPackets
+typedef enum {
+    /// Use the policy chosen with `CONFIG_LK_RELIABLE_BUFFER_POLICY` in Kconfig.
+    LIVEKIT_DATA_BUFFER_POLICY_DEFAULT = 0,
+    /// Drop the oldest buffered packet to make room.
+    LIVEKIT_DATA_BUFFER_POLICY_DROP_OLDEST = 1,
+    /// Reject the new packet.
+    LIVEKIT_DATA_BUFFER_POLICY_REJECT = 2,
+    /// Block the publisher until space is available, for up to
+    /// `CONFIG_LK_RELIABLE_BUFFER_BLOCK_TIMEOUT_MS`, then reject the packet.
+    LIVEKIT_DATA_BUFFER_POLICY_BLOCK = 3
+} livekit_data_buffer_policy_t;
+
+/// Statistics for reliable data packets buffered while a room is not connected.
+/// @ingroup DataPackets
+typedef struct {
+    /// Packets currently buffered.
+    uint32_t buffered;
+    /// Bytes currently buffered.
+    size_t buffered_bytes;
+    /// Packets buffered since the room was created.
+    uint32_t total_buffered;
+    /// Buffered packets sent once the connection was reestablished.
+    uint32_t sent;
+    /// Buffered packets discarded, either to make room for newer packets or
+    /// because the room disconnected.
+    uint32_t dropped;
+    /// Packets not buffered because the buffer was full.
+    uint32_t rejected;
+} livekit_data_buffer_stats_t;
+
+/// Statistics for incoming data packets handed off to the dispatch task.
+/// @ingroup DataPackets
+typedef struct {
+    /// Packets delivered to handlers.
+    uint32_t dispatched;
+    /// Packets discarded because the dispatch queue was full.
+    uint32_t dropped;
+    /// Maximum number of packets waiting in the dispatch queue.
+    uint32_t queue_high_water;
+    /// Average time from receipt to handler invocation in microseconds.
+    uint32_t avg_latency_us;
+    /// Maximum time from receipt to handler invocation in microseconds.
+    uint32_t max_latency_us;
+    /// Longest time spent in a single handler invocation in microseconds.
+    uint32_t max_handler_us;
+} livekit_data_dispatch_stats_t;
+
+/// Statistics for the jitter buffer in front of subscribed audio playback.
+/// @ingroup Media
+typedef struct {
+    /// Current playout delay target in milliseconds.
+    uint32_t target_delay_ms;
+    /// Smoothed inter-arrival jitter in milliseconds.
+    uint32_t jitter_ms;
+    /// Frames currently waiting for playout.
+    uint32_t buffered_frames;
+    /// Frames released for playout.
+    uint32_t played;
+    /// Frames dropped because they arrived too late to be played.
+    uint32_t late_dropped;
+    /// Missing frames skipped during playout; they are counted, not synthesized.
+    uint32_t concealed;
+    /// Frames dropped because the buffer was full.
+    uint32_t overflow_dropped;
+} livekit_audio_jitter_stats_t;
+
+/// Statistics for subscribed video decoding and rendering.
+/// @ingroup Media
+typedef struct {
+    /// Frames received from the remote track.
+    uint32_t received;
+    /// Frames decoded and handed to the renderer.
+    uint32_t rendered;
+    /// Frames skipped because decoding could not keep up, including frames
+    /// discarded while waiting for the next keyframe.
+    uint32_t dropped;
+    /// Frames the decoder rejected.
+    uint32_t decode_failed;
+    /// Keyframes requested from the sender to recover from dropped frames.
+    uint32_t keyframe_requests;
+    /// Maximum number of frames waiting to be decoded.
+    uint32_t queue_high_water;
+    /// Average decode time per frame in microseconds.
+    uint32_t avg_decode_us;
+    /// Longest decode time for a single frame in microseconds.
+    uint32_t max_decode_us;
+    /// Width of the current stream in pixels.
+    uint32_t width;
+    /// Height of the current stream in pixels.
+    uint32_t height;
+} livekit_video_render_stats_t;
+
+/// Statistics for the congestion controller adapting published media bitrates.
+/// @ingroup Media
+typedef struct {
+    /// Total target bitrate in bits per second.
+    uint32_t target_bps;
+    /// Smoothed bitrate actually sent in bits per second.
+    uint32_t achieved_bps;
+    /// Share of the target given to the audio encoder.
+    uint32_t audio_target_bps;
+    /// Share of the target given to the video encoder.
+    uint32_t video_target_bps;
+    /// Standing send delay in milliseconds: how long sending a frame blocked on a
+    /// full socket buffer, taking the shortest per stream during the last update
+    /// interval and the longest of those.
+    uint32_t queue_delay_ms;
+    /// Number of times the target was reduced due to congestion.
+    uint32_t decreases;
+    /// Frames that could not be sent.
+    uint32_t send_failures;
+} livekit_bitrate_stats_t;
+
+/// Statistics for silence suppression of published audio.
+/// @ingroup Media
+typedef struct {
+    /// Encoded audio frames produced.
+    uint32_t frames;
+    /// Frames not sent because they carried silence.
+    uint32_t suppressed_frames;
+    /// Share of frames not sent, in percent.
+    uint8_t suppressed_percent;
+    /// Number of times sending resumed after silence.
+    uint32_t talk_spurts;
+} livekit_audio_dtx_stats_t;
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -326,7 +326,7 @@ typedef struct livekit_pb_speaker_info {
 
 typedef struct livekit_pb_user_packet {
     /* user defined payload */
-    pb_bytes_array_t *payload;
+    pb_callback_t payload;
     /* topic under which the message was published */
     char *topic;
 } livekit_pb_user_packet_t;
@@ -825,7 +825,7 @@ extern "C" {
 #define LIVEKIT_PB_ENCRYPTED_PACKET_INIT_DEFAULT {_LIVEKIT_PB_ENCRYPTION_TYPE_MIN, {{NULL}, NULL}, 0, {{NULL}, NULL}}
 #define LIVEKIT_PB_ENCRYPTED_PACKET_PAYLOAD_INIT_DEFAULT {0, {LIVEKIT_PB_USER_PACKET_INIT_DEFAULT}}
 #define LIVEKIT_PB_SPEAKER_INFO_INIT_DEFAULT     {{{NULL}, NULL}, 0, 0}
-#define LIVEKIT_PB_USER_PACKET_INIT_DEFAULT      {NULL, NULL}
+#define LIVEKIT_PB_USER_PACKET_INIT_DEFAULT      {{{NULL}, NULL}, NULL}
 #define LIVEKIT_PB_SIP_DTMF_INIT_DEFAULT         {0, ""}
 #define LIVEKIT_PB_TRANSCRIPTION_INIT_DEFAULT    {{{NULL}, NULL}, {{NULL}, NULL}, {{NULL}, NULL}}
 #define LIVEKIT_PB_TRANSCRIPTION_SEGMENT_INIT_DEFAULT {{{NULL}, NULL}, {{NULL}, NULL}, 0, 0, 0, {{NULL}, NULL}}
@@ -873,7 +873,7 @@ extern "C" {
 #define LIVEKIT_PB_ENCRYPTED_PACKET_INIT_ZERO    {_LIVEKIT_PB_ENCRYPTION_TYPE_MIN, {{NULL}, NULL}, 0, {{NULL}, NULL}}
 #define LIVEKIT_PB_ENCRYPTED_PACKET_PAYLOAD_INIT_ZERO {0, {LIVEKIT_PB_USER_PACKET_INIT_ZERO}}
 #define LIVEKIT_PB_SPEAKER_INFO_INIT_ZERO        {{{NULL}, NULL}, 0, 0}
-#define LIVEKIT_PB_USER_PACKET_INIT_ZERO         {NULL, NULL}
+#define LIVEKIT_PB_USER_PACKET_INIT_ZERO         {{{NULL}, NULL}, NULL}
 #define LIVEKIT_PB_SIP_DTMF_INIT_ZERO            {0, ""}
 #define LIVEKIT_PB_TRANSCRIPTION_INIT_ZERO       {{{NULL}, NULL}, {{NULL}, NULL}, {{NULL}, NULL}}
 #define LIVEKIT_PB_TRANSCRIPTION_SEGMENT_INIT_ZERO {{{NULL}, NULL}, {{NULL}, NULL}, 0, 0, 0, {{NULL}, NULL}}
@@ -1286,9 +1286,10 @@ X(a, STATIC,   SINGULAR, BOOL,     active,            3)
 #define LIVEKIT_PB_SPEAKER_INFO_DEFAULT NULL
 
 #define LIVEKIT_PB_USER_PACKET_FIELDLIST(X, a) \
-X(a, POINTER,  SINGULAR, BYTES,    payload,           2) \
+X(a, CALLBACK, SINGULAR, BYTES,    payload,           2) \
 X(a, POINTER,  OPTIONAL, STRING,   topic,             4)
-#define LIVEKIT_PB_USER_PACKET_CALLBACK NULL
+extern bool protocol_user_packet_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field);
+#define LIVEKIT_PB_USER_PACKET_CALLBACK protocol_user_packet_callback
 #define LIVEKIT_PB_USER_PACKET_DEFAULT NULL
 
 #define LIVEKIT_PB_SIP_DTMF_FIELDLIST(X, a) \
@@ -71,7 +71,7 @@ typedef struct livekit_pb_add_track_request {
     livekit_pb_video_layer_t layers[1];
     livekit_pb_backup_codec_policy_t backup_codec_policy;
     pb_size_t audio_features_count;
-    livekit_pb_audio_track_feature_t audio_features[1];
+    livekit_pb_audio_track_feature_t audio_features[2];
 } livekit_pb_add_track_request_t;
 
 typedef struct livekit_pb_trickle_request {
@@ -86,11 +86,6 @@ typedef struct livekit_pb_mute_track_request {
 } livekit_pb_mute_track_request_t;
 
 typedef struct livekit_pb_reconnect_response {
-    pb_callback_t ice_servers;
-    bool has_client_configuration;
-    livekit_pb_client_configuration_t client_configuration;
-    bool has_server_info;
-    livekit_pb_server_info_t server_info;
     /* last sequence number of reliable message received before resuming */
     uint32_t last_message_seq;
 } livekit_pb_reconnect_response_t;
@@ -110,8 +105,7 @@ typedef struct livekit_pb_session_description {
 } livekit_pb_session_description_t;
 
 typedef struct livekit_pb_participant_update {
-    pb_size_t participants_count;
-    struct livekit_pb_participant_info *participants;
+    pb_callback_t participants;
 } livekit_pb_participant_update_t;
 
 typedef struct livekit_pb_update_subscription {
@@ -182,8 +176,7 @@ typedef struct livekit_pb_join_response {
     bool has_room;
     livekit_pb_room_t room;
     livekit_pb_participant_info_t participant;
-    pb_size_t other_participants_count;
-    struct livekit_pb_participant_info *other_participants;
+    pb_callback_t other_participants;
     pb_size_t ice_servers_count;
     livekit_pb_ice_server_t ice_servers[4];
     /* use subscriber as the primary PeerConnection */
@@ -229,13 +222,13 @@ typedef struct livekit_pb_subscribed_quality {
 } livekit_pb_subscribed_quality_t;
 
 typedef struct livekit_pb_subscribed_codec {
-    pb_callback_t codec;
-    pb_callback_t qualities;
+    pb_size_t qualities_count;
+    livekit_pb_subscribed_quality_t qualities[3];
 } livekit_pb_subscribed_codec_t;
 
 typedef struct livekit_pb_subscribed_quality_update {
-    pb_callback_t track_sid;
-    pb_callback_t subscribed_codecs;
+    pb_size_t subscribed_codecs_count;
+    livekit_pb_subscribed_codec_t subscribed_codecs[2];
 } livekit_pb_subscribed_quality_update_t;
 
 typedef struct livekit_pb_subscribed_audio_codec_update {
@@ -393,6 +386,10 @@ typedef struct livekit_pb_signal_response {
         livekit_pb_leave_request_t leave;
         /* sent when metadata of the room has changed */
         livekit_pb_room_update_t room_update;
+        /* when max subscribe quality changed, used by dynamic broadcasting to disable unused layers */
+        livekit_pb_subscribed_quality_update_t subscribed_quality_update;
+        /* sent to the client when the resume is successful */
+        livekit_pb_reconnect_response_t reconnect;
         /* respond to ping */
         int64_t pong; /* deprecated by pong_resp (message Pong) */
         /* respond to Ping */
@@ -564,15 +561,15 @@ extern "C" {
 #define LIVEKIT_PB_SIGNAL_REQUEST_INIT_DEFAULT   {0, {LIVEKIT_PB_SESSION_DESCRIPTION_INIT_DEFAULT}}
 #define LIVEKIT_PB_SIGNAL_RESPONSE_INIT_DEFAULT  {0, {LIVEKIT_PB_JOIN_RESPONSE_INIT_DEFAULT}}
 #define LIVEKIT_PB_SIMULCAST_CODEC_INIT_DEFAULT  {{{NULL}, NULL}, {{NULL}, NULL}, {{NULL}, NULL}, _LIVEKIT_PB_VIDEO_LAYER_MODE_MIN}
-#define LIVEKIT_PB_ADD_TRACK_REQUEST_INIT_DEFAULT {"", "", _LIVEKIT_PB_TRACK_TYPE_MIN, 0, 0, 0, _LIVEKIT_PB_TRACK_SOURCE_MIN, 0, {LIVEKIT_PB_VIDEO_LAYER_INIT_DEFAULT}, _LIVEKIT_PB_BACKUP_CODEC_POLICY_MIN, 0, {_LIVEKIT_PB_AUDIO_TRACK_FEATURE_MIN}}
+#define LIVEKIT_PB_ADD_TRACK_REQUEST_INIT_DEFAULT {"", "", _LIVEKIT_PB_TRACK_TYPE_MIN, 0, 0, 0, _LIVEKIT_PB_TRACK_SOURCE_MIN, 0, {LIVEKIT_PB_VIDEO_LAYER_INIT_DEFAULT}, _LIVEKIT_PB_BACKUP_CODEC_POLICY_MIN, 0, {_LIVEKIT_PB_AUDIO_TRACK_FEATURE_MIN, _LIVEKIT_PB_AUDIO_TRACK_FEATURE_MIN}}
 #define LIVEKIT_PB_TRICKLE_REQUEST_INIT_DEFAULT  {NULL, _LIVEKIT_PB_SIGNAL_TARGET_MIN, 0}
 #define LIVEKIT_PB_MUTE_TRACK_REQUEST_INIT_DEFAULT {{{NULL}, NULL}, 0}
-#define LIVEKIT_PB_JOIN_RESPONSE_INIT_DEFAULT    {false, LIVEKIT_PB_ROOM_INIT_DEFAULT, LIVEKIT_PB_PARTICIPANT_INFO_INIT_DEFAULT, 0, NULL, 0, {LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT, LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT, LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT, LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT}, 0, false, LIVEKIT_PB_CLIENT_CONFIGURATION_INIT_DEFAULT, 0, 0}
-#define LIVEKIT_PB_RECONNECT_RESPONSE_INIT_DEFAULT {{{NULL}, NULL}, false, LIVEKIT_PB_CLIENT_CONFIGURATION_INIT_DEFAULT, false, LIVEKIT_PB_SERVER_INFO_INIT_DEFAULT, 0}
+#define LIVEKIT_PB_JOIN_RESPONSE_INIT_DEFAULT    {false, LIVEKIT_PB_ROOM_INIT_DEFAULT, LIVEKIT_PB_PARTICIPANT_INFO_INIT_DEFAULT, {{NULL}, NULL}, 0, {LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT, LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT, LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT, LIVEKIT_PB_ICE_SERVER_INIT_DEFAULT}, 0, false, LIVEKIT_PB_CLIENT_CONFIGURATION_INIT_DEFAULT, 0, 0}
+#define LIVEKIT_PB_RECONNECT_RESPONSE_INIT_DEFAULT {0}
 #define LIVEKIT_PB_TRACK_PUBLISHED_RESPONSE_INIT_DEFAULT {0}
 #define LIVEKIT_PB_TRACK_UNPUBLISHED_RESPONSE_INIT_DEFAULT {{{NULL}, NULL}}
 #define LIVEKIT_PB_SESSION_DESCRIPTION_INIT_DEFAULT {"", NULL, 0}
-#define LIVEKIT_PB_PARTICIPANT_UPDATE_INIT_DEFAULT {0, NULL}
+#define LIVEKIT_PB_PARTICIPANT_UPDATE_INIT_DEFAULT {{{NULL}, NULL}}
 #define LIVEKIT_PB_UPDATE_SUBSCRIPTION_INIT_DEFAULT {0, NULL, 0}
 #define LIVEKIT_PB_UPDATE_TRACK_SETTINGS_INIT_DEFAULT {{{NULL}, NULL}, 0, _LIVEKIT_PB_VIDEO_QUALITY_MIN, 0, 0, 0, 0}
 #define LIVEKIT_PB_UPDATE_LOCAL_AUDIO_TRACK_INIT_DEFAULT {{{NULL}, NULL}, {{NULL}, NULL}}
@@ -588,8 +585,8 @@ extern "C" {
 #define LIVEKIT_PB_STREAM_STATE_INFO_INIT_DEFAULT {{{NULL}, NULL}, {{NULL}, NULL}, _LIVEKIT_PB_STREAM_STATE_MIN}
 #define LIVEKIT_PB_STREAM_STATE_UPDATE_INIT_DEFAULT {{{NULL}, NULL}}
 #define LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_DEFAULT {_LIVEKIT_PB_VIDEO_QUALITY_MIN, 0}
-#define LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_DEFAULT {{{NULL}, NULL}, {{NULL}, NULL}}
-#define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_INIT_DEFAULT {{{NULL}, NULL}, {{NULL}, NULL}}
+#define LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_DEFAULT {0, {LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_DEFAULT, LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_DEFAULT, LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_DEFAULT}}
+#define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_INIT_DEFAULT {0, {LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_DEFAULT, LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_DEFAULT}}
 #define LIVEKIT_PB_SUBSCRIBED_AUDIO_CODEC_UPDATE_INIT_DEFAULT {{{NULL}, NULL}, {{NULL}, NULL}}
 #define LIVEKIT_PB_TRACK_PERMISSION_INIT_DEFAULT {{{NULL}, NULL}, 0, {{NULL}, NULL}, {{NULL}, NULL}}
 #define LIVEKIT_PB_SUBSCRIPTION_PERMISSION_INIT_DEFAULT {0, {{NULL}, NULL}}
@@ -613,15 +610,15 @@ extern "C" {
 #define LIVEKIT_PB_SIGNAL_REQUEST_INIT_ZERO      {0, {LIVEKIT_PB_SESSION_DESCRIPTION_INIT_ZERO}}
 #define LIVEKIT_PB_SIGNAL_RESPONSE_INIT_ZERO     {0, {LIVEKIT_PB_JOIN_RESPONSE_INIT_ZERO}}
 #define LIVEKIT_PB_SIMULCAST_CODEC_INIT_ZERO     {{{NULL}, NULL}, {{NULL}, NULL}, {{NULL}, NULL}, _LIVEKIT_PB_VIDEO_LAYER_MODE_MIN}
-#define LIVEKIT_PB_ADD_TRACK_REQUEST_INIT_ZERO   {"", "", _LIVEKIT_PB_TRACK_TYPE_MIN, 0, 0, 0, _LIVEKIT_PB_TRACK_SOURCE_MIN, 0, {LIVEKIT_PB_VIDEO_LAYER_INIT_ZERO}, _LIVEKIT_PB_BACKUP_CODEC_POLICY_MIN, 0, {_LIVEKIT_PB_AUDIO_TRACK_FEATURE_MIN}}
+#define LIVEKIT_PB_ADD_TRACK_REQUEST_INIT_ZERO   {"", "", _LIVEKIT_PB_TRACK_TYPE_MIN, 0, 0, 0, _LIVEKIT_PB_TRACK_SOURCE_MIN, 0, {LIVEKIT_PB_VIDEO_LAYER_INIT_ZERO}, _LIVEKIT_PB_BACKUP_CODEC_POLICY_MIN, 0, {_LIVEKIT_PB_AUDIO_TRACK_FEATURE_MIN, _LIVEKIT_PB_AUDIO_TRACK_FEATURE_MIN}}
 #define LIVEKIT_PB_TRICKLE_REQUEST_INIT_ZERO     {NULL, _LIVEKIT_PB_SIGNAL_TARGET_MIN, 0}
 #define LIVEKIT_PB_MUTE_TRACK_REQUEST_INIT_ZERO  {{{NULL}, NULL}, 0}
-#define LIVEKIT_PB_JOIN_RESPONSE_INIT_ZERO       {false, LIVEKIT_PB_ROOM_INIT_ZERO, LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO, 0, NULL, 0, {LIVEKIT_PB_ICE_SERVER_INIT_ZERO, LIVEKIT_PB_ICE_SERVER_INIT_ZERO, LIVEKIT_PB_ICE_SERVER_INIT_ZERO, LIVEKIT_PB_ICE_SERVER_INIT_ZERO}, 0, false, LIVEKIT_PB_CLIENT_CONFIGURATION_INIT_ZERO, 0, 0}
-#define LIVEKIT_PB_RECONNECT_RESPONSE_INIT_ZERO  {{{NULL}, NULL}, false, LIVEKIT_PB_CLIENT_CONFIGURATION_INIT_ZERO, false, LIVEKIT_PB_SERVER_INFO_INIT_ZERO, 0}
+#define LIVEKIT_PB_JOIN_RESPONSE_INIT_ZERO       {false, LIVEKIT_PB_ROOM_INIT_ZERO, LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO, {{NULL}, NULL}, 0, {LIVEKIT_PB_ICE_SERVER_INIT_ZERO, LIVEKIT_PB_ICE_SERVER_INIT_ZERO, LIVEKIT_PB_ICE_SERVER_INIT_ZERO, LIVEKIT_PB_ICE_SERVER_INIT_ZERO}, 0, false, LIVEKIT_PB_CLIENT_CONFIGURATION_INIT_ZERO, 0, 0}
+#define LIVEKIT_PB_RECONNECT_RESPONSE_INIT_ZERO  {0}
 #define LIVEKIT_PB_TRACK_PUBLISHED_RESPONSE_INIT_ZERO {0}
 #define LIVEKIT_PB_TRACK_UNPUBLISHED_RESPONSE_INIT_ZERO {{{NULL}, NULL}}
 #define LIVEKIT_PB_SESSION_DESCRIPTION_INIT_ZERO {"", NULL, 0}
-#define LIVEKIT_PB_PARTICIPANT_UPDATE_INIT_ZERO  {0, NULL}
+#define LIVEKIT_PB_PARTICIPANT_UPDATE_INIT_ZERO  {{{NULL}, NULL}}
 #define LIVEKIT_PB_UPDATE_SUBSCRIPTION_INIT_ZERO {0, NULL, 0}
 #define LIVEKIT_PB_UPDATE_TRACK_SETTINGS_INIT_ZERO {{{NULL}, NULL}, 0, _LIVEKIT_PB_VIDEO_QUALITY_MIN, 0, 0, 0, 0}
 #define LIVEKIT_PB_UPDATE_LOCAL_AUDIO_TRACK_INIT_ZERO {{{NULL}, NULL}, {{NULL}, NULL}}
@@ -637,8 +634,8 @@ extern "C" {
 #define LIVEKIT_PB_STREAM_STATE_INFO_INIT_ZERO   {{{NULL}, NULL}, {{NULL}, NULL}, _LIVEKIT_PB_STREAM_STATE_MIN}
 #define LIVEKIT_PB_STREAM_STATE_UPDATE_INIT_ZERO {{{NULL}, NULL}}
 #define LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_ZERO  {_LIVEKIT_PB_VIDEO_QUALITY_MIN, 0}
-#define LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_ZERO    {{{NULL}, NULL}, {{NULL}, NULL}}
-#define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_INIT_ZERO {{{NULL}, NULL}, {{NULL}, NULL}}
+#define LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_ZERO    {0, {LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_ZERO, LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_ZERO, LIVEKIT_PB_SUBSCRIBED_QUALITY_INIT_ZERO}}
+#define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_INIT_ZERO {0, {LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_ZERO, LIVEKIT_PB_SUBSCRIBED_CODEC_INIT_ZERO}}
 #define LIVEKIT_PB_SUBSCRIBED_AUDIO_CODEC_UPDATE_INIT_ZERO {{{NULL}, NULL}, {{NULL}, NULL}}
 #define LIVEKIT_PB_TRACK_PERMISSION_INIT_ZERO    {{{NULL}, NULL}, 0, {{NULL}, NULL}, {{NULL}, NULL}}
 #define LIVEKIT_PB_SUBSCRIPTION_PERMISSION_INIT_ZERO {0, {{NULL}, NULL}}
@@ -680,9 +677,6 @@ extern "C" {
 #define LIVEKIT_PB_TRICKLE_REQUEST_FINAL_TAG     3
 #define LIVEKIT_PB_MUTE_TRACK_REQUEST_SID_TAG    1
 #define LIVEKIT_PB_MUTE_TRACK_REQUEST_MUTED_TAG  2
-#define LIVEKIT_PB_RECONNECT_RESPONSE_ICE_SERVERS_TAG 1
-#define LIVEKIT_PB_RECONNECT_RESPONSE_CLIENT_CONFIGURATION_TAG 2
-#define LIVEKIT_PB_RECONNECT_RESPONSE_SERVER_INFO_TAG 3
 #define LIVEKIT_PB_RECONNECT_RESPONSE_LAST_MESSAGE_SEQ_TAG 4
 #define LIVEKIT_PB_TRACK_UNPUBLISHED_RESPONSE_TRACK_SID_TAG 1
 #define LIVEKIT_PB_SESSION_DESCRIPTION_TYPE_TAG  1
@@ -801,7 +795,9 @@ extern "C" {
 #define LIVEKIT_PB_SIGNAL_RESPONSE_UPDATE_TAG    5
 #define LIVEKIT_PB_SIGNAL_RESPONSE_LEAVE_TAG     8
 #define LIVEKIT_PB_SIGNAL_RESPONSE_ROOM_UPDATE_TAG 11
+#define LIVEKIT_PB_SIGNAL_RESPONSE_SUBSCRIBED_QUALITY_UPDATE_TAG 14
 #define LIVEKIT_PB_SIGNAL_RESPONSE_PONG_TAG      18
+#define LIVEKIT_PB_SIGNAL_RESPONSE_RECONNECT_TAG 19
 #define LIVEKIT_PB_SIGNAL_RESPONSE_PONG_RESP_TAG 20
 #define LIVEKIT_PB_REGION_SETTINGS_REGIONS_TAG   1
 #define LIVEKIT_PB_REGION_INFO_REGION_TAG        1
@@ -875,7 +871,9 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (message,trickle,message.trickle),   4) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (message,update,message.update),   5) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (message,leave,message.leave),   8) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (message,room_update,message.room_update),  11) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message,subscribed_quality_update,message.subscribed_quality_update),  14) \
 X(a, STATIC,   ONEOF,    INT64,    (message,pong,message.pong),  18) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (message,reconnect,message.reconnect),  19) \
 X(a, STATIC,   ONEOF,    MESSAGE,  (message,pong_resp,message.pong_resp),  20)
 #define LIVEKIT_PB_SIGNAL_RESPONSE_CALLBACK NULL
 #define LIVEKIT_PB_SIGNAL_RESPONSE_DEFAULT NULL
@@ -886,6 +884,8 @@ X(a, STATIC,   ONEOF,    MESSAGE,  (message,pong_resp,message.pong_resp),  20)
 #define livekit_pb_signal_response_t_message_update_MSGTYPE livekit_pb_participant_update_t
 #define livekit_pb_signal_response_t_message_leave_MSGTYPE livekit_pb_leave_request_t
 #define livekit_pb_signal_response_t_message_room_update_MSGTYPE livekit_pb_room_update_t
+#define livekit_pb_signal_response_t_message_subscribed_quality_update_MSGTYPE livekit_pb_subscribed_quality_update_t
+#define livekit_pb_signal_response_t_message_reconnect_MSGTYPE livekit_pb_reconnect_response_t
 #define livekit_pb_signal_response_t_message_pong_resp_MSGTYPE livekit_pb_pong_t
 
 #define LIVEKIT_PB_SIMULCAST_CODEC_FIELDLIST(X, a) \
@@ -928,13 +928,14 @@ X(a, STATIC,   SINGULAR, BOOL,     muted,             2)
 #define LIVEKIT_PB_JOIN_RESPONSE_FIELDLIST(X, a) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  room,              1) \
 X(a, STATIC,   REQUIRED, MESSAGE,  participant,       2) \
-X(a, POINTER,  REPEATED, MESSAGE,  other_participants,   3) \
+X(a, CALLBACK, REPEATED, MESSAGE,  other_participants,   3) \
 X(a, STATIC,   REPEATED, MESSAGE,  ice_servers,       5) \
 X(a, STATIC,   SINGULAR, BOOL,     subscriber_primary,   6) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  client_configuration,   8) \
 X(a, STATIC,   SINGULAR, INT32,    ping_timeout,     10) \
 X(a, STATIC,   SINGULAR, INT32,    ping_interval,    11)
-#define LIVEKIT_PB_JOIN_RESPONSE_CALLBACK NULL
+extern bool protocol_participants_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field);
+#define LIVEKIT_PB_JOIN_RESPONSE_CALLBACK protocol_participants_callback
 #define LIVEKIT_PB_JOIN_RESPONSE_DEFAULT NULL
 #define livekit_pb_join_response_t_room_MSGTYPE livekit_pb_room_t
 #define livekit_pb_join_response_t_participant_MSGTYPE livekit_pb_participant_info_t
@@ -943,15 +944,9 @@ X(a, STATIC,   SINGULAR, INT32,    ping_interval,    11)
 #define livekit_pb_join_response_t_client_configuration_MSGTYPE livekit_pb_client_configuration_t
 
 #define LIVEKIT_PB_RECONNECT_RESPONSE_FIELDLIST(X, a) \
-X(a, CALLBACK, REPEATED, MESSAGE,  ice_servers,       1) \
-X(a, STATIC,   OPTIONAL, MESSAGE,  client_configuration,   2) \
-X(a, STATIC,   OPTIONAL, MESSAGE,  server_info,       3) \
 X(a, STATIC,   SINGULAR, UINT32,   last_message_seq,   4)
-#define LIVEKIT_PB_RECONNECT_RESPONSE_CALLBACK pb_default_field_callback
+#define LIVEKIT_PB_RECONNECT_RESPONSE_CALLBACK NULL
 #define LIVEKIT_PB_RECONNECT_RESPONSE_DEFAULT NULL
-#define livekit_pb_reconnect_response_t_ice_servers_MSGTYPE livekit_pb_ice_server_t
-#define livekit_pb_reconnect_response_t_client_configuration_MSGTYPE livekit_pb_client_configuration_t
-#define livekit_pb_reconnect_response_t_server_info_MSGTYPE livekit_pb_server_info_t
 
 #define LIVEKIT_PB_TRACK_PUBLISHED_RESPONSE_FIELDLIST(X, a) \
 
@@ -971,8 +966,9 @@ X(a, STATIC,   SINGULAR, UINT32,   id,                3)
 #define LIVEKIT_PB_SESSION_DESCRIPTION_DEFAULT NULL
 
 #define LIVEKIT_PB_PARTICIPANT_UPDATE_FIELDLIST(X, a) \
-X(a, POINTER,  REPEATED, MESSAGE,  participants,      1)
-#define LIVEKIT_PB_PARTICIPANT_UPDATE_CALLBACK NULL
+X(a, CALLBACK, REPEATED, MESSAGE,  participants,      1)
+extern bool protocol_participants_callback(pb_istream_t *istream, pb_ostream_t *ostream, const pb_field_t *field);
+#define LIVEKIT_PB_PARTICIPANT_UPDATE_CALLBACK protocol_participants_callback
 #define LIVEKIT_PB_PARTICIPANT_UPDATE_DEFAULT NULL
 #define livekit_pb_participant_update_t_participants_MSGTYPE livekit_pb_participant_info_t
 
@@ -1079,16 +1075,14 @@ X(a, STATIC,   SINGULAR, BOOL,     enabled,           2)
 #define LIVEKIT_PB_SUBSCRIBED_QUALITY_DEFAULT NULL
 
 #define LIVEKIT_PB_SUBSCRIBED_CODEC_FIELDLIST(X, a) \
-X(a, CALLBACK, SINGULAR, STRING,   codec,             1) \
-X(a, CALLBACK, REPEATED, MESSAGE,  qualities,         2)
-#define LIVEKIT_PB_SUBSCRIBED_CODEC_CALLBACK pb_default_field_callback
+X(a, STATIC,   REPEATED, MESSAGE,  qualities,         2)
+#define LIVEKIT_PB_SUBSCRIBED_CODEC_CALLBACK NULL
 #define LIVEKIT_PB_SUBSCRIBED_CODEC_DEFAULT NULL
 #define livekit_pb_subscribed_codec_t_qualities_MSGTYPE livekit_pb_subscribed_quality_t
 
 #define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_FIELDLIST(X, a) \
-X(a, CALLBACK, SINGULAR, STRING,   track_sid,         1) \
-X(a, CALLBACK, REPEATED, MESSAGE,  subscribed_codecs,   3)
-#define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_CALLBACK pb_default_field_callback
+X(a, STATIC,   REPEATED, MESSAGE,  subscribed_codecs,   3)
+#define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_CALLBACK NULL
 #define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_DEFAULT NULL
 #define livekit_pb_subscribed_quality_update_t_subscribed_codecs_MSGTYPE livekit_pb_subscribed_codec_t
 
@@ -1386,8 +1380,6 @@ extern const pb_msgdesc_t livekit_pb_media_sections_requirement_t_msg;
 /* livekit_pb_ConnectionQualityUpdate_size depends on runtime parameters */
 /* livekit_pb_StreamStateInfo_size depends on runtime parameters */
 /* livekit_pb_StreamStateUpdate_size depends on runtime parameters */
-/* livekit_pb_SubscribedCodec_size depends on runtime parameters */
-/* livekit_pb_SubscribedQualityUpdate_size depends on runtime parameters */
 /* livekit_pb_SubscribedAudioCodecUpdate_size depends on runtime parameters */
 /* livekit_pb_TrackPermission_size depends on runtime parameters */
 /* livekit_pb_SubscriptionPermission_size depends on runtime parameters */
@@ -1403,14 +1395,17 @@ extern const pb_msgdesc_t livekit_pb_media_sections_requirement_t_msg;
 /* livekit_pb_JoinRequest_size depends on runtime parameters */
 /* livekit_pb_WrappedJoinRequest_size depends on runtime parameters */
 #define LIVEKIT_LIVEKIT_RTC_PB_H_MAX_SIZE        LIVEKIT_PB_ADD_TRACK_REQUEST_SIZE
-#define LIVEKIT_PB_ADD_TRACK_REQUEST_SIZE        69
+#define LIVEKIT_PB_ADD_TRACK_REQUEST_SIZE        72
 #define LIVEKIT_PB_CONNECTION_SETTINGS_SIZE      8
 #define LIVEKIT_PB_LEAVE_REQUEST_SIZE            4
 #define LIVEKIT_PB_MEDIA_SECTIONS_REQUIREMENT_SIZE 12
 #define LIVEKIT_PB_PING_SIZE                     22
 #define LIVEKIT_PB_PONG_SIZE                     22
+#define LIVEKIT_PB_RECONNECT_RESPONSE_SIZE       6
 #define LIVEKIT_PB_SIMULATE_SCENARIO_SIZE        11
+#define LIVEKIT_PB_SUBSCRIBED_CODEC_SIZE         18
 #define LIVEKIT_PB_SUBSCRIBED_QUALITY_SIZE       4
+#define LIVEKIT_PB_SUBSCRIBED_QUALITY_UPDATE_SIZE 40
 #define LIVEKIT_PB_TRACK_PUBLISHED_RESPONSE_SIZE 0
 #define LIVEKIT_PB_TRACK_SUBSCRIBED_SIZE         0
 #if defined(livekit_pb_Room_size)
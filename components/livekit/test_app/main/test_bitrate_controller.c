@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unity.h"
+
+#include "bitrate_controller.h"
+
+// The controller takes time as a parameter, so these tests drive it with a
+// simulated bottleneck link, reporting the signals the publish tasks observe.
+
+#define TICK_MS 5
+#define VIDEO_FRAME_MS 33
+#define AUDIO_FRAME_MS 20
+/// Socket send buffer in front of the bottleneck link.
+#define SEND_BUFFER_BYTES (32 * 1024)
+/// Sends that would block longer than this fail, as esp_peer's sends do once
+/// the socket buffer overflows.
+#define SEND_TIMEOUT_MS 100
+
+/// Bottleneck link with a fixed capacity, fed from the socket send buffer.
+typedef struct {
+    uint32_t capacity_bps;
+    uint64_t backlog_bits;
+    uint32_t drops;
+} link_t;
+
+/// Averages over the last part of a phase, after the controller has settled.
+typedef struct {
+    uint64_t target_sum;
+    uint32_t samples;
+    uint32_t min_target_bps;
+    uint32_t max_target_bps;
+    uint32_t drops;
+} phase_result_t;
+
+static const bitrate_controller_config_t config = {
+    .audio_min_bps = 16000,
+    .audio_max_bps = 32000,
+    .video_min_bps = 200000,
+    .video_max_bps = 2000000,
+    .start_bps = 500000,
+};
+
+/// Sends a frame and reports it like the publish tasks do, with the time the send
+/// call blocked until the frame fit into the socket's send buffer.
+static void link_send(link_t *link, bitrate_controller_handle_t bc, bitrate_stream_t stream, size_t bytes, uint32_t now)
+{
+    uint64_t bits = (uint64_t)bytes * 8;
+    uint64_t excess_bits = link->backlog_bits + bits > SEND_BUFFER_BYTES * 8 ?
+        link->backlog_bits + bits - SEND_BUFFER_BYTES * 8 : 0;
+    uint32_t blocked_ms = (uint32_t)(excess_bits * 1000 / link->capacity_bps);
+    bool dropped = blocked_ms > SEND_TIMEOUT_MS;
+    if (dropped) {
+        link->drops++;
+        blocked_ms = SEND_TIMEOUT_MS;
+    } else {
+        link->backlog_bits += bits;
+    }
+    bitrate_controller_on_sent(bc, stream, bytes, blocked_ms, dropped, now);
+}
+
+/// Runs the link for `duration_ms`, sampling the target during the last `settle_ms`.
+static void run_phase(
+    link_t *link,
+    bitrate_controller_handle_t bc,
+    uint32_t *now,
+    uint32_t duration_ms,
+    uint32_t settle_ms,
+    phase_result_t *result)
+{
+    *result = (phase_result_t){ .min_target_bps = UINT32_MAX };
+    uint32_t drops_before = link->drops;
+    uint32_t end = *now + duration_ms;
+    for (; *now < end; *now += TICK_MS) {
+        uint64_t drained = (uint64_t)link->capacity_bps * TICK_MS / 1000;
+        link->backlog_bits = link->backlog_bits > drained ? link->backlog_bits - drained : 0;
+
+        uint32_t audio_bps, video_bps;
+        bitrate_controller_get_targets(bc, &audio_bps, &video_bps);
+        if (*now % AUDIO_FRAME_MS == 0) {
+            link_send(link, bc, BITRATE_STREAM_AUDIO, audio_bps * AUDIO_FRAME_MS / 8000, *now);
+        }
+        if (*now % VIDEO_FRAME_MS < TICK_MS) {
+            // Every 30th frame is a keyframe, four times the size of the others.
+            uint32_t frame = (*now / VIDEO_FRAME_MS) % 30;
+            size_t bytes = (size_t)video_bps * VIDEO_FRAME_MS / 8000 * 30 / 33;
+            link_send(link, bc, BITRATE_STREAM_VIDEO, frame == 0 ? bytes * 4 : bytes, *now);
+        }
+        bitrate_controller_update(bc, *now);
+
+        if (end - *now <= settle_ms) {
+            livekit_bitrate_stats_t stats;
+            bitrate_controller_get_stats(bc, &stats);
+            result->target_sum += stats.target_bps;
+            result->samples++;
+            if (stats.target_bps < result->min_target_bps) result->min_target_bps = stats.target_bps;
+            if (stats.target_bps > result->max_target_bps) result->max_target_bps = stats.target_bps;
+        }
+    }
+    result->drops = link->drops - drops_before;
+}
+
+static void assert_tracks_capacity(const phase_result_t *result, uint32_t capacity_bps)
+{
+    uint32_t average = (uint32_t)(result->target_sum / result->samples);
+    TEST_ASSERT_GREATER_THAN_UINT32(capacity_bps / 2, average);
+    TEST_ASSERT_LESS_THAN_UINT32(capacity_bps + capacity_bps / 20, average);
+}
+
+TEST_CASE("bitrate controller splits target between audio and video", "[basic]")
+{
+    bitrate_controller_handle_t bc = bitrate_controller_create(&config);
+    TEST_ASSERT_NOT_NULL(bc);
+    uint32_t audio_bps, video_bps;
+    bitrate_controller_get_targets(bc, &audio_bps, &video_bps);
+    // Audio is served first, up to its maximum.
+    TEST_ASSERT_EQUAL_UINT32(32000, audio_bps);
+    TEST_ASSERT_EQUAL_UINT32(468000, video_bps);
+    bitrate_controller_destroy(bc);
+
+    bitrate_controller_config_t low = config;
+    low.start_bps = 0;
+    bc = bitrate_controller_create(&low);
+    TEST_ASSERT_NOT_NULL(bc);
+    bitrate_controller_get_targets(bc, &audio_bps, &video_bps);
+    TEST_ASSERT_EQUAL_UINT32(16000, audio_bps);
+    TEST_ASSERT_EQUAL_UINT32(200000, video_bps);
+    bitrate_controller_destroy(bc);
+
+    bitrate_controller_config_t invalid = config;
+    invalid.video_min_bps = invalid.video_max_bps + 1;
+    TEST_ASSERT_NULL(bitrate_controller_create(&invalid));
+}
+
+TEST_CASE("bitrate controller follows a changing bottleneck", "[basic]")
+{
+    bitrate_controller_handle_t bc = bitrate_controller_create(&config);
+    TEST_ASSERT_NOT_NULL(bc);
+    link_t link = { .capacity_bps = 2000000 };
+    uint32_t now = 1000;
+    phase_result_t result;
+
+    // Ramps up from the start bitrate without overshooting the link.
+    run_phase(&link, bc, &now, 30000, 10000, &result);
+    assert_tracks_capacity(&result, 2000000);
+
+    // Capacity drops to a quarter: backs off quickly and settles below it.
+    link.capacity_bps = 500000;
+    run_phase(&link, bc, &now, 20000, 10000, &result);
+    assert_tracks_capacity(&result, 500000);
+    // Only the backlog built up at the old capacity overflows: under 2% of frames.
+    TEST_ASSERT_LESS_THAN_UINT32((20000 / VIDEO_FRAME_MS + 20000 / AUDIO_FRAME_MS) / 50, result.drops);
+
+    // Capacity recovers: probes back up. Sends only block once the socket buffer
+    // is full, so probing may lose the odd frame, but most backoffs are triggered
+    // by the send delay rather than by lost frames.
+    livekit_bitrate_stats_t stats;
+    bitrate_controller_get_stats(bc, &stats);
+    uint32_t decreases_before = stats.decreases;
+    link.capacity_bps = 1500000;
+    run_phase(&link, bc, &now, 40000, 10000, &result);
+    assert_tracks_capacity(&result, 1500000);
+    TEST_ASSERT_LESS_THAN_UINT32((40000 / VIDEO_FRAME_MS + 40000 / AUDIO_FRAME_MS) / 200, result.drops);
+
+    bitrate_controller_get_stats(bc, &stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(result.drops, stats.decreases - decreases_before);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.decreases);
+    TEST_ASSERT_EQUAL_UINT32(link.drops, stats.send_failures);
+    bitrate_controller_destroy(bc);
+}
+
+TEST_CASE("bitrate controller never leaves configured range", "[basic]")
+{
+    bitrate_controller_handle_t bc = bitrate_controller_create(&config);
+    TEST_ASSERT_NOT_NULL(bc);
+    uint32_t now = 0;
+    phase_result_t result;
+
+    // Far below the minimum: holds the minimum rather than starving.
+    link_t link = { .capacity_bps = 100000 };
+    run_phase(&link, bc, &now, 10000, 5000, &result);
+    TEST_ASSERT_EQUAL_UINT32(216000, result.min_target_bps);
+    TEST_ASSERT_EQUAL_UINT32(216000, result.max_target_bps);
+
+    // Far above the maximum: capped at the maximum.
+    link = (link_t){ .capacity_bps = 10000000 };
+    run_phase(&link, bc, &now, 60000, 5000, &result);
+    TEST_ASSERT_EQUAL_UINT32(2032000, result.min_target_bps);
+    TEST_ASSERT_EQUAL_UINT32(2032000, result.max_target_bps);
+
+    bitrate_controller_reset(bc);
+    livekit_bitrate_stats_t stats;
+    bitrate_controller_get_stats(bc, &stats);
+    TEST_ASSERT_EQUAL_UINT32(500000, stats.target_bps);
+    bitrate_controller_destroy(bc);
+}
+
+TEST_CASE("bitrate controller tracks send delay per stream", "[basic]")
+{
+    bitrate_controller_handle_t bc = bitrate_controller_create(&config);
+    TEST_ASSERT_NOT_NULL(bc);
+
+    // Video sends block on a full socket buffer while the small audio frames in
+    // between still fit; the audio frames must not hide the standing delay.
+    uint32_t now = 0;
+    for (; now <= 1000; now += AUDIO_FRAME_MS) {
+        bitrate_controller_on_sent(bc, BITRATE_STREAM_AUDIO, 80, 0, false, now);
+        bitrate_controller_on_sent(bc, BITRATE_STREAM_VIDEO, 2000, 50, false, now);
+        bitrate_controller_update(bc, now);
+    }
+    livekit_bitrate_stats_t stats;
+    bitrate_controller_get_stats(bc, &stats);
+    TEST_ASSERT_EQUAL_UINT32(50, stats.queue_delay_ms);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.decreases);
+    TEST_ASSERT_LESS_THAN_UINT32(500000, stats.target_bps);
+    bitrate_controller_destroy(bc);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "data_dispatch.h"
+
+typedef struct {
+    SemaphoreHandle_t release_sem;
+    SemaphoreHandle_t handled_sem;
+} handler_ctx_t;
+
+/// Blocks until released to simulate a slow consumer.
+static void slow_handler(livekit_pb_data_packet_t *packet, void *ctx)
+{
+    handler_ctx_t *handler_ctx = (handler_ctx_t *)ctx;
+    TEST_ASSERT_EQUAL(LIVEKIT_PB_DATA_PACKET_USER_TAG, packet->which_value);
+    xSemaphoreTake(handler_ctx->release_sem, portMAX_DELAY);
+    xSemaphoreGive(handler_ctx->handled_sem);
+}
+
+TEST_CASE("data dispatch drops when queue is full", "[basic]")
+{
+    handler_ctx_t ctx = {
+        .release_sem = xSemaphoreCreateCounting(64, 0),
+        .handled_sem = xSemaphoreCreateCounting(64, 0),
+    };
+    data_dispatch_handle_t dispatch = data_dispatch_create(slow_handler, &ctx);
+    TEST_ASSERT_NOT_NULL(dispatch);
+
+    // The first packet is taken by the blocked handler, so one more than the
+    // queue depth fits before packets are dropped.
+    const uint32_t accepted = CONFIG_LK_DATA_DISPATCH_QUEUE_SIZE + 1;
+    const uint32_t sent = accepted + 3;
+    for (uint32_t i = 0; i < sent; i++) {
+        livekit_pb_data_packet_t packet = { .which_value = LIVEKIT_PB_DATA_PACKET_USER_TAG };
+        bool queued = data_dispatch_enqueue(dispatch, &packet);
+        if (i == 0) {
+            vTaskDelay(pdMS_TO_TICKS(20)); // Let the task pick up the first packet.
+        }
+        TEST_ASSERT_EQUAL(i < accepted, queued);
+    }
+
+    for (uint32_t i = 0; i < accepted; i++) {
+        xSemaphoreGive(ctx.release_sem);
+        TEST_ASSERT_TRUE(xSemaphoreTake(ctx.handled_sem, pdMS_TO_TICKS(1000)));
+    }
+    vTaskDelay(pdMS_TO_TICKS(20)); // Let the task record stats for the last packet.
+
+    livekit_data_dispatch_stats_t stats;
+    data_dispatch_get_stats(dispatch, &stats);
+    TEST_ASSERT_EQUAL(accepted, stats.dispatched);
+    TEST_ASSERT_EQUAL(sent - accepted, stats.dropped);
+    TEST_ASSERT_EQUAL(CONFIG_LK_DATA_DISPATCH_QUEUE_SIZE, stats.queue_high_water);
+    TEST_ASSERT_GREATER_OR_EQUAL(stats.avg_latency_us, stats.max_latency_us);
+
+    data_dispatch_destroy(dispatch);
+    vSemaphoreDelete(ctx.release_sem);
+    vSemaphoreDelete(ctx.handled_sem);
+}
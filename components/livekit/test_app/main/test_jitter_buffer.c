@@ -0,0 +1,203 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include "unity.h"
+
+#include "jitter_buffer.h"
+
+// The jitter buffer takes time as a parameter, so these tests replay arrival
+// traces deterministically.
+
+#define FRAME_MS 20
+#define POLL_MS 5
+#define MAX_TRACE 600
+
+/// Arrival of a single frame: sender pts and local arrival time.
+typedef struct {
+    uint32_t pts;
+    uint32_t arrival_ms;
+} arrival_t;
+
+typedef struct {
+    uint32_t played[MAX_TRACE];
+    size_t played_count;
+    /// Highest target delay seen during the first and last seconds of the replay.
+    uint32_t early_delay_ms;
+    uint32_t late_delay_ms;
+} replay_result_t;
+
+static const jitter_buffer_config_t config = {
+    .min_delay_ms = 20,
+    .max_delay_ms = 400,
+    .max_frames = 50,
+};
+
+/// Replays a trace (sorted by arrival time), polling for due frames like the playout task.
+static void replay(const arrival_t *trace, size_t count, jitter_buffer_handle_t jb, replay_result_t *result)
+{
+    *result = (replay_result_t){};
+    uint32_t end_ms = trace[count - 1].arrival_ms + 1000;
+    size_t next = 0;
+    for (uint32_t now = trace[0].arrival_ms; now <= end_ms; now += POLL_MS) {
+        while (next < count && trace[next].arrival_ms <= now) {
+            uint8_t payload = (uint8_t)trace[next].pts;
+            jitter_buffer_push(jb, trace[next].pts, &payload, sizeof(payload), trace[next].arrival_ms);
+            next++;
+        }
+        jitter_buffer_frame_t frame;
+        while (jitter_buffer_pop(jb, now, &frame)) {
+            TEST_ASSERT_EQUAL_UINT8((uint8_t)frame.pts, frame.data[0]);
+            TEST_ASSERT_LESS_THAN(MAX_TRACE, result->played_count);
+            result->played[result->played_count++] = frame.pts;
+            free(frame.data);
+        }
+        livekit_audio_jitter_stats_t stats;
+        jitter_buffer_get_stats(jb, &stats);
+        if (now < trace[0].arrival_ms + 3000 && stats.target_delay_ms > result->early_delay_ms) {
+            result->early_delay_ms = stats.target_delay_ms;
+        }
+        if (now + 1000 >= end_ms) {
+            result->late_delay_ms = stats.target_delay_ms;
+        }
+    }
+}
+
+static void assert_strictly_increasing(const replay_result_t *result)
+{
+    for (size_t i = 1; i < result->played_count; i++) {
+        TEST_ASSERT_GREATER_THAN_UINT32(result->played[i - 1], result->played[i]);
+    }
+}
+
+TEST_CASE("jitter buffer reorders and conceals", "[basic]")
+{
+    // 1 s of 20 ms frames: frames 10/11 swapped in flight, frame 25 lost.
+    static arrival_t trace[50];
+    size_t count = 0;
+    for (uint32_t i = 0; i < 50; i++) {
+        if (i == 25) continue;
+        uint32_t seq = (i == 10) ? 11 : (i == 11) ? 10 : i;
+        trace[count++] = (arrival_t){ .pts = 1000 + seq * FRAME_MS, .arrival_ms = 5000 + i * FRAME_MS + 3 };
+    }
+    jitter_buffer_handle_t jb = jitter_buffer_create(&config);
+    TEST_ASSERT_NOT_NULL(jb);
+    replay_result_t result;
+    replay(trace, count, jb, &result);
+
+    livekit_audio_jitter_stats_t stats;
+    jitter_buffer_get_stats(jb, &stats);
+    TEST_ASSERT_EQUAL(49, result.played_count);
+    assert_strictly_increasing(&result);
+    TEST_ASSERT_EQUAL(1, stats.concealed);
+    TEST_ASSERT_EQUAL(0, stats.late_dropped);
+    TEST_ASSERT_EQUAL(0, stats.buffered_frames);
+    jitter_buffer_destroy(jb);
+}
+
+TEST_CASE("jitter buffer adapts delay to jitter", "[basic]")
+{
+    // 3 s of heavy jitter (up to 80 ms per frame, as seen on congested Wi-Fi),
+    // followed by 8 s of clean arrivals.
+    static arrival_t trace[550];
+    uint32_t seed = 12345;
+    size_t count = 550;
+    for (uint32_t i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t delay = i < 150 ? (seed >> 16) % 80 : 0;
+        trace[i] = (arrival_t){ .pts = i * FRAME_MS, .arrival_ms = 100 + i * FRAME_MS + delay };
+    }
+    // Jittered arrivals can overtake each other; replay in arrival order.
+    for (size_t i = 1; i < count; i++) {
+        for (size_t j = i; j > 0 && trace[j - 1].arrival_ms > trace[j].arrival_ms; j--) {
+            arrival_t tmp = trace[j];
+            trace[j] = trace[j - 1];
+            trace[j - 1] = tmp;
+        }
+    }
+    jitter_buffer_handle_t jb = jitter_buffer_create(&config);
+    TEST_ASSERT_NOT_NULL(jb);
+    replay_result_t result;
+    replay(trace, count, jb, &result);
+
+    livekit_audio_jitter_stats_t stats;
+    jitter_buffer_get_stats(jb, &stats);
+    assert_strictly_increasing(&result);
+    TEST_ASSERT_GREATER_THAN_UINT32(100, result.early_delay_ms);
+    TEST_ASSERT_LESS_THAN_UINT32(result.early_delay_ms / 2, result.late_delay_ms);
+    // Most frames survive the jittery phase once the delay has adapted.
+    TEST_ASSERT_LESS_THAN_UINT32(count / 10, stats.late_dropped + stats.concealed);
+    TEST_ASSERT_EQUAL(count, stats.played + stats.late_dropped);
+    jitter_buffer_destroy(jb);
+}
+
+TEST_CASE("jitter buffer drops frames delayed by a stall", "[basic]")
+{
+    // Frames 50..64 are held up by a 300 ms stall and then arrive in a burst.
+    static arrival_t trace[150];
+    for (uint32_t i = 0; i < 150; i++) {
+        uint32_t arrival = i * FRAME_MS;
+        if (i >= 50 && i < 65) arrival = 65 * FRAME_MS;
+        trace[i] = (arrival_t){ .pts = i * FRAME_MS, .arrival_ms = arrival };
+    }
+    jitter_buffer_handle_t jb = jitter_buffer_create(&config);
+    TEST_ASSERT_NOT_NULL(jb);
+    replay_result_t result;
+    replay(trace, 150, jb, &result);
+
+    livekit_audio_jitter_stats_t stats;
+    jitter_buffer_get_stats(jb, &stats);
+    assert_strictly_increasing(&result);
+    // Stalled frames are dropped rather than played late, so delay does not creep up.
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.late_dropped);
+    TEST_ASSERT_EQUAL(150, stats.played + stats.late_dropped);
+    TEST_ASSERT_EQUAL_UINT32(149 * FRAME_MS, result.played[result.played_count - 1]);
+    jitter_buffer_destroy(jb);
+}
+
+TEST_CASE("jitter buffer converts RTP timestamps across rollover", "[basic]")
+{
+    // 48 kHz Opus timestamps (960 per 20 ms frame) wrapping past UINT32_MAX.
+    jitter_buffer_handle_t jb = jitter_buffer_create(&config);
+    TEST_ASSERT_NOT_NULL(jb);
+    jitter_buffer_set_clock_rate(jb, 48000);
+    uint32_t first_pts = UINT32_MAX - 2 * 960;
+    for (uint32_t i = 0; i < 6; i++) {
+        uint8_t payload = (uint8_t)i;
+        TEST_ASSERT_EQUAL(JITTER_BUFFER_ERR_NONE,
+            jitter_buffer_push(jb, first_pts + i * 960, &payload, sizeof(payload), 100 + i * FRAME_MS));
+    }
+    uint32_t played[6];
+    size_t played_count = 0;
+    jitter_buffer_frame_t frame;
+    for (uint32_t now = 100; now <= 1000 && played_count < 6; now += POLL_MS) {
+        while (jitter_buffer_pop(jb, now, &frame)) {
+            TEST_ASSERT_EQUAL_UINT8(played_count, frame.data[0]);
+            played[played_count++] = frame.pts;
+            free(frame.data);
+        }
+    }
+    // Released pts are milliseconds, spaced one frame apart through the rollover.
+    TEST_ASSERT_EQUAL(6, played_count);
+    for (size_t i = 1; i < played_count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(FRAME_MS, played[i] - played[i - 1]);
+    }
+    livekit_audio_jitter_stats_t stats;
+    jitter_buffer_get_stats(jb, &stats);
+    TEST_ASSERT_EQUAL(0, stats.concealed);
+    TEST_ASSERT_EQUAL(0, stats.late_dropped);
+    jitter_buffer_destroy(jb);
+}
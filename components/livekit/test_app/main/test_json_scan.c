@@ -0,0 +1,229 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+#include "esp_timer.h"
+#include "unity.h"
+
+#include "json_scan.h"
+
+#define CANDIDATE "candidate:842163049 1 udp 1677729535 203.0.113.7 46154 typ srflx raddr 0.0.0.0 rport 0 generation 0 ufrag sXrD network-cost 999"
+#define CANDIDATE_INIT "{\"candidate\":\"" CANDIDATE "\",\"sdpMid\":\"0\",\"sdpMLineIndex\":0,\"usernameFragment\":\"sXrD\"}"
+
+#define FUZZ_ITERATIONS 20000
+#define BENCH_ITERATIONS 2000
+
+/// Runs the scanner over a copy of `json`, leaving the decoded value in `buf`.
+static json_scan_err_t scan(const char *json, const char *key, char *buf, size_t buf_size, const char **value)
+{
+    size_t len = strlen(json);
+    TEST_ASSERT_LESS_THAN(buf_size, len);
+    memcpy(buf, json, len + 1);
+    return json_scan_get_string(buf, len, key, value, NULL);
+}
+
+static void assert_value(const char *json, const char *key, const char *expected)
+{
+    char buf[256];
+    const char *value = NULL;
+    TEST_ASSERT_EQUAL(JSON_SCAN_ERR_NONE, scan(json, key, buf, sizeof(buf), &value));
+    TEST_ASSERT_EQUAL_STRING(expected, value);
+}
+
+static void assert_error(const char *json, const char *key, json_scan_err_t expected)
+{
+    char buf[256];
+    const char *value = NULL;
+    TEST_ASSERT_EQUAL(expected, scan(json, key, buf, sizeof(buf), &value));
+    TEST_ASSERT_NULL(value);
+    // Failed scans leave the input untouched
+    TEST_ASSERT_EQUAL_STRING(json, buf);
+}
+
+TEST_CASE("json scan extracts candidate", "[basic]")
+{
+    char buf[sizeof(CANDIDATE_INIT)];
+    memcpy(buf, CANDIDATE_INIT, sizeof(buf));
+    const char *value = NULL;
+    size_t value_len = 0;
+    TEST_ASSERT_EQUAL(JSON_SCAN_ERR_NONE,
+        json_scan_get_string(buf, strlen(buf), "candidate", &value, &value_len));
+    TEST_ASSERT_EQUAL_STRING(CANDIDATE, value);
+    TEST_ASSERT_EQUAL(strlen(CANDIDATE), value_len);
+    // The value is a view into the buffer
+    TEST_ASSERT_TRUE(value > buf && value < buf + sizeof(buf));
+
+    assert_value(CANDIDATE_INIT, "sdpMid", "0");
+    assert_value(CANDIDATE_INIT, "usernameFragment", "sXrD");
+}
+
+TEST_CASE("json scan decodes escapes", "[basic]")
+{
+    assert_value("{\"k\":\"a\\\"b\\\\c\\/d\\be\\ff\\ng\\rh\\ti\"}", "k", "a\"b\\c/d\be\ff\ng\rh\ti");
+    assert_value("{\"k\":\"\\u0041\\u00e9\\u20AC\"}", "k", "A\xC3\xA9\xE2\x82\xAC");
+    // Surrogate pair for U+1F600
+    assert_value("{\"k\":\"\\ud83d\\ude00\"}", "k", "\xF0\x9F\x98\x80");
+    // Raw UTF-8 passes through
+    assert_value("{\"k\":\"\xC3\xA9\"}", "k", "\xC3\xA9");
+    assert_value("{\"k\":\"\"}", "k", "");
+    // Keys are compared after decoding
+    assert_value("{\"c\\u0061ndidate\":\"x\"}", "candidate", "x");
+    assert_value("{\"can\":\"no\",\"candidate\":\"x\",\"candidates\":\"no\"}", "candidate", "x");
+}
+
+TEST_CASE("json scan skips nested values", "[basic]")
+{
+    assert_value(" { \"a\" : [1, -2.5e+3, 0, true, false, null, {\"candidate\":\"no\"}, []],"
+        " \"b\": {\"c\": {\"d\": \"}\"}}, \"candidate\" : \"x\" }\r\n", "candidate", "x");
+    // First of duplicate keys wins
+    assert_value("{\"k\":\"first\",\"k\":\"second\"}", "k", "first");
+}
+
+TEST_CASE("json scan rejects invalid input", "[basic]")
+{
+    assert_error("{\"k\":1}", "k", JSON_SCAN_ERR_TYPE);
+    assert_error("{\"k\":null}", "k", JSON_SCAN_ERR_TYPE);
+    assert_error("{\"k\":\"x\"}", "candidate", JSON_SCAN_ERR_NOT_FOUND);
+    assert_error("{}", "k", JSON_SCAN_ERR_NOT_FOUND);
+
+    const char *invalid[] = {
+        "", "[]", "\"k\"", "{", "{\"k\"}", "{\"k\":}", "{\"k\":\"x\",}", "{\"k\":\"x\"",
+        "{\"k\":\"x}", "{\"k\":\"x\"} x", "{\"k\":\"x\"}}", "{'k':\"x\"}", "{k:\"x\"}",
+        "{\"k\":\"x\" \"j\":1}", "{\"k\":\"\\x\"}", "{\"k\":\"\\u12\"}", "{\"k\":\"\\u0000\"}",
+        "{\"k\":\"\\ud83d\"}", "{\"k\":\"\\ude00\"}", "{\"k\":\"\\ud83d\\u0041\"}",
+        "{\"k\":\"a\nb\"}", "{\"k\":\"x\",\"n\":01}", "{\"k\":\"x\",\"n\":1.}",
+        "{\"k\":\"x\",\"n\":-}", "{\"k\":\"x\",\"n\":1e}", "{\"k\":\"x\",\"n\":+1}",
+        "{\"k\":\"x\",\"n\":tru}", "{\"k\":\"x\",\"n\":[1,]}", "{\"k\":\"x\",\"n\":[1 2]}",
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert_error(invalid[i], "k", JSON_SCAN_ERR_SYNTAX);
+    }
+
+    // Nesting beyond the depth limit
+    char deep[2 * JSON_SCAN_MAX_DEPTH + 16];
+    char *p = deep;
+    p += sprintf(p, "{\"n\":");
+    for (int i = 0; i < JSON_SCAN_MAX_DEPTH; i++) *p++ = '[';
+    for (int i = 0; i < JSON_SCAN_MAX_DEPTH; i++) *p++ = ']';
+    sprintf(p, ",\"k\":\"x\"}");
+    assert_error(deep, "k", JSON_SCAN_ERR_SYNTAX);
+
+    // Scanning stops at the given length
+    char buf[] = "{\"k\":\"x\"}";
+    const char *value = NULL;
+    TEST_ASSERT_EQUAL(JSON_SCAN_ERR_SYNTAX, json_scan_get_string(buf, sizeof(buf) - 2, "k", &value, NULL));
+    TEST_ASSERT_EQUAL(JSON_SCAN_ERR_INVALID_ARG, json_scan_get_string(NULL, 0, "k", &value, NULL));
+}
+
+TEST_CASE("json scan agrees with cJSON on mutated input", "[fuzz]")
+{
+    static const char *seeds[] = {
+        CANDIDATE_INIT,
+        "{\"candidate\":\"a\\\"b\\\\c\\u00e9\\ud83d\\ude00\",\"sdpMid\":null,\"x\":[1,{\"y\":-0.5e2}]}",
+        "{ \"sdpMLineIndex\" : 0 , \"candidate\" : \"\" }",
+    };
+    const char mutations[] = "{}[]\":,\\u0123456789abcdefE+-.ntrl \t\n";
+    char input[sizeof(CANDIDATE_INIT) + 8];
+    char buf[sizeof(input)];
+    uint32_t seed = 1;
+    uint32_t accepted = 0;
+
+    for (uint32_t i = 0; i < FUZZ_ITERATIONS; i++) {
+        const char *source = seeds[i % (sizeof(seeds) / sizeof(seeds[0]))];
+        size_t len = strlen(source);
+        memcpy(input, source, len + 1);
+
+        // Apply a few random byte replacements, insertions or truncations
+        seed = seed * 1103515245u + 12345u;
+        uint32_t count = 1 + (seed >> 16) % 4;
+        for (uint32_t m = 0; m < count && len > 0; m++) {
+            seed = seed * 1103515245u + 12345u;
+            size_t pos = (seed >> 8) % len;
+            char byte = mutations[(seed >> 20) % (sizeof(mutations) - 1)];
+            switch ((seed >> 28) % 4) {
+                case 0:
+                case 1:
+                    input[pos] = byte;
+                    break;
+                case 2:
+                    if (len + 1 < sizeof(input)) {
+                        memmove(&input[pos + 1], &input[pos], len - pos + 1);
+                        input[pos] = byte;
+                        len++;
+                    }
+                    break;
+                default:
+                    len = pos;
+                    input[len] = '\0';
+                    break;
+            }
+        }
+
+        memcpy(buf, input, len + 1);
+        const char *value = NULL;
+        json_scan_err_t err = json_scan_get_string(buf, len, "candidate", &value, NULL);
+        if (err != JSON_SCAN_ERR_NONE) {
+            TEST_ASSERT_EQUAL_STRING(input, buf);
+            continue;
+        }
+        // The scanner is at least as strict as cJSON and must agree when it accepts
+        cJSON *root = cJSON_Parse(input);
+        TEST_ASSERT_NOT_NULL_MESSAGE(root, input);
+        cJSON *candidate = cJSON_GetObjectItemCaseSensitive(root, "candidate");
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_IsString(candidate), input);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(candidate->valuestring, value, input);
+        cJSON_Delete(root);
+        accepted++;
+    }
+    printf("Fuzz: %" PRIu32 " of %d mutated inputs accepted\n", accepted, FUZZ_ITERATIONS);
+    TEST_ASSERT_GREATER_THAN(0, accepted);
+}
+
+TEST_CASE("json scan benchmark", "[benchmark]")
+{
+    // Both paths copy the input, as decoding consumes it
+    char buf[sizeof(CANDIDATE_INIT)];
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        cJSON *root = cJSON_Parse(CANDIDATE_INIT);
+        cJSON *candidate = cJSON_GetObjectItemCaseSensitive(root, "candidate");
+        char *copy = strdup(candidate->valuestring);
+        TEST_ASSERT_NOT_NULL(copy);
+        free(copy);
+        cJSON_Delete(root);
+    }
+    int64_t cjson_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        memcpy(buf, CANDIDATE_INIT, sizeof(buf));
+        const char *value = NULL;
+        TEST_ASSERT_EQUAL(JSON_SCAN_ERR_NONE,
+            json_scan_get_string(buf, sizeof(buf) - 1, "candidate", &value, NULL));
+    }
+    int64_t scan_us = esp_timer_get_time() - start;
+
+    int64_t cjson_ns = cjson_us * 1000 / BENCH_ITERATIONS;
+    int64_t scan_ns = scan_us * 1000 / BENCH_ITERATIONS;
+    printf("[BENCH] Candidate extraction (%d bytes): cJSON=%" PRId64 "ns, scan=%" PRId64 "ns\n",
+        (int)sizeof(CANDIDATE_INIT) - 1, cjson_ns, scan_ns);
+    TEST_ASSERT_LESS_THAN(cjson_ns, scan_ns);
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+
+#include "participant_cache.h"
+
+static livekit_pb_participant_info_t make_participant(const char *sid, char *identity, char *name, char *metadata)
+{
+    livekit_pb_participant_info_t info = LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO;
+    snprintf(info.sid, sizeof(info.sid), "%s", sid);
+    info.identity = identity;
+    info.name = name;
+    info.metadata = metadata;
+    info.state = LIVEKIT_PB_PARTICIPANT_INFO_STATE_ACTIVE;
+    return info;
+}
+
+static uint32_t update(participant_cache_handle_t cache, const livekit_pb_participant_info_t *info)
+{
+    livekit_participant_info_t out;
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NONE, participant_cache_update(cache, info, &out));
+    TEST_ASSERT_EQUAL_STRING(info->sid, out.sid);
+    return out.changed_fields;
+}
+
+TEST_CASE("participant cache reports changed fields", "[basic]")
+{
+    participant_cache_handle_t cache = participant_cache_create(8);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    // Strings are compared by value, not by pointer.
+    char identity[] = "device", name[] = "Device", other_name[] = "Device";
+    livekit_pb_participant_info_t info = make_participant("PA_1", identity, name, NULL);
+    TEST_ASSERT_EQUAL(LIVEKIT_PARTICIPANT_FIELD_ALL, update(cache, &info));
+    info.name = other_name;
+    TEST_ASSERT_EQUAL(0, update(cache, &info));
+
+    // Empty and omitted strings are the same.
+    char empty[] = "";
+    info.metadata = empty;
+    TEST_ASSERT_EQUAL(0, update(cache, &info));
+
+    char renamed[] = "Renamed", metadata[] = "{}";
+    info.name = renamed;
+    info.metadata = metadata;
+    TEST_ASSERT_EQUAL(LIVEKIT_PARTICIPANT_FIELD_NAME | LIVEKIT_PARTICIPANT_FIELD_METADATA, update(cache, &info));
+
+    info.kind = LIVEKIT_PB_PARTICIPANT_INFO_KIND_AGENT;
+    info.state = LIVEKIT_PB_PARTICIPANT_INFO_STATE_DISCONNECTED;
+    TEST_ASSERT_EQUAL(LIVEKIT_PARTICIPANT_FIELD_KIND | LIVEKIT_PARTICIPANT_FIELD_STATE, update(cache, &info));
+
+    livekit_participant_info_t out;
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NONE, participant_cache_get(cache, "PA_1", &out));
+    TEST_ASSERT_EQUAL_STRING("Renamed", out.name);
+    TEST_ASSERT_EQUAL(LIVEKIT_PARTICIPANT_KIND_AGENT, out.kind);
+    TEST_ASSERT_EQUAL(LIVEKIT_PARTICIPANT_STATE_DISCONNECTED, out.state);
+    participant_cache_release(cache, &out);
+
+    participant_cache_stats_t stats;
+    participant_cache_get_stats(cache, &stats);
+    TEST_ASSERT_EQUAL(5, stats.updates);
+    TEST_ASSERT_EQUAL(2, stats.unchanged);
+    participant_cache_destroy(cache);
+}
+
+TEST_CASE("participant cache interns strings and keeps snapshots", "[basic]")
+{
+    participant_cache_handle_t cache = participant_cache_create(8);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    char identity_1[] = "listener-1", identity_2[] = "listener-2";
+    char name[] = "Listener", metadata[] = "{\"role\":\"listener\"}";
+    livekit_pb_participant_info_t info_1 = make_participant("PA_1", identity_1, name, metadata);
+    livekit_pb_participant_info_t info_2 = make_participant("PA_2", identity_2, name, metadata);
+    update(cache, &info_1);
+    update(cache, &info_2);
+
+    // Two SIDs, two identities, and one shared name and metadata
+    participant_cache_stats_t stats;
+    participant_cache_get_stats(cache, &stats);
+    TEST_ASSERT_EQUAL(2, stats.participants);
+    TEST_ASSERT_EQUAL(6, stats.strings);
+
+    livekit_participant_info_t snapshot;
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NONE, participant_cache_get(cache, "PA_1", &snapshot));
+    livekit_participant_info_t other;
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NONE, participant_cache_get(cache, "PA_2", &other));
+    TEST_ASSERT_TRUE(snapshot.metadata == other.metadata);
+    participant_cache_release(cache, &other);
+
+    // The snapshot outlives updates and removal of the participant.
+    char renamed[] = "Renamed";
+    info_1.name = renamed;
+    update(cache, &info_1);
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NONE, participant_cache_remove(cache, "PA_1"));
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NOT_FOUND, participant_cache_get(cache, "PA_1", &other));
+    TEST_ASSERT_EQUAL_STRING("PA_1", snapshot.sid);
+    TEST_ASSERT_EQUAL_STRING("listener-1", snapshot.identity);
+    TEST_ASSERT_EQUAL_STRING("Listener", snapshot.name);
+    participant_cache_release(cache, &snapshot);
+    TEST_ASSERT_NULL(snapshot.sid);
+
+    participant_cache_clear(cache);
+    participant_cache_get_stats(cache, &stats);
+    TEST_ASSERT_EQUAL(0, stats.participants);
+    TEST_ASSERT_EQUAL(0, stats.strings);
+    TEST_ASSERT_EQUAL(0, stats.string_bytes);
+    participant_cache_destroy(cache);
+}
+
+TEST_CASE("participant cache stays within its limit", "[basic]")
+{
+    participant_cache_handle_t cache = participant_cache_create(16);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    char identity[] = "listener";
+    livekit_participant_info_t out;
+    for (int i = 0; i < 20; i++) {
+        char sid[16];
+        snprintf(sid, sizeof(sid), "PA_%d", i);
+        livekit_pb_participant_info_t info = make_participant(sid, identity, NULL, NULL);
+        participant_cache_err_t expected = i < 16 ? PARTICIPANT_CACHE_ERR_NONE : PARTICIPANT_CACHE_ERR_FULL;
+        TEST_ASSERT_EQUAL(expected, participant_cache_update(cache, &info, &out));
+    }
+    // Space frees up as participants leave.
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NONE, participant_cache_remove(cache, "PA_3"));
+    livekit_pb_participant_info_t info = make_participant("PA_16", identity, NULL, NULL);
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_NONE, participant_cache_update(cache, &info, &out));
+    TEST_ASSERT_EQUAL(PARTICIPANT_CACHE_ERR_INVALID_ARG, participant_cache_update(cache, NULL, &out));
+
+    participant_cache_stats_t stats;
+    participant_cache_get_stats(cache, &stats);
+    TEST_ASSERT_EQUAL(16, stats.participants);
+    participant_cache_destroy(cache);
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_timer.h"
+#include "pb_encode.h"
+#include "unity.h"
+
+#include "protocol.h"
+#include "protocol_arena.h"
+#include "protocol_encoder.h"
+
+#define PARTICIPANT_COUNT 30
+#define DECODE_ITERATIONS 100
+
+/// Encodes a participant update resembling a busy room.
+static size_t encode_participant_update(uint8_t *buf, size_t buf_size)
+{
+    // Participant lists can only be decoded, so the update is encoded by hand.
+    static uint8_t update[4096];
+    pb_ostream_t update_stream = pb_ostream_from_buffer(update, sizeof(update));
+
+    for (int i = 0; i < PARTICIPANT_COUNT; i++) {
+        char identity[24];
+        snprintf(identity, sizeof(identity), "identity-%d", i);
+        livekit_pb_participant_info_t participant = LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO;
+        snprintf(participant.sid, sizeof(participant.sid), "PA_%d", i);
+        participant.identity = identity;
+        participant.name = identity;
+        participant.metadata = identity;
+        TEST_ASSERT_TRUE(pb_encode_tag(&update_stream, PB_WT_STRING, LIVEKIT_PB_PARTICIPANT_UPDATE_PARTICIPANTS_TAG));
+        TEST_ASSERT_TRUE(pb_encode_submessage(&update_stream, LIVEKIT_PB_PARTICIPANT_INFO_FIELDS, &participant));
+    }
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, buf_size);
+    TEST_ASSERT_TRUE(pb_encode_tag(&stream, PB_WT_STRING, LIVEKIT_PB_SIGNAL_RESPONSE_UPDATE_TAG));
+    TEST_ASSERT_TRUE(pb_encode_string(&stream, update, update_stream.bytes_written));
+    return stream.bytes_written;
+}
+
+typedef struct {
+    int visited;
+    /// Heap allocations outstanding while visiting the first participant.
+    int32_t outstanding;
+} visit_ctx_t;
+
+static void visit_participant(const livekit_pb_participant_info_t *participant, void *ctx)
+{
+    visit_ctx_t *visit = (visit_ctx_t *)ctx;
+    char identity[24];
+    snprintf(identity, sizeof(identity), "identity-%d", visit->visited);
+    TEST_ASSERT_EQUAL_STRING(identity, participant->identity);
+
+    // Earlier participants have been released, so memory use does not grow with
+    // the number visited; a participant takes one or two arena chunks.
+    protocol_arena_stats_t stats;
+    protocol_arena_get_stats(&stats);
+    int32_t outstanding = (int32_t)(stats.heap_allocs - stats.heap_frees);
+    if (visit->visited == 0) {
+        visit->outstanding = outstanding;
+    }
+    TEST_ASSERT_INT32_WITHIN(1, visit->outstanding, outstanding);
+    visit->visited++;
+}
+
+/// Decodes the message repeatedly, visiting its participants and returning the
+/// average time per decode.
+static int64_t decode_repeatedly(const uint8_t *buf, size_t len, protocol_arena_stats_t *stats)
+{
+    protocol_arena_reset_stats();
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < DECODE_ITERATIONS; i++) {
+        livekit_pb_signal_response_t res = {};
+        TEST_ASSERT_TRUE(protocol_signal_response_decode(buf, len, false, &res));
+        TEST_ASSERT_EQUAL(PARTICIPANT_COUNT, protocol_participants_count(&res.message.update.participants));
+        visit_ctx_t visit = {};
+        TEST_ASSERT_TRUE(protocol_participants_visit(&res.message.update.participants, visit_participant, &visit));
+        TEST_ASSERT_EQUAL(PARTICIPANT_COUNT, visit.visited);
+        protocol_signal_response_free(&res);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    protocol_arena_get_stats(stats);
+    return elapsed / DECODE_ITERATIONS;
+}
+
+TEST_CASE("protocol arena decode and release", "[basic]")
+{
+    static uint8_t buf[4096];
+    size_t len = encode_participant_update(buf, sizeof(buf));
+
+    protocol_arena_stats_t stats;
+    decode_repeatedly(buf, len, &stats);
+    TEST_ASSERT_EQUAL(stats.heap_allocs, stats.heap_frees);
+}
+
+TEST_CASE("protocol participants are decoded from the response buffer", "[basic]")
+{
+    // Other fields of the join response may appear between participants.
+    static uint8_t join[4096];
+    pb_ostream_t join_stream = pb_ostream_from_buffer(join, sizeof(join));
+    livekit_pb_participant_info_t local = LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO;
+    TEST_ASSERT_TRUE(pb_encode_tag(&join_stream, PB_WT_STRING, LIVEKIT_PB_JOIN_RESPONSE_PARTICIPANT_TAG));
+    TEST_ASSERT_TRUE(pb_encode_submessage(&join_stream, LIVEKIT_PB_PARTICIPANT_INFO_FIELDS, &local));
+    for (int i = 0; i < PARTICIPANT_COUNT; i++) {
+        char identity[24];
+        snprintf(identity, sizeof(identity), "identity-%d", i);
+        livekit_pb_participant_info_t participant = LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO;
+        participant.identity = identity;
+        TEST_ASSERT_TRUE(pb_encode_tag(&join_stream, PB_WT_STRING, LIVEKIT_PB_JOIN_RESPONSE_OTHER_PARTICIPANTS_TAG));
+        TEST_ASSERT_TRUE(pb_encode_submessage(&join_stream, LIVEKIT_PB_PARTICIPANT_INFO_FIELDS, &participant));
+        if (i % 10 == 0) {
+            TEST_ASSERT_TRUE(pb_encode_tag(&join_stream, PB_WT_VARINT, LIVEKIT_PB_JOIN_RESPONSE_PING_INTERVAL_TAG));
+            TEST_ASSERT_TRUE(pb_encode_varint(&join_stream, (uint64_t)(i + 1)));
+        }
+    }
+    uint8_t *buf = malloc(sizeof(join) + 8);
+    TEST_ASSERT_NOT_NULL(buf);
+    pb_ostream_t stream = pb_ostream_from_buffer(buf, sizeof(join) + 8);
+    TEST_ASSERT_TRUE(pb_encode_tag(&stream, PB_WT_STRING, LIVEKIT_PB_SIGNAL_RESPONSE_JOIN_TAG));
+    TEST_ASSERT_TRUE(pb_encode_string(&stream, join, join_stream.bytes_written));
+    TEST_ASSERT_TRUE(protocol_signal_response_refers_to_buffer(buf, stream.bytes_written));
+
+    // The participants are not copied, however many there are.
+    protocol_arena_reset_stats();
+    livekit_pb_signal_response_t res = {};
+    TEST_ASSERT_TRUE(protocol_signal_response_decode(buf, stream.bytes_written, true, &res));
+    protocol_arena_stats_t stats;
+    protocol_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.allocs);
+    TEST_ASSERT_EQUAL(PARTICIPANT_COUNT - 9, res.message.join.ping_interval);
+
+    TEST_ASSERT_EQUAL(PARTICIPANT_COUNT, protocol_participants_count(&res.message.join.other_participants));
+    visit_ctx_t visit = {};
+    TEST_ASSERT_TRUE(protocol_participants_visit(&res.message.join.other_participants, visit_participant, &visit));
+    TEST_ASSERT_EQUAL(PARTICIPANT_COUNT, visit.visited);
+    // Frees the buffer along with the response.
+    protocol_signal_response_free(&res);
+}
+
+TEST_CASE("protocol encoder grows and falls back", "[basic]")
+{
+    protocol_encoder_handle_t encoder = protocol_encoder_create();
+    TEST_ASSERT_NOT_NULL(encoder);
+
+    static uint8_t payload_bytes[CONFIG_LK_ENCODE_BUFFER_MAX_SIZE + 1];
+    const size_t sizes[] = { 16, CONFIG_LK_ENCODE_BUFFER_SIZE + 1, sizeof(payload_bytes) };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        protocol_bytes_t payload = { .bytes = payload_bytes, .size = sizes[i] };
+        livekit_pb_data_packet_t packet = LIVEKIT_PB_DATA_PACKET_INIT_ZERO;
+        packet.which_value = LIVEKIT_PB_DATA_PACKET_USER_TAG;
+        packet.value.user.payload.arg = &payload;
+
+        const uint8_t *encoded = NULL;
+        size_t encoded_size = 0;
+        TEST_ASSERT_TRUE(protocol_encoder_encode_data_packet(encoder, &packet, &encoded, &encoded_size));
+
+        livekit_pb_data_packet_t decoded = {};
+        TEST_ASSERT_TRUE(protocol_data_packet_decode(encoded, encoded_size, &decoded));
+        const protocol_bytes_t *decoded_payload = decoded.value.user.payload.arg;
+        TEST_ASSERT_NOT_NULL(decoded_payload);
+        TEST_ASSERT_EQUAL(sizes[i], decoded_payload->size);
+        protocol_data_packet_free(&decoded);
+        protocol_encoder_release(encoder);
+    }
+
+    protocol_encoder_stats_t stats;
+    protocol_encoder_get_stats(encoder, &stats);
+    TEST_ASSERT_EQUAL(3, stats.encodes);
+    TEST_ASSERT_EQUAL(1, stats.grows);
+    TEST_ASSERT_EQUAL(1, stats.oversized);
+    protocol_encoder_destroy(encoder);
+}
+
+#if CONFIG_LK_PROTOCOL_ARENA
+TEST_CASE("protocol arena decode benchmark", "[benchmark]")
+{
+    static uint8_t buf[4096];
+    size_t len = encode_participant_update(buf, sizeof(buf));
+
+    protocol_arena_stats_t heap_stats;
+    protocol_arena_set_enabled(false);
+    int64_t heap_us = decode_repeatedly(buf, len, &heap_stats);
+
+    protocol_arena_stats_t arena_stats;
+    protocol_arena_set_enabled(true);
+    int64_t arena_us = decode_repeatedly(buf, len, &arena_stats);
+
+    printf("[BENCH] Decode %u bytes x%d: heap=%" PRId64 "us/%" PRIu32 " allocs, arena=%" PRId64 "us/%" PRIu32 " allocs\n",
+        (unsigned)len, DECODE_ITERATIONS,
+        heap_us, heap_stats.heap_allocs,
+        arena_us, arena_stats.heap_allocs);
+
+    // nanopb's pointer fields are allocated from the arena.
+    TEST_ASSERT_EQUAL(heap_stats.allocs, arena_stats.allocs);
+    TEST_ASSERT_GREATER_THAN(PARTICIPANT_COUNT * DECODE_ITERATIONS, heap_stats.heap_allocs);
+    TEST_ASSERT_LESS_THAN(heap_stats.heap_allocs, arena_stats.heap_allocs);
+    TEST_ASSERT_EQUAL(arena_stats.heap_allocs, arena_stats.heap_frees);
+}
+
+TEST_CASE("protocol arena shares a chunk per scope", "[basic]")
+{
+    protocol_arena_reset_stats();
+    protocol_arena_begin(256);
+    void *first = protocol_arena_realloc(NULL, 32);
+    void *second = protocol_arena_realloc(NULL, 64);
+    // Grows in place as the most recent allocation.
+    TEST_ASSERT_TRUE(protocol_arena_realloc(second, 96) == second);
+    protocol_arena_end();
+
+    protocol_arena_stats_t stats;
+    protocol_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.allocs);
+    TEST_ASSERT_EQUAL(1, stats.heap_allocs);
+
+    // The chunk is freed with its last allocation.
+    protocol_arena_free(first);
+    protocol_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.heap_frees);
+    protocol_arena_free(second);
+    protocol_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.heap_frees);
+
+    // The first chunk is sized to the hint rather than a fixed minimum.
+    protocol_arena_reset_stats();
+    protocol_arena_begin(32);
+    first = protocol_arena_realloc(NULL, 8);
+    second = protocol_arena_realloc(NULL, 8);
+    protocol_arena_end();
+    protocol_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL(2, stats.heap_allocs);
+    protocol_arena_free(first);
+    protocol_arena_free(second);
+
+    // Outside a scope, allocations come from the heap.
+    void *heap = protocol_arena_realloc(NULL, 32);
+    protocol_arena_free(heap);
+    protocol_arena_get_stats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.heap_allocs);
+    TEST_ASSERT_EQUAL(3, stats.heap_frees);
+}
+#endif
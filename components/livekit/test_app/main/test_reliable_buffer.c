@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include "unity.h"
+
+#include "reliable_buffer.h"
+
+typedef struct {
+    uint32_t next_expected;
+    uint32_t sends_allowed;
+} send_ctx_t;
+
+/// Accepts packets in order until `sends_allowed` is exhausted.
+static bool send_in_order(const uint8_t *data, size_t size, void *ctx)
+{
+    send_ctx_t *send_ctx = (send_ctx_t *)ctx;
+    if (send_ctx->sends_allowed == 0) {
+        return false;
+    }
+    uint32_t seq;
+    TEST_ASSERT_EQUAL(sizeof(seq), size);
+    memcpy(&seq, data, sizeof(seq));
+    TEST_ASSERT_EQUAL(send_ctx->next_expected, seq);
+    send_ctx->next_expected++;
+    send_ctx->sends_allowed--;
+    return true;
+}
+
+TEST_CASE("reliable buffer flushes in order", "[basic]")
+{
+    reliable_buffer_handle_t buffer = reliable_buffer_create(LIVEKIT_DATA_BUFFER_POLICY_DEFAULT);
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    const uint32_t count = CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS;
+    for (uint32_t seq = 0; seq < count; seq++) {
+        TEST_ASSERT_EQUAL(RELIABLE_BUFFER_ERR_NONE,
+            reliable_buffer_push(buffer, (const uint8_t *)&seq, sizeof(seq)));
+    }
+
+    // Interrupted flush keeps the remaining packets for the next attempt.
+    send_ctx_t ctx = { .next_expected = 0, .sends_allowed = count / 2 };
+    TEST_ASSERT_FALSE(reliable_buffer_flush(buffer, send_in_order, &ctx));
+    ctx.sends_allowed = count;
+    TEST_ASSERT_TRUE(reliable_buffer_flush(buffer, send_in_order, &ctx));
+    TEST_ASSERT_EQUAL(count, ctx.next_expected);
+
+    livekit_data_buffer_stats_t stats;
+    reliable_buffer_get_stats(buffer, &stats);
+    TEST_ASSERT_EQUAL(0, stats.buffered);
+    TEST_ASSERT_EQUAL(count, stats.total_buffered);
+    TEST_ASSERT_EQUAL(count, stats.sent);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    reliable_buffer_destroy(buffer);
+}
+
+TEST_CASE("reliable buffer drops oldest on overflow", "[basic]")
+{
+    reliable_buffer_handle_t buffer = reliable_buffer_create(LIVEKIT_DATA_BUFFER_POLICY_DROP_OLDEST);
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    const uint32_t count = CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS + 2;
+    for (uint32_t seq = 0; seq < count; seq++) {
+        TEST_ASSERT_EQUAL(RELIABLE_BUFFER_ERR_NONE,
+            reliable_buffer_push(buffer, (const uint8_t *)&seq, sizeof(seq)));
+    }
+    livekit_data_buffer_stats_t stats;
+    reliable_buffer_get_stats(buffer, &stats);
+    TEST_ASSERT_EQUAL(CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS, stats.buffered);
+    TEST_ASSERT_EQUAL(2, stats.dropped);
+
+    send_ctx_t ctx = { .next_expected = 2, .sends_allowed = count };
+    TEST_ASSERT_TRUE(reliable_buffer_flush(buffer, send_in_order, &ctx));
+    reliable_buffer_destroy(buffer);
+}
+
+TEST_CASE("reliable buffer rejects new packets on overflow", "[basic]")
+{
+    reliable_buffer_handle_t buffer = reliable_buffer_create(LIVEKIT_DATA_BUFFER_POLICY_REJECT);
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    const uint32_t count = CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS + 2;
+    for (uint32_t seq = 0; seq < count; seq++) {
+        reliable_buffer_err_t expected = seq < CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS ?
+            RELIABLE_BUFFER_ERR_NONE : RELIABLE_BUFFER_ERR_FULL;
+        TEST_ASSERT_EQUAL(expected, reliable_buffer_push(buffer, (const uint8_t *)&seq, sizeof(seq)));
+    }
+    livekit_data_buffer_stats_t stats;
+    reliable_buffer_get_stats(buffer, &stats);
+    TEST_ASSERT_EQUAL(CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS, stats.buffered);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    TEST_ASSERT_EQUAL(2, stats.rejected);
+
+    send_ctx_t ctx = { .next_expected = 0, .sends_allowed = count };
+    TEST_ASSERT_TRUE(reliable_buffer_flush(buffer, send_in_order, &ctx));
+    TEST_ASSERT_EQUAL(CONFIG_LK_RELIABLE_BUFFER_MAX_PACKETS, ctx.next_expected);
+    reliable_buffer_destroy(buffer);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unity.h"
+
+#include "sub_policy.h"
+
+static livekit_pb_participant_info_t make_participant(char *identity, livekit_pb_participant_info_kind_t kind)
+{
+    livekit_pb_participant_info_t participant = LIVEKIT_PB_PARTICIPANT_INFO_INIT_ZERO;
+    participant.identity = identity;
+    participant.kind = kind;
+    return participant;
+}
+
+static bool should_subscribe(const livekit_participant_info_t *participant, const livekit_track_info_t *track, void *ctx)
+{
+    return true;
+}
+
+TEST_CASE("subscription policy allows and denies participants", "[basic]")
+{
+    char speaker[] = "speaker", listener[] = "listener";
+    livekit_pb_participant_info_t standard = make_participant(speaker, LIVEKIT_PB_PARTICIPANT_INFO_KIND_STANDARD);
+    livekit_pb_participant_info_t agent = make_participant(listener, LIVEKIT_PB_PARTICIPANT_INFO_KIND_AGENT);
+    livekit_pb_participant_info_t anonymous = make_participant(NULL, LIVEKIT_PB_PARTICIPANT_INFO_KIND_STANDARD);
+
+    livekit_sub_policy_t all = { .type = LIVEKIT_SUB_POLICY_ALL };
+    TEST_ASSERT_EQUAL(SUB_POLICY_ALLOW, sub_policy_evaluate(&all, &standard));
+    TEST_ASSERT_EQUAL(SUB_POLICY_ALLOW, sub_policy_evaluate(&all, &anonymous));
+
+    const char *identities[] = { "speaker" };
+    livekit_sub_policy_t by_identity = {
+        .type = LIVEKIT_SUB_POLICY_IDENTITY,
+        .identities = identities,
+        .identity_count = 1,
+    };
+    TEST_ASSERT_EQUAL(SUB_POLICY_ALLOW, sub_policy_evaluate(&by_identity, &standard));
+    TEST_ASSERT_EQUAL(SUB_POLICY_DENY, sub_policy_evaluate(&by_identity, &agent));
+    TEST_ASSERT_EQUAL(SUB_POLICY_DENY, sub_policy_evaluate(&by_identity, &anonymous));
+
+    livekit_sub_policy_t by_kind = {
+        .type = LIVEKIT_SUB_POLICY_PARTICIPANT_KIND,
+        .participant_kinds = LIVEKIT_PARTICIPANT_KIND_BIT(LIVEKIT_PARTICIPANT_KIND_AGENT),
+    };
+    TEST_ASSERT_EQUAL(SUB_POLICY_DENY, sub_policy_evaluate(&by_kind, &standard));
+    TEST_ASSERT_EQUAL(SUB_POLICY_ALLOW, sub_policy_evaluate(&by_kind, &agent));
+
+    livekit_sub_policy_t by_callback = {
+        .type = LIVEKIT_SUB_POLICY_CALLBACK,
+        .should_subscribe = should_subscribe,
+    };
+    TEST_ASSERT_EQUAL(SUB_POLICY_ASK, sub_policy_evaluate(&by_callback, &standard));
+}
+
+TEST_CASE("subscription policy validates and copies", "[basic]")
+{
+    livekit_sub_policy_t no_callback = { .type = LIVEKIT_SUB_POLICY_CALLBACK };
+    TEST_ASSERT_FALSE(sub_policy_is_valid(&no_callback));
+    livekit_sub_policy_t no_identities = { .type = LIVEKIT_SUB_POLICY_IDENTITY, .identity_count = 1 };
+    TEST_ASSERT_FALSE(sub_policy_is_valid(&no_identities));
+
+    char identity[] = "speaker";
+    const char *identities[] = { identity };
+    livekit_sub_policy_t policy = {
+        .type = LIVEKIT_SUB_POLICY_IDENTITY,
+        .identities = identities,
+        .identity_count = 1,
+    };
+    TEST_ASSERT_TRUE(sub_policy_is_valid(&policy));
+
+    // The copy keeps its own identities.
+    livekit_sub_policy_t copy;
+    TEST_ASSERT_EQUAL(LIVEKIT_ERR_NONE, sub_policy_copy(&copy, &policy));
+    identity[0] = 'S';
+    livekit_pb_participant_info_t participant = make_participant((char[]){ "speaker" }, LIVEKIT_PB_PARTICIPANT_INFO_KIND_STANDARD);
+    TEST_ASSERT_EQUAL(SUB_POLICY_ALLOW, sub_policy_evaluate(&copy, &participant));
+    sub_policy_free(&copy);
+    TEST_ASSERT_NULL(copy.identities);
+}
+
+TEST_CASE("subscription policy limits subscriptions per kind", "[basic]")
+{
+    sub_policy_counts_t counts = {};
+    for (int i = 0; i < SUB_POLICY_MAX_AUDIO_TRACKS; i++) {
+        TEST_ASSERT_TRUE(sub_policy_reserve(&counts, LIVEKIT_PB_TRACK_TYPE_AUDIO));
+    }
+    TEST_ASSERT_FALSE(sub_policy_reserve(&counts, LIVEKIT_PB_TRACK_TYPE_AUDIO));
+    TEST_ASSERT_EQUAL(SUB_POLICY_MAX_AUDIO_TRACKS, counts.audio);
+
+    // Video has its own limit.
+    for (int i = 0; i < SUB_POLICY_MAX_VIDEO_TRACKS; i++) {
+        TEST_ASSERT_TRUE(sub_policy_reserve(&counts, LIVEKIT_PB_TRACK_TYPE_VIDEO));
+    }
+    TEST_ASSERT_FALSE(sub_policy_reserve(&counts, LIVEKIT_PB_TRACK_TYPE_VIDEO));
+
+    // A slot frees up when a track is unsubscribed.
+    counts.audio--;
+    TEST_ASSERT_TRUE(sub_policy_reserve(&counts, LIVEKIT_PB_TRACK_TYPE_AUDIO));
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unity.h"
+
+#include "video_renderer.h"
+
+TEST_CASE("video renderer detects H.264 keyframes", "[basic]")
+{
+    // SPS, PPS and IDR slice as sent at the start of a GOP.
+    static const uint8_t idr_au[] = {
+        0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0xC0, 0x1F,
+        0x00, 0x00, 0x00, 0x01, 0x68, 0xCE, 0x3C, 0x80,
+        0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00,
+    };
+    // Access unit delimiter followed by a non-IDR slice.
+    static const uint8_t p_au[] = {
+        0x00, 0x00, 0x00, 0x01, 0x09, 0xF0,
+        0x00, 0x00, 0x01, 0x41, 0x9A, 0x00, 0x00, 0x01, 0x65,
+    };
+    // IDR slice without parameter sets (3-byte start code).
+    static const uint8_t idr_only[] = { 0x00, 0x00, 0x01, 0x25, 0xB8 };
+    static const uint8_t truncated[] = { 0x00, 0x00, 0x01 };
+
+    TEST_ASSERT_TRUE(video_renderer_is_keyframe(idr_au, sizeof(idr_au)));
+    TEST_ASSERT_TRUE(video_renderer_is_keyframe(idr_only, sizeof(idr_only)));
+    // Slice data after the first slice is not inspected.
+    TEST_ASSERT_FALSE(video_renderer_is_keyframe(p_au, sizeof(p_au)));
+    TEST_ASSERT_FALSE(video_renderer_is_keyframe(truncated, sizeof(truncated)));
+    TEST_ASSERT_FALSE(video_renderer_is_keyframe(NULL, 0));
+}
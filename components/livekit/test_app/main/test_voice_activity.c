@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "unity.h"
+
+#include "voice_activity.h"
+
+// The detector takes frame timestamps as a parameter, so these tests feed it
+// synthetic audio.
+
+#define SAMPLE_RATE 8000
+#define FRAME_MS 20
+#define FRAME_SAMPLES (SAMPLE_RATE * FRAME_MS / 1000)
+
+static const voice_activity_config_t config = {
+    .threshold_db = 9,
+    .hangover_ms = 300,
+};
+
+/// Encodes a 16-bit linear PCM sample as G.711 µ-law.
+static uint8_t linear_to_ulaw(int16_t sample)
+{
+    int value = sample >> 2;
+    uint8_t mask = 0xFF;
+    if (value < 0) {
+        value = -value;
+        mask = 0x7F;
+    }
+    if (value > 8159) value = 8159;
+    value += 0x21;
+    int segment = 0;
+    while (segment < 8 && value > (0x3F << segment)) segment++;
+    if (segment >= 8) return (uint8_t)(0x7F ^ mask);
+    return (uint8_t)(((segment << 4) | ((value >> (segment + 1)) & 0x0F)) ^ mask);
+}
+
+/// Generates a µ-law frame of a tone (or, with `tone_amplitude` 0, noise only).
+static void make_frame(uint8_t *frame, uint32_t index, int16_t tone_amplitude, int16_t noise_amplitude, uint32_t *seed)
+{
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        float t = (float)(index * FRAME_SAMPLES + (uint32_t)i) / SAMPLE_RATE;
+        *seed = *seed * 1103515245u + 12345u;
+        int32_t noise = noise_amplitude == 0 ? 0 :
+            (int32_t)((*seed >> 16) % (uint32_t)(2 * noise_amplitude)) - noise_amplitude;
+        int32_t sample = (int32_t)(tone_amplitude * sinf(2.0f * 3.14159265f * 440.0f * t)) + noise;
+        frame[i] = linear_to_ulaw((int16_t)sample);
+    }
+}
+
+TEST_CASE("voice activity suppresses silence after hangover", "[basic]")
+{
+    voice_activity_handle_t va = voice_activity_create(&config);
+    TEST_ASSERT_NOT_NULL(va);
+    uint8_t frame[FRAME_SAMPLES];
+    uint32_t seed = 1;
+    uint32_t sent_speech = 0, sent_silence = 0;
+
+    // 1 s of quiet room noise, 1 s of speech, then 2 s of room noise.
+    for (uint32_t i = 0; i < 200; i++) {
+        bool is_speech = i >= 50 && i < 100;
+        make_frame(frame, i, is_speech ? 8000 : 0, 100, &seed);
+        bool is_sent = voice_activity_process_g711(va, frame, sizeof(frame), false, 1000 + i * FRAME_MS);
+        if (is_speech) {
+            sent_speech += is_sent;
+        } else {
+            sent_silence += is_sent;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(50, sent_speech);
+    // Only the hangover after speech is sent.
+    TEST_ASSERT_EQUAL_UINT32(config.hangover_ms / FRAME_MS, sent_silence);
+
+    livekit_audio_dtx_stats_t stats;
+    voice_activity_get_stats(va, &stats);
+    TEST_ASSERT_EQUAL_UINT32(200, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(200 - 50 - config.hangover_ms / FRAME_MS, stats.suppressed_frames);
+    TEST_ASSERT_EQUAL_UINT8(stats.suppressed_frames * 100 / stats.frames, stats.suppressed_percent);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.talk_spurts);
+    voice_activity_destroy(va);
+}
+
+TEST_CASE("voice activity adapts to background noise", "[basic]")
+{
+    voice_activity_handle_t va = voice_activity_create(&config);
+    TEST_ASSERT_NOT_NULL(va);
+    uint8_t frame[FRAME_SAMPLES];
+    uint32_t seed = 2;
+    uint32_t sent_late = 0;
+
+    // A fan is switched on after 1 s: its noise is sent at first, but once the
+    // noise floor has caught up it is suppressed again.
+    for (uint32_t i = 0; i < 600; i++) {
+        make_frame(frame, i, 0, i < 50 ? 20 : 1500, &seed);
+        bool is_sent = voice_activity_process_g711(va, frame, sizeof(frame), false, i * FRAME_MS);
+        if (i >= 500) {
+            sent_late += is_sent;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sent_late);
+
+    // Speech over the fan noise is still detected.
+    make_frame(frame, 600, 12000, 1500, &seed);
+    TEST_ASSERT_TRUE(voice_activity_process_g711(va, frame, sizeof(frame), false, 600 * FRAME_MS));
+    voice_activity_destroy(va);
+}
+
+TEST_CASE("voice activity suppresses A-law digital silence", "[basic]")
+{
+    voice_activity_handle_t va = voice_activity_create(&config);
+    TEST_ASSERT_NOT_NULL(va);
+    uint8_t frame[FRAME_SAMPLES];
+    // A-law code for zero.
+    memset(frame, 0xD5, sizeof(frame));
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_FALSE(voice_activity_process_g711(va, frame, sizeof(frame), true, i * FRAME_MS));
+    }
+    voice_activity_destroy(va);
+}
+
+TEST_CASE("voice activity drops Opus DTX packets", "[basic]")
+{
+    voice_activity_handle_t va = voice_activity_create(&config);
+    TEST_ASSERT_NOT_NULL(va);
+    uint8_t frame[80] = { 0x78 };
+    uint32_t sent = 0;
+    // Speech, then DTX with a comfort noise update every 400 ms, then speech.
+    for (uint32_t i = 0; i < 100; i++) {
+        size_t size = (i < 20 || i >= 80) ? sizeof(frame) : (i % 20 == 0) ? 40 : 1;
+        sent += voice_activity_process_opus(va, frame, size, i * FRAME_MS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(20 + 3 + 20, sent);
+
+    livekit_audio_dtx_stats_t stats;
+    voice_activity_get_stats(va, &stats);
+    TEST_ASSERT_EQUAL_UINT32(100 - sent, stats.suppressed_frames);
+    TEST_ASSERT_EQUAL_UINT8(57, stats.suppressed_percent);
+    voice_activity_destroy(va);
+}
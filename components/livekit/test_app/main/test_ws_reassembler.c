@@ -0,0 +1,197 @@
+/*
+ * Copyright 2026 LiveKit, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+
+#include "ws_reassembler.h"
+
+// Chunks are built by hand the way the WebSocket client delivers them, so
+// these tests do not need a connection.
+
+#define MESSAGE_SIZE 5000
+#define MAX_MESSAGE_SIZE 8192
+
+static uint8_t message[MESSAGE_SIZE];
+
+static void fill_message(void)
+{
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)(i * 31 + 7);
+    }
+}
+
+static ws_reassembler_chunk_t make_chunk(uint8_t opcode, bool fin, const uint8_t *frame, size_t frame_len, size_t offset, size_t len)
+{
+    return (ws_reassembler_chunk_t){
+        .opcode = opcode,
+        .fin = fin,
+        .data = frame + offset,
+        .data_len = len,
+        .payload_offset = offset,
+        .payload_len = frame_len,
+    };
+}
+
+/// Delivers `message` as frames of `frame_size` bytes, each split into chunks of
+/// `chunk_size` bytes (as when a frame exceeds the client's buffer).
+static void push_fragmented(ws_reassembler_handle_t r, size_t frame_size, size_t chunk_size, bool with_pings)
+{
+    const uint8_t *out = NULL;
+    size_t out_len = 0;
+    static const uint8_t ping[] = { 1, 2, 3 };
+
+    for (size_t frame_start = 0; frame_start < sizeof(message); frame_start += frame_size) {
+        size_t frame_len = sizeof(message) - frame_start;
+        if (frame_len > frame_size) frame_len = frame_size;
+        bool fin = frame_start + frame_len == sizeof(message);
+        uint8_t opcode = frame_start == 0 ? WS_OPCODE_BINARY : WS_OPCODE_CONTINUATION;
+
+        for (size_t offset = 0; offset < frame_len; offset += chunk_size) {
+            size_t len = frame_len - offset;
+            if (len > chunk_size) len = chunk_size;
+            ws_reassembler_chunk_t chunk = make_chunk(opcode, fin, message + frame_start, frame_len, offset, len);
+            TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+
+            if (fin && offset + len == frame_len) {
+                TEST_ASSERT_NOT_NULL(out);
+                TEST_ASSERT_EQUAL(sizeof(message), out_len);
+                TEST_ASSERT_EQUAL_MEMORY(message, out, sizeof(message));
+            } else {
+                TEST_ASSERT_NULL(out);
+            }
+        }
+        if (with_pings && !fin) {
+            // Control frames may arrive between the frames of a message.
+            ws_reassembler_chunk_t chunk = make_chunk(WS_OPCODE_PING, true, ping, sizeof(ping), 0, sizeof(ping));
+            TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+            TEST_ASSERT_NULL(out);
+        }
+    }
+}
+
+TEST_CASE("ws reassembler returns single chunk messages in place", "[basic]")
+{
+    ws_reassembler_handle_t r = ws_reassembler_create(MAX_MESSAGE_SIZE);
+    TEST_ASSERT_NOT_NULL(r);
+    fill_message();
+
+    const uint8_t *out = NULL;
+    size_t out_len = 0;
+    ws_reassembler_chunk_t chunk = make_chunk(WS_OPCODE_BINARY, true, message, 100, 0, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    TEST_ASSERT_TRUE(out == message);
+    TEST_ASSERT_EQUAL(100, out_len);
+    // Not held by the reassembler, so there is nothing to take.
+    TEST_ASSERT_NULL(ws_reassembler_take(r));
+
+    // Text messages are skipped.
+    chunk = make_chunk(WS_OPCODE_TEXT, true, message, 100, 0, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    TEST_ASSERT_NULL(out);
+
+    ws_reassembler_stats_t stats;
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_get_stats(r, &stats));
+    TEST_ASSERT_EQUAL(1, stats.messages);
+    TEST_ASSERT_EQUAL(0, stats.reassembled);
+    ws_reassembler_destroy(r);
+}
+
+TEST_CASE("ws reassembler reassembles fragmented frames", "[basic]")
+{
+    ws_reassembler_handle_t r = ws_reassembler_create(MAX_MESSAGE_SIZE);
+    TEST_ASSERT_NOT_NULL(r);
+    fill_message();
+
+    // One frame split into chunks by the client's receive buffer
+    push_fragmented(r, MESSAGE_SIZE, 1024, false);
+    // Continuation frames, each delivered in one chunk
+    push_fragmented(r, 700, 700, true);
+    // Continuation frames that are also split into chunks
+    push_fragmented(r, 1500, 512, true);
+    // Byte by byte
+    push_fragmented(r, 333, 1, true);
+
+    // The last message can be kept after the next one starts.
+    uint8_t *taken = ws_reassembler_take(r);
+    TEST_ASSERT_NOT_NULL(taken);
+    TEST_ASSERT_NULL(ws_reassembler_take(r));
+    push_fragmented(r, 1500, 1500, false);
+    TEST_ASSERT_EQUAL_MEMORY(message, taken, MESSAGE_SIZE);
+    free(taken);
+
+    ws_reassembler_stats_t stats;
+    ws_reassembler_get_stats(r, &stats);
+    TEST_ASSERT_EQUAL(5, stats.messages);
+    TEST_ASSERT_EQUAL(5, stats.reassembled);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    TEST_ASSERT_EQUAL(MESSAGE_SIZE, stats.max_message_size);
+    ws_reassembler_destroy(r);
+}
+
+TEST_CASE("ws reassembler drops broken and oversized messages", "[basic]")
+{
+    ws_reassembler_handle_t r = ws_reassembler_create(MAX_MESSAGE_SIZE);
+    TEST_ASSERT_NOT_NULL(r);
+    fill_message();
+    const uint8_t *out = NULL;
+    size_t out_len = 0;
+
+    // Continuation without a message in progress
+    ws_reassembler_chunk_t chunk = make_chunk(WS_OPCODE_CONTINUATION, true, message, 100, 0, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_SEQUENCE, ws_reassembler_push(r, &chunk, &out, &out_len));
+
+    // A chunk goes missing: the rest of the message is skipped.
+    chunk = make_chunk(WS_OPCODE_BINARY, true, message, 300, 0, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    chunk = make_chunk(WS_OPCODE_BINARY, true, message, 300, 200, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_SEQUENCE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    TEST_ASSERT_NULL(out);
+
+    // A message that never completes is dropped when the next one starts.
+    chunk = make_chunk(WS_OPCODE_BINARY, false, message, 100, 0, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    chunk = make_chunk(WS_OPCODE_BINARY, true, message, 50, 0, 50);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    TEST_ASSERT_EQUAL(50, out_len);
+
+    // Oversized message, then the following message still gets through.
+    static uint8_t large[MAX_MESSAGE_SIZE + 1];
+    chunk = make_chunk(WS_OPCODE_BINARY, true, large, sizeof(large), 0, 4096);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_TOO_LARGE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    chunk = make_chunk(WS_OPCODE_BINARY, true, large, sizeof(large), 4096, sizeof(large) - 4096);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    TEST_ASSERT_NULL(out);
+    push_fragmented(r, 1000, 1000, false);
+
+    // A connection closing mid-message
+    chunk = make_chunk(WS_OPCODE_BINARY, false, message, 100, 0, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_NONE, ws_reassembler_push(r, &chunk, &out, &out_len));
+    ws_reassembler_reset(r);
+    chunk = make_chunk(WS_OPCODE_CONTINUATION, true, message, 100, 0, 100);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_SEQUENCE, ws_reassembler_push(r, &chunk, &out, &out_len));
+
+    // Chunk extends past the frame
+    chunk = make_chunk(WS_OPCODE_BINARY, true, message, 100, 50, 51);
+    TEST_ASSERT_EQUAL(WS_REASSEMBLER_ERR_INVALID_ARG, ws_reassembler_push(r, &chunk, &out, &out_len));
+
+    ws_reassembler_stats_t stats;
+    ws_reassembler_get_stats(r, &stats);
+    TEST_ASSERT_EQUAL(3, stats.dropped);
+    TEST_ASSERT_EQUAL(2, stats.messages);
+    ws_reassembler_destroy(r);
+}
@@ -0,0 +1,36 @@
+/* pb_allocator.h: Per-thread allocator for pointer fields.
+ *
+ * The component is built with pb_realloc and pb_free forwarding to the
+ * allocator installed on the calling thread, so that an application can decode
+ * a message into its own memory (e.g. an arena) without nanopb depending on it.
+ * Threads without an allocator installed use realloc and free.
+ */
+
+#ifndef PB_ALLOCATOR_H_INCLUDED
+#define PB_ALLOCATOR_H_INCLUDED
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pb_allocator_s {
+    void *(*realloc)(void *ptr, size_t size);
+    void (*free)(void *ptr);
+} pb_allocator_t;
+
+/* Install the allocator used by pb_decode and pb_release on the calling thread.
+ * A message must be released with the same allocator it was decoded with.
+ * Pass NULL to restore realloc and free. Returns the previous allocator. */
+const pb_allocator_t *pb_allocator_set(const pb_allocator_t *allocator);
+
+/* Allocation functions pb_realloc and pb_free are defined to. */
+void *pb_allocator_realloc(void *ptr, size_t size);
+void pb_allocator_free(void *ptr);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
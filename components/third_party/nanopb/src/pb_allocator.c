@@ -0,0 +1,29 @@
+/* pb_allocator.c: Per-thread allocator for pointer fields.
+ */
+
+#include <stdlib.h>
+#include "pb_allocator.h"
+
+static __thread const pb_allocator_t *current_allocator;
+
+const pb_allocator_t *pb_allocator_set(const pb_allocator_t *allocator)
+{
+    const pb_allocator_t *previous = current_allocator;
+    current_allocator = allocator;
+    return previous;
+}
+
+void *pb_allocator_realloc(void *ptr, size_t size)
+{
+    if (current_allocator != NULL)
+        return current_allocator->realloc(ptr, size);
+    return realloc(ptr, size);
+}
+
+void pb_allocator_free(void *ptr)
+{
+    if (current_allocator != NULL)
+        current_allocator->free(ptr);
+    else
+        free(ptr);
+}
@@ -0,0 +1,22 @@
+/* pb_syshdr.h: System header used when building the component (PB_SYSTEM_HEADER).
+ *
+ * Includes the standard headers pb.h would and routes pb_realloc and pb_free
+ * through pb_allocator.h.
+ */
+
+#ifndef PB_SYSHDR_H_INCLUDED
+#define PB_SYSHDR_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include "pb_allocator.h"
+
+#define pb_realloc(ptr, size) pb_allocator_realloc(ptr, size)
+#define pb_free(ptr) pb_allocator_free(ptr)
+
+#endif